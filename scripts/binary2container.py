@@ -0,0 +1,111 @@
+#!/usr/bin/python3
+
+from __future__ import print_function
+
+import getopt
+import struct
+import sys
+import zlib
+
+def print_usage():
+    print ('')
+    print ('Usage:')
+    print ('')
+    print ('  binary2container.py [Options] <inputfile>')
+    print ('')
+    print ('  Conversion of a binary image file into a block compressed image container.')
+    print ('')
+    print ('Options:')
+    print ('')
+    print ('  --block-size, -b <int>    Number of images per block (default = 64).')
+    print ('  --codec, -c <string>      Compression of the blocks (zlib = default, none).')
+    print ('  --help, -h                Print this lines.')
+    print ('  --level, -l <int>         Compression level of zlib (default = 1).')
+    print ('  --ofile, -o <string>      Filename of the image container (default = result.pinkblck).')
+    print ('')
+
+if __name__ == "__main__":
+
+    try:
+        opts, args = getopt.getopt(sys.argv[1:],"hb:c:l:o:",["help", "block-size=", "codec=", "level=", "ofile="])
+    except getopt.GetoptError:
+        print_usage()
+        sys.exit(2)
+
+    imagesPerBlock = 64
+    codec = 'zlib'
+    level = 1
+    outputfile = 'result.pinkblck'
+
+    for opt, arg in opts:
+        if opt in ("-h", "--help"):
+            print_usage()
+            sys.exit()
+        elif opt in ("-b", "--block-size"):
+            imagesPerBlock = int(arg)
+        elif opt in ("-c", "--codec"):
+            if arg not in ['zlib', 'none']:
+                print ('Unkown codec ', arg)
+                sys.exit(1)
+            codec = arg
+        elif opt in ("-l", "--level"):
+            level = int(arg)
+        elif opt in ("-o", "--ofile"):
+            outputfile = arg
+
+    if len(args) != 1:
+        print_usage()
+        print ('ERROR: Input file is missing.')
+        sys.exit(1)
+
+    file = open(args[0], 'rb')
+
+    last_position = file.tell()
+    for line in file:
+        if line[:1] != b'#':
+            break
+        last_position = file.tell()
+
+    file.seek(last_position, 0)
+    numberOfImages, = struct.unpack('i', file.read(4))
+
+    # Versioned header: -1, version, pixel type, scale, offset
+    pixelType, scale, offset = 0, 1.0, 0.0
+    if numberOfImages == -1:
+        version, pixelType, scale, offset = struct.unpack('iiff', file.read(4 * 4))
+        numberOfImages, = struct.unpack('i', file.read(4))
+    numberOfChannels, height, width = struct.unpack('i' * 3, file.read(3 * 4))
+    imageSize = numberOfChannels * height * width * [4, 2, 2, 1][pixelType]
+
+    print ('Number of images = ', numberOfImages)
+    print ('Number of channels = ', numberOfChannels)
+    print ('Height = ', height)
+    print ('Width = ', width)
+    print ('Codec = ', codec)
+
+    numberOfBlocks = (numberOfImages + imagesPerBlock - 1) // imagesPerBlock
+
+    of = open(outputfile, 'wb')
+    of.write(b'PINKBLCK')
+    of.write(struct.pack('iiiiiffiiii', 1, 1 if codec == 'zlib' else 0, imagesPerBlock, numberOfBlocks,
+        pixelType, scale, offset, numberOfImages, numberOfChannels, height, width))
+    indexOffsetPosition = of.tell()
+    of.write(struct.pack('q', 0))
+
+    index = []
+    for block in range(numberOfBlocks):
+        data = file.read(min(imagesPerBlock, numberOfImages - block * imagesPerBlock) * imageSize)
+        if codec == 'zlib':
+            data = zlib.compress(data, level)
+        index.append((of.tell(), len(data)))
+        of.write(data)
+
+    indexOffset = of.tell()
+    for entry in index:
+        of.write(struct.pack('qq', *entry))
+    of.seek(indexOffsetPosition, 0)
+    of.write(struct.pack('q', indexOffset))
+    of.close()
+
+    print ('All done.')
+    sys.exit()
@@ -17,14 +17,16 @@ def print_usage():
     print ''
     print '  --help, -h                Print this lines.'
     print '  --ofile, -o <string>      Filename for the converted images (default = result.bin).'
+    print '  --type, -t <string>       Pixel type of the converted images (float32 = default, uint8).'
     print ''
     
 if __name__ == "__main__":
 
     outputfile = 'result.bin'
+    pixelType = 'float32'
 
     try:
-        opts, args = getopt.getopt(sys.argv[1:],"ho:",["help", "ofile="])
+        opts, args = getopt.getopt(sys.argv[1:],"ho:t:",["help", "ofile=", "type="])
     except getopt.GetoptError:
         print_usage()
         sys.exit(1)
@@ -35,6 +37,11 @@ if __name__ == "__main__":
             sys.exit()
         elif opt in ("-o", "--ofile"):
             outputfile = arg
+        elif opt in ("-t", "--type"):
+            if arg not in ['float32', 'uint8']:
+                print 'Unkown pixel type ', arg
+                sys.exit(1)
+            pixelType = arg
 
     if len(args) == 0:
         print_usage()
@@ -70,6 +77,11 @@ if __name__ == "__main__":
     dim = min(min_height,min_width)
     print 'dim = ', dim
 
+    # Versioned header with pixel type 3 (uint8), scale 1 and offset 0
+    if pixelType == 'uint8':
+        of.write(struct.pack('iiiff', -1, 2, 3, 1.0, 0.0))
+    dtype = 'u1' if pixelType == 'uint8' else 'f'
+
     of.write(struct.pack('i', len(files)))
     of.write(struct.pack('i', 3))
     of.write(struct.pack('i', dim))
@@ -83,13 +95,13 @@ if __name__ == "__main__":
         print image.shape
 
         if (image.shape[0] != dim or image.shape[1] != dim):
-            image[(image.shape[0]-dim)/2:(image.shape[0]+dim)/2, (image.shape[1]-dim)/2:(image.shape[1]+dim)/2, 0].astype('f').tofile(of)
-            image[(image.shape[0]-dim)/2:(image.shape[0]+dim)/2, (image.shape[1]-dim)/2:(image.shape[1]+dim)/2, 1].astype('f').tofile(of)
-            image[(image.shape[0]-dim)/2:(image.shape[0]+dim)/2, (image.shape[1]-dim)/2:(image.shape[1]+dim)/2, 2].astype('f').tofile(of)
+            image[(image.shape[0]-dim)/2:(image.shape[0]+dim)/2, (image.shape[1]-dim)/2:(image.shape[1]+dim)/2, 0].astype(dtype).tofile(of)
+            image[(image.shape[0]-dim)/2:(image.shape[0]+dim)/2, (image.shape[1]-dim)/2:(image.shape[1]+dim)/2, 1].astype(dtype).tofile(of)
+            image[(image.shape[0]-dim)/2:(image.shape[0]+dim)/2, (image.shape[1]-dim)/2:(image.shape[1]+dim)/2, 2].astype(dtype).tofile(of)
         else:
-            image[:, :, 0].astype('f').tofile(of)
-            image[:, :, 1].astype('f').tofile(of)
-            image[:, :, 2].astype('f').tofile(of)
+            image[:, :, 0].astype(dtype).tofile(of)
+            image[:, :, 1].astype(dtype).tofile(of)
+            image[:, :, 2].astype(dtype).tofile(of)
 
     of.close()
 
@@ -18,15 +18,17 @@ def print_usage():
     print '  --channel, -c <int>       Number of channel to visualize (default = 0).'
     print '  --help, -h                Print this lines.'
     print '  --ofile, -o <string>      Filename for the converted images (default = result.bin).'
+    print '  --type, -t <string>       Pixel type of the converted images (float32 = default, uint8).'
     print ''
     
 if __name__ == "__main__":
 
     outputfile = 'result.bin'
+    pixelType = 'float32'
     channel = 0
 
     try:
-        opts, args = getopt.getopt(sys.argv[1:],"ho:c:",["help", "ofile=", "channel="])
+        opts, args = getopt.getopt(sys.argv[1:],"ho:c:t:",["help", "ofile=", "channel=", "type="])
     except getopt.GetoptError:
         print_usage()
         sys.exit(1)
@@ -37,6 +39,11 @@ if __name__ == "__main__":
             sys.exit()
         elif opt in ("-o", "--ofile"):
             outputfile = arg
+        elif opt in ("-t", "--type"):
+            if arg not in ['float32', 'uint8']:
+                print 'Unkown pixel type ', arg
+                sys.exit(1)
+            pixelType = arg
         elif opt in ("-c", "--channel"):
             channel = arg
 
@@ -74,6 +81,11 @@ if __name__ == "__main__":
     dim = min(min_height,min_width)
     print 'dim = ', dim
 
+    # Versioned header with pixel type 3 (uint8), scale 1 and offset 0
+    if pixelType == 'uint8':
+        of.write(struct.pack('iiiff', -1, 2, 3, 1.0, 0.0))
+    dtype = 'u1' if pixelType == 'uint8' else 'f'
+
     of.write(struct.pack('i', len(files)))
     of.write(struct.pack('i', 1))
     of.write(struct.pack('i', dim))
@@ -87,9 +99,9 @@ if __name__ == "__main__":
         print image.shape
 
         if (image.shape[0] != dim or image.shape[1] != dim):
-            image[(image.shape[0]-dim)/2:(image.shape[0]+dim)/2, (image.shape[1]-dim)/2:(image.shape[1]+dim)/2, channel].astype('f').tofile(of)
+            image[(image.shape[0]-dim)/2:(image.shape[0]+dim)/2, (image.shape[1]-dim)/2:(image.shape[1]+dim)/2, channel].astype(dtype).tofile(of)
         else:
-            image[:, :, channel].astype('f').tofile(of)
+            image[:, :, channel].astype(dtype).tofile(of)
 
     of.close()
 
@@ -6,6 +6,15 @@ import struct
 import sys
 from matplotlib import pyplot
 
+# Pixel types of the versioned header and the corresponding numpy types
+pixelTypes = {'float32': (0, 'f4'), 'float16': (1, 'f2'), 'uint16': (2, 'u2'), 'uint8': (3, 'u1')}
+
+def normalize(image):
+    image = 1.0 * image / numpy.max(image)
+    indices = numpy.where(image < numpy.std(image)*3.0)
+    image[indices] = 0
+    return image
+
 def print_usage():
     print ''
     print 'Usage:'
@@ -18,6 +27,8 @@ def print_usage():
     print '  --help, -h                Print this lines.'
     print '  --norm, -n                Normalize image data.'
     print '  --ofile, -o <string>      Filename for the converted images (default = result.bin).'
+    print '  --type, -t <string>       Pixel type of the converted images (float32 = default, float16, uint16, uint8).'
+    print '                            Integer pixels are scaled to the range of all images.'
     print ''
     
 if __name__ == "__main__":
@@ -25,9 +36,10 @@ if __name__ == "__main__":
     norm = False
     outputfile = 'result.bin'
     BrokenImageBehavior = 'Skip'
+    pixelType = 'float32'
 
     try:
-        opts, args = getopt.getopt(sys.argv[1:],"ho:nb:",["help", "ofile=", "norm", "broken="])
+        opts, args = getopt.getopt(sys.argv[1:],"ho:nb:t:",["help", "ofile=", "norm", "broken=", "type="])
     except getopt.GetoptError:
         print_usage()
         sys.exit(1)
@@ -45,6 +57,11 @@ if __name__ == "__main__":
                 print 'Unkown option for broken ', arg
                 sys.exit(1)
             BrokenImageBehavior = arg
+        elif opt in ("-t", "--type"):
+            if arg not in pixelTypes:
+                print 'Unkown pixel type ', arg
+                sys.exit(1)
+            pixelType = arg
 
     if len(args) == 0:
         print_usage()
@@ -60,6 +77,8 @@ if __name__ == "__main__":
     min_height = sys.maxint
     max_width = 0
     min_width = sys.maxint
+    min_value = float('inf')
+    max_value = -float('inf')
 
     for file in files:
         data = numpy.load(file)
@@ -71,6 +90,12 @@ if __name__ == "__main__":
                 nbBrokenImages += 1
                 if BrokenImageBehavior == 'Skip':
                     continue
+                image = numpy.nan_to_num(image)
+
+            if norm:
+                image = normalize(image)
+            min_value = min(min_value, numpy.min(image))
+            max_value = max(max_value, numpy.max(image))
 
             if (data[i].shape[0] > max_height):
                 max_height = data[i].shape[0]
@@ -94,6 +119,19 @@ if __name__ == "__main__":
     dim = min(min_height,min_width)
     print 'dim = ', dim
 
+    # Stored pixels are (value - offset) / scale
+    scale = 1.0
+    offset = 0.0
+    if pixelType in ['uint16', 'uint8'] and numberOfImages > 0:
+        offset = min_value
+        if max_value > min_value:
+            scale = (max_value - min_value) / numpy.iinfo(pixelTypes[pixelType][1]).max
+    print 'Pixel type = ', pixelType
+    print 'scale = ', scale
+    print 'offset = ', offset
+
+    if pixelType != 'float32':
+        of.write(struct.pack('iiiff', -1, 2, pixelTypes[pixelType][0], scale, offset))
     of.write(struct.pack('i', numberOfImages))
     of.write(struct.pack('i', numberOfChannels))
     of.write(struct.pack('i', dim))
@@ -116,14 +154,14 @@ if __name__ == "__main__":
                     image = numpy.nan_to_num(image)
 
             if norm:
-                image = 1.0 * image / numpy.max(image)
-                indices = numpy.where(image < numpy.std(image)*3.0)
-                image[indices] = 0
+                image = normalize(image)
 
             if (image.shape[0] != dim or image.shape[1] != dim):
-                image[(image.shape[0]-dim)/2:(image.shape[0]+dim)/2, (image.shape[1]-dim)/2:(image.shape[1]+dim)/2].astype('f').tofile(of)
-            else:
-                image.astype('f').tofile(of)
+                image = image[(image.shape[0]-dim)/2:(image.shape[0]+dim)/2, (image.shape[1]-dim)/2:(image.shape[1]+dim)/2]
+
+            if pixelType in ['uint16', 'uint8']:
+                image = numpy.clip(numpy.rint((image - offset) / scale), 0, numpy.iinfo(pixelTypes[pixelType][1]).max)
+            image.astype(pixelTypes[pixelType][1]).tofile(of)
 
     of.close()
 
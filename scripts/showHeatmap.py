@@ -42,41 +42,24 @@ class HeatmapVisualizer():
         inputStream = open(self.__fileName, 'rb')
         somTools.ignoreHeaderComments(inputStream) # find end of header
 
-        self.__numberOfImages = struct.unpack("i", inputStream.read(4))[0]
-        self.__somWidth = struct.unpack("i", inputStream.read(4))[0]
-        self.__somHeight = struct.unpack("i", inputStream.read(4))[0]
-        self.__somDepth = struct.unpack("i", inputStream.read(4))[0]
+        self.__numberOfImages, self.__somWidth, self.__somHeight, self.__somDepth, resultType, encoding, codec = \
+            somTools.readResultHeader(inputStream)
+        if resultType != 0:
+            inputStream.close()
+            raise ValueError("heatmaps need the distances of all neurons, please map without --result-top-k")
 
         print ("images: " + str(self.__numberOfImages))
         print ("width: " + str(self.__somWidth))
         print ("height: " + str(self.__somHeight))
         print ("depth: " + str(self.__somDepth))
 
-        start = inputStream.tell()      
-        if os.path.getsize(self.__fileName) < self.__numberOfImages * self.__somWidth * self.__somHeight * self.__somDepth * 4 + start:
+        #Unpacks data, the number of neurons of hexagonal maps differs from width * height * depth
+        self.__maps = somTools.readDistances(inputStream, self.__numberOfImages, encoding, codec)
+        inputStream.close()
+        if self.__maps.shape[1] < self.__somWidth * self.__somHeight * self.__somDepth:
             self.__shape = "hex"
         else:
             self.__shape = "box"
-
-        #Unpacks data
-        hexSize=int(1.0 + 6.0 * (( (self.__somWidth-1)/2.0 + 1.0) * (self.__somHeight-1)/ 4.0))
-        try:
-            while True:
-                if self.__shape == "box":
-                    data = numpy.ones(self.__somWidth * self.__somHeight * self.__somDepth)
-                    for i in range(self.__somWidth * self.__somHeight * self.__somDepth):
-                        data[i] = struct.unpack_from("f", inputStream.read(4))[0]
-                    self.__maps.append(data)
-                else:
-                    
-                    data = numpy.ones(hexSize)
-                    for i in range(hexSize):
-                        data[i] = struct.unpack_from("f", inputStream.read(4))[0]
-                    self.__maps.append(data)
-
-        except:
-            inputStream.close()
-        self.__maps = numpy.array(self.__maps)
         print (str(len(self.__maps)) + " maps loaded")
 
     #Checks if hexagonal or quadratic map is used
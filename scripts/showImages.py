@@ -85,7 +85,17 @@ if __name__ == "__main__":
         last_position = file.tell()
      
     file.seek(last_position, 0)
-    numberOfImages, numberOfChannels, width, height = struct.unpack('i' * 4, file.read(4 * 4))
+    numberOfImages, = struct.unpack('i', file.read(4))
+
+    # Versioned header: -1, version, pixel type, scale, offset
+    pixelType, scale, offset = 0, 1.0, 0.0
+    if numberOfImages == -1:
+        version, pixelType, scale, offset = struct.unpack('iiff', file.read(4 * 4))
+        numberOfImages, = struct.unpack('i', file.read(4))
+    dtype = ['<f4', '<f2', '<u2', '<u1'][pixelType]
+    pixelSize = numpy.dtype(dtype).itemsize
+
+    numberOfChannels, width, height = struct.unpack('i' * 3, file.read(3 * 4))
 
     print ('Number of images = ', numberOfImages)
     print ('Number of channels = ', numberOfChannels)
@@ -101,8 +111,8 @@ if __name__ == "__main__":
         sys.exit(1)
 
     size = width * height
-    file.seek((imageNumber*numberOfChannels + channelNumber) * size*4, 1)
-    array = numpy.array(struct.unpack('f' * size, file.read(size*4)))
+    file.seek((imageNumber*numberOfChannels + channelNumber) * size*pixelSize, 1)
+    array = scale * numpy.frombuffer(file.read(size*pixelSize), dtype).astype('float') + offset
     data = numpy.ndarray([width,height], 'float', array)
 
     fig = pyplot.figure()
@@ -38,7 +38,7 @@ class MAPVisualizer():
     def readMap(self):
         #Unpacks the map parameters
         inputStream = open(self.__fileName, 'rb')
-        somTools.ignoreHeaderComments(inputStream)
+        storageType = somTools.getStorageType(somTools.ignoreHeaderComments(inputStream))
 
         self.__numberOfChannels = struct.unpack("i", inputStream.read(4))[0]
         self.__somWidth = struct.unpack("i", inputStream.read(4))[0]
@@ -53,14 +53,12 @@ class MAPVisualizer():
         print ("depth: " + str(self.__somDepth))
         print ("neurons: " + str(self.__neuronWidth) +"x" + str(self.__neuronHeight))
         #Unpacks data
-        try:
-            while True:
-                data = numpy.ones(self.__neuronWidth * self.__neuronHeight * self.__numberOfChannels)
-                for i in range(self.__neuronWidth * self.__neuronHeight * self.__numberOfChannels):
-                    data[i] = struct.unpack_from("f", inputStream.read(4))[0]
-                self.__neurons.append(data)
-        except:
-            inputStream.close()
+        neuronSize = self.__neuronWidth * self.__neuronHeight * self.__numberOfChannels
+        while True:
+            data = somTools.readData(inputStream, storageType, neuronSize)
+            if len(data) < neuronSize:
+                break
+            self.__neurons.append(data)
         self.__neurons = numpy.array(self.__neurons)
 
         print (str(len(self.__neurons)) + " neurons loaded")
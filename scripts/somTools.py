@@ -1,14 +1,111 @@
 import numpy
 import math
+import struct
+import zlib
 
 def ignoreHeaderComments(inputStream):
-    # omit header information with hash as quote character
+    # omit header information with hash as quote character, the header lines are returned
+    header = []
     character = inputStream.read(1) 
     inputStream.seek(-1,1)
     while (character == b'#'):
-        inputStream.readline() # ignore this line
+        header.append(inputStream.readline().decode().rstrip('\n'))
         character = inputStream.read(1)
         inputStream.seek(-1,1)
+    return header
+
+def getStorageType(header):
+    # numpy type of the data, compact SOM files are marked by a storage header line
+    if '# storage: float16' in header:
+        return numpy.float16
+    if '# storage: bfloat16' in header:
+        return 'bfloat16'
+    return numpy.float32
+
+def readData(inputStream, storageType, count):
+    # read count values and convert into float32
+    if storageType == 'bfloat16':
+        data = numpy.fromfile(inputStream, dtype=numpy.uint16, count=count).astype(numpy.uint32) << 16
+        return data.view(numpy.float32)
+    return numpy.fromfile(inputStream, dtype=storageType, count=count).astype(numpy.float32)
+
+def readResultHeader(inputStream):
+    # plain header of four integers or versioned header starting with -1
+    # returns numberOfImages, somWidth, somHeight, somDepth, resultType, encoding, codec
+    numberOfImages = struct.unpack("i", inputStream.read(4))[0]
+    resultType, encoding, codec = 0, 0, 0
+    if numberOfImages == -1:
+        version, resultType, numberOfBestMatches, encoding, codec = struct.unpack("5i", inputStream.read(20))
+        if version != 2:
+            raise ValueError("unsupported result file version %d" % version)
+        numberOfImages = struct.unpack("i", inputStream.read(4))[0]
+    somWidth, somHeight, somDepth = struct.unpack("3i", inputStream.read(12))
+    return numberOfImages, somWidth, somHeight, somDepth, resultType, encoding, codec
+
+def readDistances(inputStream, numberOfImages, encoding, codec):
+    # distances of all images as float32 array, one row per image
+    # encoding: 0 = float32, 1 = float16, 2 = uint16 with float offset and scale per row
+    # codec: 0 = none, 1 = zlib blocks with int64 number of images and int64 compressed size
+    data = inputStream.read()
+    if codec == 1:
+        blocks = []
+        position = 0
+        while position + 16 <= len(data):
+            rows, size = struct.unpack_from("qq", data, position)
+            blocks.append(zlib.decompress(data[position + 16 : position + 16 + size]))
+            position += 16 + size
+        data = b"".join(blocks)
+    rowSize = len(data) // numberOfImages
+    rows = numpy.frombuffer(data, dtype=numpy.uint8, count=numberOfImages * rowSize).reshape(numberOfImages, rowSize)
+    if encoding == 0:
+        return rows.copy().view(numpy.float32)
+    if encoding == 1:
+        return rows.copy().view(numpy.float16).astype(numpy.float32)
+    if encoding == 2:
+        offset = rows[:, 0:4].copy().view(numpy.float32)
+        scale = rows[:, 4:8].copy().view(numpy.float32)
+        levels = rows[:, 8:].copy().view(numpy.uint16)
+        distances = (offset + levels * scale).astype(numpy.float32)
+        distances[levels == 65535] = numpy.finfo(numpy.float32).max
+        return distances
+    raise ValueError("unknown result encoding %d" % encoding)
+
+def readNeuronStatistics(fileName):
+    # statistics file of Pink --neuron-stats, returns the header values and one record per neuron
+    # with count, sum and sumOfSquares of the distances and the closest examples (image, distance)
+    with open(fileName, 'rb') as inputStream:
+        if inputStream.read(8) != b'PINKSTAT':
+            raise ValueError(fileName + " is not a neuron statistics file")
+        version, = struct.unpack("i", inputStream.read(4))
+        if version == 1:
+            numberOfImages, = struct.unpack("i", inputStream.read(4))
+        elif version == 2:
+            numberOfImages, = struct.unpack("q", inputStream.read(8))
+        else:
+            raise ValueError("unsupported neuron statistics version %d" % version)
+        somWidth, somHeight, somDepth, somSize, numberOfExamples = struct.unpack("5i", inputStream.read(20))
+        dtype = numpy.dtype([('count', '<i8'), ('sum', '<f8'), ('sumOfSquares', '<f8'),
+                             ('examples', [('image', '<i4'), ('distance', '<f4')], (numberOfExamples,))])
+        neurons = numpy.fromfile(inputStream, dtype=dtype, count=somSize)
+    return numberOfImages, somWidth, somHeight, somDepth, neurons
+
+def readPrototypes(fileName):
+    # prototypes file of Pink --prototypes, returns the header values and an array of shape
+    # (somSize, numberOfPrototypes) with neuron, image, distance, flip and angle sorted by distance
+    with open(fileName, 'rb') as inputStream:
+        if inputStream.read(8) != b'PINKPROT':
+            raise ValueError(fileName + " is not a prototypes file")
+        version, = struct.unpack("i", inputStream.read(4))
+        if version == 1:
+            numberOfImages, = struct.unpack("i", inputStream.read(4))
+        elif version == 2:
+            numberOfImages, = struct.unpack("q", inputStream.read(8))
+        else:
+            raise ValueError("unsupported prototypes version %d" % version)
+        somWidth, somHeight, somDepth, somSize, numberOfPrototypes = struct.unpack("5i", inputStream.read(20))
+        dtype = numpy.dtype([('neuron', '<i4'), ('image', '<i4'), ('distance', '<f4'), ('flip', 'i1'), ('angle', '<f4')])
+        prototypes = numpy.fromfile(inputStream, dtype=dtype, count=somSize * numberOfPrototypes)
+    return numberOfImages, somWidth, somHeight, somDepth, prototypes.reshape(somSize, numberOfPrototypes)
 
 def calculateMap(somWidth, somHeight, neurons, neuronWidth, neuronHeight, shareIntensity = False, border = 0, shape="box"):
     #For quadratic map, it reads through the data and creates each neuron as a 1D array and then resizes it to the neuronSize
@@ -0,0 +1,203 @@
+/**
+ * @file   Benchmark/ImageProcessingBenchmark.cpp
+ * @brief  Throughput of the image primitives used to generate the rotated images.
+ * @date   Oct 19, 2026
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ImageProcessingLib/FixedPointRotation.h"
+#include "ImageProcessingLib/ImageProcessing.h"
+#include "UtilitiesLib/Error.h"
+
+using namespace pink;
+
+namespace {
+
+typedef std::chrono::high_resolution_clock myclock;
+
+//! Element-wise reference implementations, one channel at a time.
+void reference_rotate_90degrees(int height, int width, float const *source, float *dest)
+{
+    for (int x = 0; x < width; ++x) {
+        for (int y = 0; y < height; ++y) {
+            dest[(height-y-1)*width + x] = source[x*height + y];
+        }
+    }
+}
+
+void reference_flip(int height, int width, float const *source, float *dest)
+{
+    for (int i = 0; i < height; ++i) {
+        for (int j = 0; j < width; ++j) {
+            dest[(height-1-i)*width + j] = source[i*width + j];
+        }
+    }
+}
+
+void reference_crop(int height, int width, int height_new, int width_new, float const *source, float *dest)
+{
+    int width_margin = (width - width_new) / 2;
+    int height_margin = (height - height_new) / 2;
+
+    for (int i = 0; i < height_new; ++i) {
+        for (int j = 0; j < width_new; ++j) {
+            dest[i*width_new+j] = source[(i+height_margin)*width + (j+width_margin)];
+        }
+    }
+}
+
+//! Number of timed batches, the fastest one is reported to suppress noise.
+const int numberOfBatches = 10;
+
+//! Print throughput in GB/s counting each destination pixel as one read and one write.
+void measure(std::string const& name, int numberOfPixels, int repetitions, std::function<void()> const& kernel)
+{
+    kernel();
+    double seconds = 0.0;
+    for (int b = 0; b < numberOfBatches; ++b) {
+        auto&& startTime = myclock::now();
+        for (int r = 0; r < repetitions; ++r) kernel();
+        double batchSeconds = std::chrono::duration<double>(myclock::now() - startTime).count();
+        if (b == 0 or batchSeconds < seconds) seconds = batchSeconds;
+    }
+
+    double bytes = 2.0 * sizeof(float) * numberOfPixels * repetitions;
+    std::cout << "  " << std::left << std::setw(28) << name << std::right
+              << std::setw(10) << std::fixed << std::setprecision(3) << seconds / repetitions * 1e6 << " us"
+              << std::setw(10) << std::setprecision(2) << bytes / seconds * 1e-9 << " GB/s" << std::endl;
+}
+
+//! Print RMS and maximal deviation of rotateAndCrop from the exactly rotated smooth function.
+template <typename Function>
+void printRotationError(std::string const& name, std::vector<float> const& dest, int image_dim, int neuron_dim,
+    float alpha, Function const& function)
+{
+    const int margin = (image_dim - neuron_dim) / 2;
+    const float center = (image_dim - 1) * 0.5;
+    double sum = 0.0, maxError = 0.0;
+    for (int x2 = 0; x2 < neuron_dim; ++x2) {
+        for (int y2 = 0; y2 < neuron_dim; ++y2) {
+            float tx = x2 + margin - center;
+            float ty = y2 + margin - center;
+            double error = dest[x2*neuron_dim + y2]
+                - function(tx * cos(alpha) + ty * sin(alpha), ty * cos(alpha) - tx * sin(alpha));
+            sum += error * error;
+            maxError = std::max(maxError, std::abs(error));
+        }
+    }
+    std::cout << "  " << std::left << std::setw(28) << name << std::right << std::scientific << std::setprecision(3)
+              << "   rms = " << std::sqrt(sum / (neuron_dim * neuron_dim)) << ", max = " << maxError
+              << std::fixed << std::endl;
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv)
+{
+    if (argc > 4) fatalError("Usage: ImageProcessingBenchmark [neuron_dim] [channels] [repetitions per batch]");
+
+    const int neuron_dim = argc > 1 ? atoi(argv[1]) : 128;
+    const int channels = argc > 2 ? atoi(argv[2]) : 3;
+    const int repetitions = argc > 3 ? atoi(argv[3]) : 100;
+    const int image_dim = neuron_dim + neuron_dim / 2;
+
+    if (neuron_dim <= 0 or channels <= 0 or repetitions <= 0) fatalError("Arguments must be positive.");
+
+    const int neuron_size = neuron_dim * neuron_dim;
+    const int image_size = image_dim * image_dim;
+
+    std::vector<float> image(channels * image_size), source(channels * neuron_size), dest(channels * neuron_size);
+    for (size_t i = 0; i < image.size(); ++i) image[i] = i % 251;
+    for (size_t i = 0; i < source.size(); ++i) source[i] = i % 241;
+
+    std::cout << "neuron_dim = " << neuron_dim << ", image_dim = " << image_dim
+              << ", channels = " << channels << ", repetitions = " << repetitions << std::endl;
+
+    const int pixels = channels * neuron_size;
+
+    measure("rotate_90degrees (reference)", pixels, repetitions, [&]{
+        for (int c = 0; c < channels; ++c)
+            reference_rotate_90degrees(neuron_dim, neuron_dim, &source[c*neuron_size], &dest[c*neuron_size]);
+    });
+    measure("rotate_90degrees", pixels, repetitions, [&]{
+        rotate_90degrees(neuron_dim, neuron_dim, &source[0], &dest[0], channels);
+    });
+    measure("flip (reference)", pixels, repetitions, [&]{
+        for (int c = 0; c < channels; ++c)
+            reference_flip(neuron_dim, neuron_dim, &source[c*neuron_size], &dest[c*neuron_size]);
+    });
+    measure("flip", pixels, repetitions, [&]{
+        flip(neuron_dim, neuron_dim, &source[0], &dest[0], channels);
+    });
+    measure("crop (reference)", pixels, repetitions, [&]{
+        for (int c = 0; c < channels; ++c)
+            reference_crop(image_dim, image_dim, neuron_dim, neuron_dim, &image[c*image_size], &dest[c*neuron_size]);
+    });
+    measure("crop", pixels, repetitions, [&]{
+        crop(image_dim, image_dim, neuron_dim, neuron_dim, &image[0], &dest[0], channels);
+    });
+
+    // Single channel rotateAndCrop at the angles of 32 rotations within the first quarter turn
+    const int numberOfAngles = 7;
+    const float angleStep = 2.0 * M_PI / 32;
+    const float frequency = 6.0 * M_PI / image_dim;
+    const float center = (image_dim - 1) * 0.5;
+    auto function = [&](float x, float y) { return std::sin(frequency * x) * std::cos(0.7f * frequency * y); };
+    for (int x = 0; x < image_dim; ++x) {
+        for (int y = 0; y < image_dim; ++y) image[x*image_dim + y] = function(x - center, y - center);
+    }
+
+    std::cout << "rotateAndCrop, single channel, " << numberOfAngles << " angles per call" << std::endl;
+    for (Interpolation interpolation : {Interpolation::NEAREST_NEIGHBOR, Interpolation::BILINEAR, Interpolation::SHEAR}) {
+        std::ostringstream name;
+        name << interpolation;
+        measure(name.str(), numberOfAngles * neuron_size, repetitions, [&]{
+            for (int i = 1; i <= numberOfAngles; ++i)
+                rotateAndCrop(image_dim, image_dim, neuron_dim, neuron_dim, &image[0], &dest[0], i * angleStep, interpolation);
+        });
+    }
+
+    // Fixed point rotation of integer images with precomputed weights
+    std::vector<FixedPointRotation> fixedPointRotations;
+    for (int i = 1; i <= numberOfAngles; ++i)
+        fixedPointRotations.push_back(FixedPointRotation(image_dim, image_dim, neuron_dim, neuron_dim, i * angleStep));
+    std::vector<uint8_t> image8(image_size);
+    std::vector<uint16_t> image16(image_size);
+    std::vector<bfloat16> destBFloat16(neuron_size);
+    for (int i = 0; i < image_size; ++i) {
+        image8[i] = 127.5f * (image[i] + 1.0f);
+        image16[i] = 32767.5f * (image[i] + 1.0f);
+    }
+    measure("fixed point uint8 -> float", numberOfAngles * neuron_size, repetitions, [&]{
+        for (auto const& rotation : fixedPointRotations) rotation.apply(&image8[0], &dest[0], 1.0f / 127.5f, -1.0f);
+    });
+    measure("fixed point uint16 -> float", numberOfAngles * neuron_size, repetitions, [&]{
+        for (auto const& rotation : fixedPointRotations) rotation.apply(&image16[0], &dest[0], 1.0f / 32767.5f, -1.0f);
+    });
+    measure("fixed point uint8 -> bfloat16", numberOfAngles * neuron_size, repetitions, [&]{
+        for (auto const& rotation : fixedPointRotations) rotation.apply(&image8[0], &destBFloat16[0], 1.0f / 127.5f, -1.0f);
+    });
+
+    std::cout << "rotateAndCrop error of smooth image at " << 3 * angleStep << " rad" << std::endl;
+    for (Interpolation interpolation : {Interpolation::NEAREST_NEIGHBOR, Interpolation::BILINEAR, Interpolation::SHEAR}) {
+        std::ostringstream name;
+        name << interpolation;
+        rotateAndCrop(image_dim, image_dim, neuron_dim, neuron_dim, &image[0], &dest[0], 3 * angleStep, interpolation);
+        printRotationError(name.str(), dest, image_dim, neuron_dim, 3 * angleStep, function);
+    }
+    fixedPointRotations[2].apply(&image8[0], &dest[0], 1.0f / 127.5f, -1.0f);
+    printRotationError("fixed point uint8", dest, image_dim, neuron_dim, 3 * angleStep, function);
+    fixedPointRotations[2].apply(&image16[0], &dest[0], 1.0f / 32767.5f, -1.0f);
+    printRotationError("fixed point uint16", dest, image_dim, neuron_dim, 3 * angleStep, function);
+
+    return 0;
+}
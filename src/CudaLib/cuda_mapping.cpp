@@ -8,6 +8,9 @@
 #include "ImageProcessingLib/Image.h"
 #include "ImageProcessingLib/ImageIterator.h"
 #include "ImageProcessingLib/ImageProcessing.h"
+#include "SelfOrganizingMapLib/MappingResultWriter.h"
+#include "SelfOrganizingMapLib/NeuronPrototypes.h"
+#include "SelfOrganizingMapLib/NeuronStatistics.h"
 #include "SelfOrganizingMapLib/SelfOrganizingMap.h"
 #include "SelfOrganizingMapLib/SOM.h"
 #include "UtilitiesLib/Error.h"
@@ -15,6 +18,7 @@
 #include <chrono>
 #include <iostream>
 #include <iomanip>
+#include <memory>
 #include <stdio.h>
 
 using namespace std;
@@ -27,25 +31,19 @@ void cuda_mapping(InputData const& inputData)
     cout << "  Starting CUDA version of mapping.\n" << endl;
     if (inputData.verbose) cuda_print_properties();
 
-    // Open result file
-    std::ofstream resultFile(inputData.resultFilename);
-    if (!resultFile) fatalError("Error opening " + inputData.resultFilename);
-    resultFile.write((char*)&inputData.numberOfImages, sizeof(int));
-    resultFile.write((char*)&inputData.som_width, sizeof(int));
-    resultFile.write((char*)&inputData.som_height, sizeof(int));
-    resultFile.write((char*)&inputData.som_depth, sizeof(int));
-
-    std::ofstream write_rot_flip_file;
+    // Open result files
+    MappingResultWriter resultWriter(inputData);
     vector<int> bestRotationMatrix;
-    if (inputData.write_rot_flip) {
-        bestRotationMatrix.resize(inputData.som_size);
-        write_rot_flip_file.open(inputData.rot_flip_filename);
-        if (!write_rot_flip_file) fatalError("Error opening " + inputData.rot_flip_filename);
-        write_rot_flip_file.write((char*)&inputData.numberOfImages, sizeof(int));
-        write_rot_flip_file.write((char*)&inputData.som_width, sizeof(int));
-        write_rot_flip_file.write((char*)&inputData.som_height, sizeof(int));
-        write_rot_flip_file.write((char*)&inputData.som_depth, sizeof(int));
-    }
+    bool copyBestRotations = inputData.write_rot_flip or !inputData.prototypesFilename.empty();
+    if (copyBestRotations) bestRotationMatrix.resize(inputData.som_size);
+
+    std::unique_ptr<NeuronStatistics> ptrNeuronStatistics;
+    if (!inputData.neuronStatisticsFilename.empty())
+        ptrNeuronStatistics.reset(new NeuronStatistics(inputData.som_size, inputData.neuronStatisticsExamples));
+
+    std::unique_ptr<NeuronPrototypes> ptrPrototypes;
+    if (!inputData.prototypesFilename.empty())
+        ptrPrototypes.reset(new NeuronPrototypes(inputData.som_size, inputData.numberOfPrototypes));
 
     // Initialize SOM on host
     SOM som(inputData);
@@ -72,7 +70,6 @@ void cuda_mapping(InputData const& inputData)
     // Prepare trigonometric values
     float *d_cosAlpha = NULL, *d_sinAlpha = NULL;
     trigonometricValues(&d_cosAlpha, &d_sinAlpha, inputData.numberOfRotations/4);
-    float angleStepRadians = 2.0 * M_PI / inputData.numberOfRotations;
 
     // Progress status
     float progress = 0.0;
@@ -85,7 +82,7 @@ void cuda_mapping(InputData const& inputData)
     auto startTime = steady_clock::now();
     int updateCount = 0;
 
-    for (ImageIterator<float> iterImage(inputData.imagesFilename),iterEnd; iterImage != iterEnd; ++iterImage, ++updateCount)
+    for (ImageIterator<float> iterImage(inputData.imagesFilename, inputData.firstImage, inputData.numberOfImages), iterEnd; iterImage != iterEnd; ++iterImage, ++updateCount)
     {
         if ((inputData.progressFactor < 1.0 and progress > nextProgressPrint) or
             (inputData.progressFactor >= 1.0 and updateCount != 0 and !(updateCount % static_cast<int>(inputData.progressFactor))))
@@ -94,6 +91,7 @@ void cuda_mapping(InputData const& inputData)
                  << fixed << setprecision(progressPrecision) << setw(3) << progress*100 << " % ("
                  << duration_cast<seconds>(steady_clock::now() - startTime).count() << " s)" << endl;
 
+            resultWriter.flush();
             nextProgressPrint += inputData.progressFactor;
             startTime = steady_clock::now();
         }
@@ -110,22 +108,28 @@ void cuda_mapping(InputData const& inputData)
             inputData.numberOfRotationsAndFlip, d_rotatedImages, inputData.block_size_1, inputData.useMultipleGPUs);
 
         cuda_copyDeviceToHost_float(&euclideanDistanceMatrix[0], d_euclideanDistanceMatrix, inputData.som_size);
-        resultFile.write((char*)&euclideanDistanceMatrix[0], inputData.som_size * sizeof(float));
-
-        if (inputData.write_rot_flip) {
+        if (copyBestRotations)
             cuda_copyDeviceToHost_int(&bestRotationMatrix[0], d_bestRotationMatrix, inputData.som_size);
-        	for (int i = 0; i != inputData.som_size; ++i) {
-        		char flip = bestRotationMatrix[i] / inputData.numberOfRotations;
-        		float angle = (bestRotationMatrix[i] % inputData.numberOfRotations) * angleStepRadians;
-        	    write_rot_flip_file.write(&flip, sizeof(char));
-        	    write_rot_flip_file.write((char*)&angle, sizeof(float));
-        	}
+
+        resultWriter.write(&euclideanDistanceMatrix[0], bestRotationMatrix.data());
+
+        if (ptrNeuronStatistics) {
+            int bestMatch = findBestMatchingNeuron(&euclideanDistanceMatrix[0], inputData.som_size);
+            ptrNeuronStatistics->add(inputData.firstImage + updateCount, bestMatch, euclideanDistanceMatrix[bestMatch]);
         }
+
+        if (ptrPrototypes) ptrPrototypes->add(inputData.firstImage + updateCount, &euclideanDistanceMatrix[0],
+            &bestRotationMatrix[0]);
     }
 
     cout << "  Progress: " << setw(12) << updateCount << " updates, 100 % ("
          << duration_cast<seconds>(steady_clock::now() - startTime).count() << " s)" << endl;
 
+    resultWriter.close();
+    if (ptrNeuronStatistics) ptrNeuronStatistics->write(inputData.neuronStatisticsFilename, inputData);
+    if (ptrPrototypes) ptrPrototypes->write(inputData.prototypesFilename, inputData);
+    cout << "  Write stall time = " << setprecision(3) << resultWriter.getStallTime() << " s" << endl;
+
     // Free memory
     if (d_cosAlpha) cuda_free(d_cosAlpha);
     if (d_sinAlpha) cuda_free(d_sinAlpha);
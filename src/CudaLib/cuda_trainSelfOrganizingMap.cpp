@@ -71,7 +71,7 @@ void cuda_trainSelfOrganizingMap(InputData const& inputData)
 
     for (int iter = 0; iter != inputData.numIter; ++iter)
     {
-        for (ImageIterator<float> iterImage(inputData.imagesFilename),iterEnd; iterImage != iterEnd; ++iterImage, ++updateCount)
+        for (ImageIterator<float> iterImage(inputData.imagesFilename, inputData.firstImage, inputData.numberOfImages), iterEnd; iterImage != iterEnd; ++iterImage, ++updateCount)
         {
             if ((inputData.progressFactor < 1.0 and progress > nextProgressPrint) or
                 (inputData.progressFactor >= 1.0 and updateCount != 0 and !(updateCount % static_cast<int>(inputData.progressFactor))))
@@ -0,0 +1,314 @@
+/**
+ * @file   ImageProcessingLib/FitsImageReader.cpp
+ * @brief  Read images from the primary HDU of FITS files.
+ * @date   Oct 19, 2026
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <map>
+#include <stdexcept>
+#include <sys/stat.h>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define PINK_FITS_SIMD
+#endif
+
+#include "FitsImageReader.h"
+
+namespace pink {
+
+namespace {
+
+const int blockSize = 2880;
+const int cardSize = 80;
+
+bool isDirectory(std::string const& filename)
+{
+    struct stat st;
+    return stat(filename.c_str(), &st) == 0 and S_ISDIR(st.st_mode);
+}
+
+bool hasFitsExtension(std::string const& filename)
+{
+    for (std::string extension : {".fits", ".fit", ".fts"}) {
+        if (filename.size() > extension.size()
+            and filename.compare(filename.size() - extension.size(), extension.size(), extension) == 0) return true;
+    }
+    return false;
+}
+
+std::string trim(std::string const& s)
+{
+    size_t begin = s.find_first_not_of(' ');
+    if (begin == std::string::npos) return std::string();
+    return s.substr(begin, s.find_last_not_of(' ') - begin + 1);
+}
+
+//! Read the header cards of the primary HDU up to END, the stream is positioned at the data.
+std::map<std::string, std::string> readHeader(std::istream& is, std::string const& filename)
+{
+    std::map<std::string, std::string> cards;
+    char block[blockSize];
+    for (;;) {
+        is.read(block, blockSize);
+        if (!is) throw std::runtime_error("FitsImageReader: header of " + filename + " is truncated.");
+        for (int i = 0; i < blockSize; i += cardSize) {
+            std::string card(block + i, cardSize);
+            std::string keyword = trim(card.substr(0, 8));
+            if (keyword == "END") return cards;
+            if (card.compare(8, 2, "= ") != 0) continue;
+
+            // Numeric and logical values, a comment starts with /
+            std::string value = card.substr(10);
+            if (trim(value)[0] != '\'') value = value.substr(0, value.find('/'));
+            cards[keyword] = trim(value);
+        }
+    }
+}
+
+int intValue(std::map<std::string, std::string> const& cards, std::string const& keyword, std::string const& filename)
+{
+    auto iter = cards.find(keyword);
+    if (iter == cards.end()) throw std::runtime_error("FitsImageReader: " + keyword + " missing in " + filename);
+    return std::atoi(iter->second.c_str());
+}
+
+double doubleValue(std::map<std::string, std::string> const& cards, std::string const& keyword, double defaultValue)
+{
+    auto iter = cards.find(keyword);
+    if (iter == cards.end()) return defaultValue;
+    std::string value = iter->second;
+    std::replace(value.begin(), value.end(), 'D', 'E');
+    return std::atof(value.c_str());
+}
+
+//! Big endian int16 to uint16 with offset 32768.
+void swapInt16Scalar(uint16_t *data, size_t size)
+{
+    for (size_t i = 0; i < size; ++i) data[i] = __builtin_bswap16(data[i]) ^ 0x8000;
+}
+
+void swap32Scalar(uint32_t *data, size_t size)
+{
+    for (size_t i = 0; i < size; ++i) data[i] = __builtin_bswap32(data[i]);
+}
+
+//! Big endian float64 to float32.
+void convertFloat64Scalar(float *dest, uint64_t const *source, size_t size)
+{
+    for (size_t i = 0; i < size; ++i) {
+        uint64_t u = __builtin_bswap64(source[i]);
+        double d;
+        std::memcpy(&d, &u, sizeof(double));
+        dest[i] = d;
+    }
+}
+
+#ifdef PINK_FITS_SIMD
+
+__attribute__((target("avx2")))
+void swapInt16AVX2(uint16_t *data, size_t size)
+{
+    const __m256i shuffle = _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+                                             1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    const __m256i sign = _mm256_set1_epi16(static_cast<short>(0x8000));
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m256i v = _mm256_loadu_si256((__m256i const*)(data + i));
+        _mm256_storeu_si256((__m256i*)(data + i), _mm256_xor_si256(_mm256_shuffle_epi8(v, shuffle), sign));
+    }
+    for (; i < size; ++i) data[i] = __builtin_bswap16(data[i]) ^ 0x8000;
+}
+
+__attribute__((target("avx2")))
+void swap32AVX2(uint32_t *data, size_t size)
+{
+    const __m256i shuffle = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                             3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        __m256i v = _mm256_loadu_si256((__m256i const*)(data + i));
+        _mm256_storeu_si256((__m256i*)(data + i), _mm256_shuffle_epi8(v, shuffle));
+    }
+    for (; i < size; ++i) data[i] = __builtin_bswap32(data[i]);
+}
+
+__attribute__((target("avx2")))
+void convertFloat64AVX2(float *dest, uint64_t const *source, size_t size)
+{
+    const __m256i shuffle = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+                                             7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        __m256i v = _mm256_shuffle_epi8(_mm256_loadu_si256((__m256i const*)(source + i)), shuffle);
+        _mm_storeu_ps(dest + i, _mm256_cvtpd_ps(_mm256_castsi256_pd(v)));
+    }
+    for (; i < size; ++i) {
+        uint64_t u = __builtin_bswap64(source[i]);
+        double d;
+        std::memcpy(&d, &u, sizeof(double));
+        dest[i] = d;
+    }
+}
+
+const bool hasAVX2 = __builtin_cpu_supports("avx2");
+
+#endif
+
+void swapInt16(uint16_t *data, size_t size)
+{
+#ifdef PINK_FITS_SIMD
+    if (hasAVX2) return swapInt16AVX2(data, size);
+#endif
+    swapInt16Scalar(data, size);
+}
+
+void swap32(uint32_t *data, size_t size)
+{
+#ifdef PINK_FITS_SIMD
+    if (hasAVX2) return swap32AVX2(data, size);
+#endif
+    swap32Scalar(data, size);
+}
+
+void convertFloat64(float *dest, uint64_t const *source, size_t size)
+{
+#ifdef PINK_FITS_SIMD
+    if (hasAVX2) return convertFloat64AVX2(dest, source, size);
+#endif
+    convertFloat64Scalar(dest, source, size);
+}
+
+} // anonymous namespace
+
+bool isFitsFile(std::string const& filename)
+{
+    if (isDirectory(filename)) return true;
+    std::ifstream is(filename, std::ios::binary);
+    char keyword[9];
+    is.read(keyword, sizeof(keyword));
+    return is and std::equal(keyword, keyword + sizeof(keyword), "SIMPLE  =");
+}
+
+FitsImageReader::FitsImageReader(std::string const& filename)
+ : bitpix_(0),
+   currentImage_(0),
+   openedFile_(0)
+{
+    if (isDirectory(filename)) {
+        DIR *dir = opendir(filename.c_str());
+        if (!dir) throw std::runtime_error("FitsImageReader: Error opening " + filename);
+        while (struct dirent *entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (hasFitsExtension(name)) filenames_.push_back(filename + "/" + name);
+        }
+        closedir(dir);
+        std::sort(filenames_.begin(), filenames_.end());
+        if (filenames_.empty()) throw std::runtime_error("FitsImageReader: no FITS files in " + filename);
+
+        std::vector<int> dims = open(filenames_[0]);
+        if (dims[3] != 1) throw std::runtime_error("FitsImageReader: " + filenames_[0] + " has more than three axes.");
+        header_.numberOfImages = filenames_.size();
+        header_.numberOfChannels = dims[2];
+    } else {
+        std::vector<int> dims = open(filename);
+        header_.numberOfImages = dims[2] * dims[3];
+        header_.numberOfChannels = 1;
+        if (dims[3] != 1) {
+            header_.numberOfImages = dims[3];
+            header_.numberOfChannels = dims[2];
+        }
+    }
+}
+
+std::vector<int> FitsImageReader::open(std::string const& filename)
+{
+    is_.close();
+    is_.open(filename, std::ios::binary);
+    if (!is_) throw std::runtime_error("FitsImageReader: Error opening " + filename);
+
+    std::map<std::string, std::string> cards = readHeader(is_, filename);
+    if (cards["SIMPLE"] != "T") throw std::runtime_error("FitsImageReader: " + filename + " is not a FITS file.");
+
+    int bitpix = intValue(cards, "BITPIX", filename);
+    int naxis = intValue(cards, "NAXIS", filename);
+    if (naxis < 2 or naxis > 4)
+        throw std::runtime_error("FitsImageReader: primary HDU of " + filename + " must have 2, 3 or 4 axes.");
+
+    std::vector<int> dims(4, 1);
+    for (int i = 0; i < naxis; ++i) dims[i] = intValue(cards, "NAXIS" + std::to_string(i + 1), filename);
+
+    double bscale = doubleValue(cards, "BSCALE", 1.0);
+    double bzero = doubleValue(cards, "BZERO", 0.0);
+    if (bitpix == 16) bzero -= 32768.0 * bscale;
+
+    // All files of a directory must fit to the first one, the scaling is shared by all images
+    if (bitpix_ != 0) {
+        if (bitpix != bitpix_ or dims[0] != header_.width or dims[1] != header_.height
+            or dims[2] != header_.numberOfChannels or dims[3] != 1)
+            throw std::runtime_error("FitsImageReader: dimensions or BITPIX of " + filename
+                + " differ from the first file.");
+        if (static_cast<float>(bscale) != header_.scale or static_cast<float>(bzero) != header_.offset)
+            throw std::runtime_error("FitsImageReader: BSCALE or BZERO of " + filename
+                + " differ from the first file.");
+        return dims;
+    }
+
+    if (bitpix == 8) header_.pixelType = PixelType::UINT8;
+    else if (bitpix == 16) header_.pixelType = PixelType::UINT16;
+    else if (bitpix == -32 or bitpix == -64) header_.pixelType = PixelType::FLOAT32;
+    else throw std::runtime_error("FitsImageReader: BITPIX " + std::to_string(bitpix) + " of " + filename
+        + " is not supported, only 8, 16, -32 and -64.");
+
+    bitpix_ = bitpix;
+    header_.scale = bscale;
+    header_.offset = bzero;
+    header_.width = dims[0];
+    header_.height = dims[1];
+    dataOffset_ = is_.tellg();
+    return dims;
+}
+
+void FitsImageReader::next(char *raw)
+{
+    if (currentImage_ >= header_.numberOfImages) throw std::runtime_error("FitsImageReader: no more images.");
+    if (!filenames_.empty() and openedFile_ != currentImage_) {
+        open(filenames_[currentImage_]);
+        openedFile_ = currentImage_;
+    }
+
+    const size_t size = header_.getImageSize();
+    if (bitpix_ == -64) {
+        buffer_.resize(size * sizeof(double));
+        is_.read(&buffer_[0], buffer_.size());
+    } else {
+        is_.read(raw, header_.getImageSizeInBytes());
+    }
+    if (!is_) throw std::runtime_error("FitsImageReader: data is truncated.");
+
+    if (bitpix_ == 16) swapInt16((uint16_t*)raw, size);
+    else if (bitpix_ == -32) swap32((uint32_t*)raw, size);
+    else if (bitpix_ == -64) convertFloat64((float*)raw, (uint64_t const*)&buffer_[0], size);
+
+    ++currentImage_;
+}
+
+void FitsImageReader::seek(int image)
+{
+    if (image < 0 or image > header_.numberOfImages) throw std::runtime_error("FitsImageReader: image index out of range.");
+    if (filenames_.empty()) {
+        is_.clear();
+        is_.seekg(dataOffset_ + static_cast<std::streamoff>(image) * header_.getImageSize() * std::abs(bitpix_) / 8);
+    } else {
+        // The data of the opened file may already be consumed, it is opened again by next
+        openedFile_ = -1;
+    }
+    currentImage_ = image;
+}
+
+} // namespace pink
@@ -0,0 +1,70 @@
+/**
+ * @file   ImageProcessingLib/FitsImageReader.h
+ * @brief  Read images from the primary HDU of FITS files.
+ * @date   Oct 19, 2026
+ */
+
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "ImageReader.h"
+
+namespace pink {
+
+/**
+ * @brief Reader of FITS files without external dependencies.
+ *
+ * Only the primary HDU is read, BITPIX 8, 16, -32 and -64 are supported.
+ * NAXIS1 is the width and NAXIS2 the height, which gives the same pixel order
+ * as the binary image format. For a single file NAXIS3 is the number of images,
+ * for NAXIS = 4 NAXIS3 is the number of channels and NAXIS4 the number of images.
+ * For a directory every FITS file (.fits, .fit, .fts) is one image in lexicographic order,
+ * NAXIS3 is the number of channels. All files must have the same dimensions, BITPIX, BSCALE and BZERO.
+ *
+ * The big endian pixels are swapped when they are read. BITPIX 8 and 16 are returned
+ * as uint8 and uint16 with BSCALE and BZERO as scale and offset, BITPIX -64 is converted to float32.
+ */
+class FitsImageReader : public ImageReader
+{
+public:
+
+    //! Open a FITS file or a directory of FITS files.
+    FitsImageReader(std::string const& filename);
+
+    void next(char *raw);
+
+    void seek(int image);
+
+private:
+
+    //! Open the FITS file, read the header and set the pixel type, the dimensions are returned.
+    std::vector<int> open(std::string const& filename);
+
+    std::ifstream is_;
+
+    int bitpix_;
+
+    //! File position of the first image of a single file.
+    std::streamoff dataOffset_;
+
+    //! Sorted FITS files of the directory, empty for a single file.
+    std::vector<std::string> filenames_;
+
+    //! Index of the next image returned by @next.
+    int currentImage_;
+
+    //! Index of the opened file of the directory.
+    int openedFile_;
+
+    //! Big endian pixels of BITPIX -64.
+    std::vector<char> buffer_;
+
+};
+
+//! Return true if the file starts with the FITS keyword SIMPLE or is a directory.
+bool isFitsFile(std::string const& filename);
+
+} // namespace pink
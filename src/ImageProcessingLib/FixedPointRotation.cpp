@@ -0,0 +1,236 @@
+/**
+ * @file   ImageProcessingLib/FixedPointRotation.cpp
+ * @brief  Bilinear rotation of integer images with precomputed fixed point weights.
+ * @date   Oct 19, 2026
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define PINK_FIXED_POINT_SIMD
+#endif
+
+#include "FixedPointRotation.h"
+
+namespace pink {
+
+namespace {
+
+const int weightOne = 1 << FixedPointRotation::fractionalBits;
+
+//! Trailing zeros of the padded source, the SIMD path reads 32 bit words at the last neighbor.
+const int paddingSlack = 4;
+
+//! Copy source into a zero padded image with one pixel border, rows of the padded image have height + 2 pixels.
+template <class Pixel>
+void padSource(std::vector<Pixel>& padded, Pixel const *source, int height, int width)
+{
+    const int padded_height = height + 2;
+    padded.assign((width + 2) * padded_height + paddingSlack, 0);
+    for (int x = 0; x < width; ++x) {
+        std::copy(source + x * height, source + (x + 1) * height, &padded[(x + 1) * padded_height + 1]);
+    }
+}
+
+inline void store(float *dest, float value) { *dest = value; }
+
+inline void store(bfloat16 *dest, float value) { *dest = bfloat16(value); }
+
+template <class Pixel, class Output>
+void applyScalar(Pixel const *padded, Output *dest, int32_t const *offsets, int16_t const *firstRowWeights,
+    int16_t const *secondRowWeights, float const *insideWeights, int size, int padded_height, float factor, float offset)
+{
+    for (int i = 0; i < size; ++i) {
+        Pixel const *p = padded + offsets[i];
+        int32_t sum = firstRowWeights[2*i] * p[0] + firstRowWeights[2*i + 1] * p[1]
+                    + secondRowWeights[2*i] * p[padded_height] + secondRowWeights[2*i + 1] * p[padded_height + 1];
+        store(dest + i, sum * factor + offset * insideWeights[i]);
+    }
+}
+
+#ifdef PINK_FIXED_POINT_SIMD
+
+//! Weighted sum of the pixel pairs at index and index + 1 for eight destination pixels.
+__attribute__((target("avx2")))
+inline __m256i weightedPairs(uint8_t const *padded, __m256i index, int16_t const *weights)
+{
+    __m256i words = _mm256_i32gather_epi32((int const*)padded, index, 1);
+    __m256i pairs = _mm256_or_si256(_mm256_and_si256(words, _mm256_set1_epi32(0xff)),
+        _mm256_and_si256(_mm256_slli_epi32(words, 8), _mm256_set1_epi32(0xff0000)));
+    return _mm256_madd_epi16(pairs, _mm256_loadu_si256((__m256i const*)weights));
+}
+
+//! Weighted sum of the pixel pairs at index and index + 1 for eight destination pixels.
+__attribute__((target("avx2")))
+inline __m256i weightedPairs(uint16_t const *padded, __m256i index, int16_t const *weights)
+{
+    // Unsigned 16 bit pixels do not fit into madd, the products are computed in 32 bit
+    __m256i words = _mm256_i32gather_epi32((int const*)padded, index, 2);
+    __m256i w = _mm256_loadu_si256((__m256i const*)weights);
+    __m256i mask = _mm256_set1_epi32(0xffff);
+    return _mm256_add_epi32(
+        _mm256_mullo_epi32(_mm256_and_si256(words, mask), _mm256_and_si256(w, mask)),
+        _mm256_mullo_epi32(_mm256_srli_epi32(words, 16), _mm256_srli_epi32(w, 16)));
+}
+
+template <class Pixel>
+__attribute__((target("avx2")))
+void applyAVX2(Pixel const *padded, float *dest, int32_t const *offsets, int16_t const *firstRowWeights,
+    int16_t const *secondRowWeights, float const *insideWeights, int size, int padded_height, float factor, float offset)
+{
+    const __m256i vpadded_height = _mm256_set1_epi32(padded_height);
+    const __m256 vfactor = _mm256_set1_ps(factor);
+    const __m256 voffset = _mm256_set1_ps(offset);
+
+    int i = 0;
+    for (; i + 8 <= size; i += 8) {
+        __m256i index = _mm256_loadu_si256((__m256i const*)(offsets + i));
+        __m256i sum = _mm256_add_epi32(weightedPairs(padded, index, firstRowWeights + 2*i),
+            weightedPairs(padded, _mm256_add_epi32(index, vpadded_height), secondRowWeights + 2*i));
+        _mm256_storeu_ps(dest + i, _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(sum), vfactor),
+            _mm256_mul_ps(_mm256_loadu_ps(insideWeights + i), voffset)));
+    }
+
+    // Scalar tail within the AVX2 function to avoid SSE transitions
+    for (; i < size; ++i) {
+        Pixel const *p = padded + offsets[i];
+        int32_t sum = firstRowWeights[2*i] * p[0] + firstRowWeights[2*i + 1] * p[1]
+                    + secondRowWeights[2*i] * p[padded_height] + secondRowWeights[2*i + 1] * p[padded_height + 1];
+        dest[i] = sum * factor + offset * insideWeights[i];
+    }
+}
+
+//! Round finite floats to nearest even bfloat16.
+__attribute__((target("avx2")))
+void convertAVX2(bfloat16 *dest, float const *source, int size)
+{
+    int i = 0;
+    for (; i + 8 <= size; i += 8) {
+        __m256i u = _mm256_castps_si256(_mm256_loadu_ps(source + i));
+        __m256i lsb = _mm256_and_si256(_mm256_srli_epi32(u, 16), _mm256_set1_epi32(1));
+        __m256i bits = _mm256_srli_epi32(_mm256_add_epi32(u, _mm256_add_epi32(_mm256_set1_epi32(0x7fff), lsb)), 16);
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(bits, bits), 0x08);
+        _mm_storeu_si128((__m128i*)(dest + i), _mm256_castsi256_si128(packed));
+    }
+    for (; i < size; ++i) dest[i] = bfloat16(source[i]);
+}
+
+/**
+ * @brief bfloat16 output in chunks of floats.
+ *
+ * Converting directly after the interpolation makes the gather of the next
+ * iteration wait for the conversion, since the gather merges into its
+ * destination register.
+ */
+template <class Pixel>
+__attribute__((target("avx2")))
+void applyAVX2(Pixel const *padded, bfloat16 *dest, int32_t const *offsets, int16_t const *firstRowWeights,
+    int16_t const *secondRowWeights, float const *insideWeights, int size, int padded_height, float factor, float offset)
+{
+    const int chunkSize = 256;
+    float buffer[chunkSize];
+    for (int begin = 0; begin < size; begin += chunkSize) {
+        int n = std::min(chunkSize, size - begin);
+        applyAVX2(padded, buffer, offsets + begin, firstRowWeights + 2*begin, secondRowWeights + 2*begin,
+            insideWeights + begin, n, padded_height, factor, offset);
+        convertAVX2(dest + begin, buffer, n);
+    }
+}
+
+const bool hasAVX2 = __builtin_cpu_supports("avx2");
+
+#endif
+
+} // anonymous namespace
+
+FixedPointRotation::FixedPointRotation(int height, int width, int height_new, int width_new, float alpha)
+ : height_(height),
+   width_(width),
+   height_new_(height_new),
+   width_new_(width_new),
+   offsets_(height_new * width_new, 0),
+   firstRowWeights_(2 * height_new * width_new, 0),
+   secondRowWeights_(2 * height_new * width_new, 0),
+   insideWeights_(height_new * width_new, 0.0f)
+{
+    const int width_margin = (width - width_new) * 0.5;
+    const int height_margin = (height - height_new) * 0.5;
+
+    const float cosAlpha = cos(alpha);
+    const float sinAlpha = sin(alpha);
+    const float x0 = (width-1) * 0.5;
+    const float y0 = (height-1) * 0.5;
+
+    for (int x2 = 0; x2 < width_new; ++x2) {
+        const float tx = (float)x2 + width_margin - x0;
+        for (int y2 = 0; y2 < height_new; ++y2) {
+            const float ty = (float)y2 + height_margin - y0;
+            const float x1 = tx * cosAlpha + ty * sinAlpha + x0;
+            const float y1 = ty * cosAlpha - tx * sinAlpha + y0;
+            const int ix1 = std::floor(x1);
+            const int iy1 = std::floor(y1);
+
+            // No neighbor within the image, the weights remain zero
+            if (ix1 < -1 or ix1 >= width or iy1 < -1 or iy1 >= height) continue;
+
+            const int i = x2 * height_new + y2;
+            const int rx1 = std::lround((x1 - ix1) * weightOne);
+            const int ry1 = std::lround((y1 - iy1) * weightOne);
+            offsets_[i] = (ix1 + 1) * (height + 2) + iy1 + 1;
+            firstRowWeights_[2*i] = (weightOne - rx1) * (weightOne - ry1);
+            firstRowWeights_[2*i + 1] = (weightOne - rx1) * ry1;
+            secondRowWeights_[2*i] = rx1 * (weightOne - ry1);
+            secondRowWeights_[2*i + 1] = rx1 * ry1;
+
+            // The offset of the pixel values only applies to the neighbors inside the image
+            auto inside = [&](int ix, int iy) { return ix >= 0 and ix < width and iy >= 0 and iy < height; };
+            int insideWeight = 0;
+            if (inside(ix1, iy1)) insideWeight += firstRowWeights_[2*i];
+            if (inside(ix1, iy1 + 1)) insideWeight += firstRowWeights_[2*i + 1];
+            if (inside(ix1 + 1, iy1)) insideWeight += secondRowWeights_[2*i];
+            if (inside(ix1 + 1, iy1 + 1)) insideWeight += secondRowWeights_[2*i + 1];
+            insideWeights_[i] = static_cast<float>(insideWeight) / (weightOne * weightOne);
+        }
+    }
+}
+
+template <class Pixel, class Output>
+void FixedPointRotation::applyImpl(Pixel const *source, Output *dest, float scale, float offset) const
+{
+    std::vector<Pixel> padded;
+    padSource(padded, source, height_, width_);
+
+    const int size = height_new_ * width_new_;
+    const float factor = scale / (weightOne * weightOne);
+
+#ifdef PINK_FIXED_POINT_SIMD
+    if (hasAVX2) return applyAVX2(&padded[0], dest, &offsets_[0], &firstRowWeights_[0], &secondRowWeights_[0],
+        &insideWeights_[0], size, height_ + 2, factor, offset);
+#endif
+    applyScalar(&padded[0], dest, &offsets_[0], &firstRowWeights_[0], &secondRowWeights_[0],
+        &insideWeights_[0], size, height_ + 2, factor, offset);
+}
+
+void FixedPointRotation::apply(uint8_t const *source, float *dest, float scale, float offset) const
+{
+    applyImpl(source, dest, scale, offset);
+}
+
+void FixedPointRotation::apply(uint16_t const *source, float *dest, float scale, float offset) const
+{
+    applyImpl(source, dest, scale, offset);
+}
+
+void FixedPointRotation::apply(uint8_t const *source, bfloat16 *dest, float scale, float offset) const
+{
+    applyImpl(source, dest, scale, offset);
+}
+
+void FixedPointRotation::apply(uint16_t const *source, bfloat16 *dest, float scale, float offset) const
+{
+    applyImpl(source, dest, scale, offset);
+}
+
+} // namespace pink
@@ -0,0 +1,69 @@
+/**
+ * @file   ImageProcessingLib/FixedPointRotation.h
+ * @brief  Bilinear rotation of integer images with precomputed fixed point weights.
+ * @date   Oct 19, 2026
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "UtilitiesLib/HalfPrecision.h"
+
+namespace pink {
+
+/**
+ * @brief Bilinear @rotateAndCrop of uint8 or uint16 images in fixed point arithmetic.
+ *
+ * The source offsets and weights only depend on the image dimensions and the angle,
+ * they are computed once and used for all images and channels of the same size.
+ * The weights have fractionalBits bits per axis, their products fit into int16
+ * and sum up to 1 << (2 * fractionalBits). Pixels are accumulated in int32.
+ * The source is zero padded by one pixel. The offset is weighted by the neighbors inside
+ * the image, so pixels outside are zero after scaling as in the float version.
+ */
+class FixedPointRotation
+{
+public:
+
+    //! Number of fractional bits of the interpolation position per axis.
+    static const int fractionalBits = 7;
+
+    FixedPointRotation(int height, int width, int height_new, int width_new, float alpha);
+
+    //! Rotate and crop one channel, dest = scale * interpolated pixel + offset.
+    void apply(uint8_t const *source, float *dest, float scale = 1.0f, float offset = 0.0f) const;
+
+    //! Rotate and crop one channel, dest = scale * interpolated pixel + offset.
+    void apply(uint16_t const *source, float *dest, float scale = 1.0f, float offset = 0.0f) const;
+
+    //! Rotate and crop one channel, dest = scale * interpolated pixel + offset rounded to bfloat16.
+    void apply(uint8_t const *source, bfloat16 *dest, float scale = 1.0f, float offset = 0.0f) const;
+
+    //! Rotate and crop one channel, dest = scale * interpolated pixel + offset rounded to bfloat16.
+    void apply(uint16_t const *source, bfloat16 *dest, float scale = 1.0f, float offset = 0.0f) const;
+
+private:
+
+    template <class Pixel, class Output>
+    void applyImpl(Pixel const *source, Output *dest, float scale, float offset) const;
+
+    int height_;
+    int width_;
+    int height_new_;
+    int width_new_;
+
+    //! Index of the upper left neighbor in the zero padded source per destination pixel.
+    std::vector<int32_t> offsets_;
+
+    //! Weights of the two neighbors in the first and second row, interleaved per destination pixel.
+    std::vector<int16_t> firstRowWeights_;
+    std::vector<int16_t> secondRowWeights_;
+
+    //! Sum of the weights of the neighbors inside the source per destination pixel, 1 within the image.
+    std::vector<float> insideWeights_;
+
+};
+
+} // namespace pink
@@ -0,0 +1,27 @@
+/**
+ * @file   ImageProcessingLib/ImageCodec.h
+ * @date   Oct 19, 2026
+ */
+
+#pragma once
+
+#include <iostream>
+
+namespace pink {
+
+//! Compression of the blocks of an image container, the values are written into the container header
+enum class ImageCodec {
+    NONE = 0,
+    ZLIB = 1
+};
+
+//! Pretty printing of ImageCodec.
+inline std::ostream& operator << (std::ostream& os, ImageCodec codec)
+{
+    if (codec == ImageCodec::NONE) os << "none";
+    else if (codec == ImageCodec::ZLIB) os << "zlib";
+    else os << "undefined";
+    return os;
+}
+
+} // namespace pink
@@ -0,0 +1,333 @@
+/**
+ * @file   ImageProcessingLib/ImageContainer.cpp
+ * @brief  Block compressed container of images.
+ * @date   Oct 19, 2026
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <unistd.h>
+
+#ifdef PINK_USE_ZLIB
+#include <zlib.h>
+#endif
+
+#include "ImageContainer.h"
+
+namespace pink {
+
+namespace {
+
+const char magic[8] = {'P', 'I', 'N', 'K', 'B', 'L', 'C', 'K'};
+const int containerVersion = 1;
+
+//! Size of the container header in bytes.
+const int64_t headerSize = sizeof(magic) + 11 * sizeof(int) + sizeof(int64_t);
+
+//! File position of numberOfBlocks in the header.
+const int64_t numberOfBlocksPosition = sizeof(magic) + 3 * sizeof(int);
+
+//! File position of numberOfImages in the header.
+const int64_t numberOfImagesPosition = sizeof(magic) + 7 * sizeof(int);
+
+//! File position of the block index offset in the header.
+const int64_t indexOffsetPosition = sizeof(magic) + 11 * sizeof(int);
+
+void checkCodec(ImageCodec codec)
+{
+    if (codec != ImageCodec::NONE and codec != ImageCodec::ZLIB)
+        throw std::runtime_error("ImageContainer: unknown codec.");
+#ifndef PINK_USE_ZLIB
+    if (codec == ImageCodec::ZLIB) throw std::runtime_error("ImageContainer: Pink was built without zlib.");
+#endif
+}
+
+//! Read size bytes at file offset, pread is thread safe.
+void readAt(int fd, char *data, int64_t size, int64_t offset)
+{
+    while (size > 0) {
+        ssize_t n = pread(fd, data, size, offset);
+        if (n <= 0) throw std::runtime_error("ImageContainer: read error.");
+        data += n;
+        size -= n;
+        offset += n;
+    }
+}
+
+} // anonymous namespace
+
+bool isImageContainer(std::string const& filename)
+{
+    std::ifstream is(filename, std::ios::binary);
+    char fileMagic[sizeof(magic)];
+    is.read(fileMagic, sizeof(fileMagic));
+    return is and std::equal(fileMagic, fileMagic + sizeof(magic), magic);
+}
+
+ImageContainerWriter::ImageContainerWriter(std::string const& filename, ImageFileHeader const& header,
+    int imagesPerBlock, ImageCodec codec, int level)
+ : os_(filename, std::ios::binary),
+   header_(header),
+   imagesPerBlock_(imagesPerBlock),
+   codec_(codec),
+   level_(level),
+   block_(imagesPerBlock * header.getImageSizeInBytes()),
+   imagesInBlock_(0)
+{
+    if (!os_) throw std::runtime_error("ImageContainerWriter: Error opening " + filename);
+    if (imagesPerBlock <= 0) throw std::runtime_error("ImageContainerWriter: imagesPerBlock must be positive.");
+    checkCodec(codec);
+
+    // Number of blocks, number of images and index offset are written by close
+    header_.numberOfImages = 0;
+    int numberOfBlocks = 0;
+    int codecValue = static_cast<int>(codec_);
+    int pixelType = static_cast<int>(header_.pixelType);
+    int64_t indexOffset = 0;
+
+    os_.write(magic, sizeof(magic));
+    os_.write((char*)&containerVersion, sizeof(int));
+    os_.write((char*)&codecValue, sizeof(int));
+    os_.write((char*)&imagesPerBlock_, sizeof(int));
+    os_.write((char*)&numberOfBlocks, sizeof(int));
+    os_.write((char*)&pixelType, sizeof(int));
+    os_.write((char*)&header_.scale, sizeof(float));
+    os_.write((char*)&header_.offset, sizeof(float));
+    os_.write((char*)&header_.numberOfImages, sizeof(int));
+    os_.write((char*)&header_.numberOfChannels, sizeof(int));
+    os_.write((char*)&header_.height, sizeof(int));
+    os_.write((char*)&header_.width, sizeof(int));
+    os_.write((char*)&indexOffset, sizeof(int64_t));
+}
+
+ImageContainerWriter::~ImageContainerWriter()
+{
+    close();
+}
+
+void ImageContainerWriter::add(float const *images, int numberOfImages)
+{
+    const size_t imageSize = header_.getImageSize();
+    const size_t imageSizeInBytes = header_.getImageSizeInBytes();
+
+    for (int i = 0; i < numberOfImages; ++i) {
+        narrowPixels(&block_[imagesInBlock_ * imageSizeInBytes], images + i * imageSize, imageSize,
+            header_.pixelType, header_.scale, header_.offset);
+        ++header_.numberOfImages;
+        if (++imagesInBlock_ == imagesPerBlock_) writeBlock();
+    }
+}
+
+void ImageContainerWriter::writeBlock()
+{
+    const size_t size = imagesInBlock_ * header_.getImageSizeInBytes();
+    int64_t offset = os_.tellp();
+
+    if (codec_ == ImageCodec::NONE) {
+        os_.write(&block_[0], size);
+        index_.push_back(offset);
+        index_.push_back(size);
+    }
+#ifdef PINK_USE_ZLIB
+    else {
+        uLongf compressedSize = compressBound(size);
+        std::vector<char> compressed(compressedSize);
+        if (compress2((Bytef*)&compressed[0], &compressedSize, (Bytef const*)&block_[0], size, level_) != Z_OK)
+            throw std::runtime_error("ImageContainerWriter: compression failed.");
+        os_.write(&compressed[0], compressedSize);
+        index_.push_back(offset);
+        index_.push_back(compressedSize);
+    }
+#endif
+
+    imagesInBlock_ = 0;
+}
+
+void ImageContainerWriter::close()
+{
+    if (!os_.is_open()) return;
+    if (imagesInBlock_) writeBlock();
+
+    int64_t indexOffset = os_.tellp();
+    if (!index_.empty()) os_.write((char*)&index_[0], index_.size() * sizeof(int64_t));
+
+    int numberOfBlocks = index_.size() / 2;
+    os_.seekp(numberOfBlocksPosition);
+    os_.write((char*)&numberOfBlocks, sizeof(int));
+    os_.seekp(numberOfImagesPosition);
+    os_.write((char*)&header_.numberOfImages, sizeof(int));
+    os_.seekp(indexOffsetPosition);
+    os_.write((char*)&indexOffset, sizeof(int64_t));
+
+    os_.close();
+}
+
+ImageContainerReader::ImageContainerReader(std::string const& filename, int numberOfThreads)
+ : fd_(open(filename.c_str(), O_RDONLY)),
+   nextBlockToDecompress_(0),
+   currentBlock_(0),
+   currentImage_(0),
+   stop_(false)
+{
+    if (fd_ < 0) throw std::runtime_error("ImageContainerReader: Error opening " + filename);
+
+    std::vector<char> header(headerSize);
+    readAt(fd_, &header[0], headerSize, 0);
+    if (!std::equal(magic, magic + sizeof(magic), header.begin())) {
+        ::close(fd_);
+        throw std::runtime_error("ImageContainerReader: " + filename + " is not an image container.");
+    }
+
+    int values[11];
+    int64_t indexOffset;
+    std::memcpy(values, &header[sizeof(magic)], sizeof(values));
+    std::memcpy(&indexOffset, &header[indexOffsetPosition], sizeof(int64_t));
+
+    if (values[0] != containerVersion) {
+        ::close(fd_);
+        throw std::runtime_error("ImageContainerReader: unsupported version of " + filename);
+    }
+    codec_ = static_cast<ImageCodec>(values[1]);
+    imagesPerBlock_ = values[2];
+    int numberOfBlocks = values[3];
+    header_.pixelType = static_cast<PixelType>(values[4]);
+    std::memcpy(&header_.scale, &values[5], sizeof(float));
+    std::memcpy(&header_.offset, &values[6], sizeof(float));
+    header_.numberOfImages = values[7];
+    header_.numberOfChannels = values[8];
+    header_.height = values[9];
+    header_.width = values[10];
+
+    try {
+        checkCodec(codec_);
+        if (imagesPerBlock_ <= 0 or header_.numberOfImages < 0
+            or numberOfBlocks != (header_.numberOfImages + imagesPerBlock_ - 1) / imagesPerBlock_)
+            throw std::runtime_error("ImageContainerReader: number of blocks of " + filename
+                + " does not fit to the number of images.");
+        index_.resize(2 * numberOfBlocks);
+        if (numberOfBlocks) readAt(fd_, (char*)&index_[0], index_.size() * sizeof(int64_t), indexOffset);
+    } catch (...) {
+        ::close(fd_);
+        throw;
+    }
+
+    if (numberOfThreads <= 0) numberOfThreads = std::max(1u, std::min(4u, std::thread::hardware_concurrency()));
+    maxBlocksAhead_ = 2 * numberOfThreads;
+    for (int i = 0; i < numberOfThreads; ++i) threads_.push_back(std::thread(&ImageContainerReader::decompress, this));
+}
+
+ImageContainerReader::~ImageContainerReader()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    condition_.notify_all();
+    for (auto& t : threads_) t.join();
+    ::close(fd_);
+}
+
+void ImageContainerReader::readBlock(int block, std::vector<char>& data) const
+{
+    const int numberOfImages = std::min(imagesPerBlock_, header_.numberOfImages - block * imagesPerBlock_);
+    const size_t size = numberOfImages * header_.getImageSizeInBytes();
+    const int64_t offset = index_[2 * block];
+    const int64_t compressedSize = index_[2 * block + 1];
+
+    if (codec_ == ImageCodec::NONE) {
+        if (static_cast<size_t>(compressedSize) != size) throw std::runtime_error("ImageContainerReader: wrong block size.");
+        data.resize(size);
+        readAt(fd_, &data[0], size, offset);
+    }
+#ifdef PINK_USE_ZLIB
+    else {
+        std::vector<char> compressed(compressedSize);
+        readAt(fd_, &compressed[0], compressedSize, offset);
+        data.resize(size);
+        uLongf uncompressedSize = size;
+        if (uncompress((Bytef*)&data[0], &uncompressedSize, (Bytef const*)&compressed[0], compressedSize) != Z_OK
+            or uncompressedSize != size)
+            throw std::runtime_error("ImageContainerReader: decompression failed.");
+    }
+#endif
+}
+
+void ImageContainerReader::decompress()
+{
+    const int numberOfBlocks = getNumberOfBlocks();
+
+    for (;;) {
+        int block;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [&]{ return stop_ or (nextBlockToDecompress_ < numberOfBlocks
+                and nextBlockToDecompress_ < currentBlock_ + maxBlocksAhead_); });
+            if (stop_) return;
+            block = nextBlockToDecompress_++;
+        }
+
+        // A failed block is kept with its exception, the blocks after it are still decompressed
+        std::vector<char> data;
+        std::exception_ptr exception;
+        try {
+            readBlock(block, data);
+        } catch (...) {
+            exception = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (block >= currentBlock_) {
+                if (exception) failedBlocks_[block] = exception;
+                else decompressedBlocks_[block].swap(data);
+            }
+        }
+        condition_.notify_all();
+    }
+}
+
+void ImageContainerReader::acquire(int block)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    // All blocks before the requested one are dropped, after seeking backwards the decompression starts again
+    if (block < currentBlock_) {
+        decompressedBlocks_.clear();
+        failedBlocks_.clear();
+        nextBlockToDecompress_ = block;
+    }
+    currentBlock_ = block;
+    decompressedBlocks_.erase(decompressedBlocks_.begin(), decompressedBlocks_.lower_bound(block));
+    failedBlocks_.erase(failedBlocks_.begin(), failedBlocks_.lower_bound(block));
+    nextBlockToDecompress_ = std::max(nextBlockToDecompress_, block);
+    condition_.notify_all();
+
+    // Only the exception of the requested block is thrown, failed blocks after it do not stop the reading
+    condition_.wait(lock, [&]{ return decompressedBlocks_.count(block) or failedBlocks_.count(block); });
+    if (!decompressedBlocks_.count(block)) std::rethrow_exception(failedBlocks_[block]);
+
+    currentData_.swap(decompressedBlocks_[block]);
+    decompressedBlocks_.erase(block);
+}
+
+void ImageContainerReader::next(char *raw)
+{
+    if (currentImage_ >= header_.numberOfImages) throw std::runtime_error("ImageContainerReader: no more images.");
+
+    int block = currentImage_ / imagesPerBlock_;
+    if (block != currentBlock_ or currentData_.empty()) acquire(block);
+
+    const size_t imageSizeInBytes = header_.getImageSizeInBytes();
+    std::copy_n(&currentData_[(currentImage_ % imagesPerBlock_) * imageSizeInBytes], imageSizeInBytes, raw);
+    ++currentImage_;
+}
+
+void ImageContainerReader::seek(int image)
+{
+    if (image < 0 or image > header_.numberOfImages) throw std::runtime_error("ImageContainerReader: image index out of range.");
+    currentImage_ = image;
+}
+
+} // namespace pink
@@ -0,0 +1,158 @@
+/**
+ * @file   ImageProcessingLib/ImageContainer.h
+ * @brief  Block compressed container of images.
+ * @date   Oct 19, 2026
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ImageCodec.h"
+#include "ImageFileHeader.h"
+#include "ImageReader.h"
+
+namespace pink {
+
+/*
+ * Layout of an image container:
+ *
+ *   char[8] magic "PINKBLCK", int version, int codec, int imagesPerBlock, int numberOfBlocks,
+ *   int pixelType, float scale, float offset, int numberOfImages, int numberOfChannels, int height, int width,
+ *   int64 file offset of the block index,
+ *   the blocks,
+ *   the block index of int64 file offset and int64 compressed size per block.
+ *
+ * A block holds imagesPerBlock images, the last block may hold less.
+ * The blocks are compressed independently, they can be located by the index
+ * and decompressed in parallel.
+ */
+
+//! Return true if the file starts with the magic of an image container.
+bool isImageContainer(std::string const& filename);
+
+//! Write images block by block into a container.
+class ImageContainerWriter
+{
+public:
+
+    //! The number of images of the header is ignored, the images are counted by @add.
+    ImageContainerWriter(std::string const& filename, ImageFileHeader const& header, int imagesPerBlock = 64,
+        ImageCodec codec = ImageCodec::ZLIB, int level = 1);
+
+    //! Calls @close.
+    ~ImageContainerWriter();
+
+    //! Append images, the pixels are converted into the pixel type of the header (@narrowPixels).
+    void add(float const *images, int numberOfImages);
+
+    //! Write the last block and the block index.
+    void close();
+
+private:
+
+    //! Compress and write the current block.
+    void writeBlock();
+
+    std::ofstream os_;
+
+    ImageFileHeader header_;
+
+    int imagesPerBlock_;
+
+    ImageCodec codec_;
+
+    int level_;
+
+    //! Stored pixels of the images of the current block.
+    std::vector<char> block_;
+
+    int imagesInBlock_;
+
+    //! File offset and compressed size per block.
+    std::vector<int64_t> index_;
+
+};
+
+/**
+ * @brief Read images from a container.
+ *
+ * The blocks following the current one are decompressed in advance by a pool of threads.
+ * Seeking backwards restarts the decompression at the requested block.
+ */
+class ImageContainerReader : public ImageReader
+{
+public:
+
+    ImageContainerReader(std::string const& filename, int numberOfThreads = 0);
+
+    ~ImageContainerReader();
+
+    void next(char *raw);
+
+    void seek(int image);
+
+    ImageCodec getCodec() const { return codec_; }
+
+    int getImagesPerBlock() const { return imagesPerBlock_; }
+
+    int getNumberOfBlocks() const { return index_.size() / 2; }
+
+private:
+
+    //! Loop of the decompression threads.
+    void decompress();
+
+    //! Read and decompress one block.
+    void readBlock(int block, std::vector<char>& data) const;
+
+    //! Wait for a decompressed block and make it the current one.
+    void acquire(int block);
+
+    int fd_;
+
+    ImageCodec codec_;
+
+    int imagesPerBlock_;
+
+    //! File offset and compressed size per block.
+    std::vector<int64_t> index_;
+
+    std::vector<std::thread> threads_;
+
+    std::mutex mutex_;
+
+    std::condition_variable condition_;
+
+    //! Decompressed blocks not yet used.
+    std::map<int, std::vector<char>> decompressedBlocks_;
+
+    //! Exceptions of blocks failed in the decompression threads, rethrown by @next when the block is requested.
+    std::map<int, std::exception_ptr> failedBlocks_;
+
+    int nextBlockToDecompress_;
+
+    //! Number of blocks decompressed in advance.
+    int maxBlocksAhead_;
+
+    //! Block in currentData_, the decompression threads work ahead of it.
+    int currentBlock_;
+
+    std::vector<char> currentData_;
+
+    //! Index of the next image returned by @next.
+    int currentImage_;
+
+    bool stop_;
+
+};
+
+} // namespace pink
@@ -0,0 +1,127 @@
+/**
+ * @file   ImageProcessingLib/ImageFileHeader.cpp
+ * @brief  Header of the binary image file format.
+ * @date   Oct 19, 2026
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include "ImageFileHeader.h"
+#include "UtilitiesLib/HalfPrecision.h"
+
+namespace pink {
+
+namespace {
+
+//! First integer of the versioned header, the plain header starts with the number of images.
+const int versionMarker = -1;
+const int fileVersion = 2;
+
+template <class Pixel>
+void widen(float *dest, Pixel const *source, size_t size, float scale, float offset)
+{
+    for (size_t i = 0; i < size; ++i) dest[i] = source[i] * scale + offset;
+}
+
+template <class Pixel>
+void narrow(Pixel *dest, float const *source, size_t size, float scale, float offset)
+{
+    const float maxValue = std::numeric_limits<Pixel>::max();
+    for (size_t i = 0; i < size; ++i) {
+        float value = std::nearbyint((source[i] - offset) / scale);
+        dest[i] = static_cast<Pixel>(std::min(std::max(value, 0.0f), maxValue));
+    }
+}
+
+} // anonymous namespace
+
+ImageFileHeader readImageFileHeader(std::istream& is)
+{
+    // Skip all header lines starting with #
+    std::string line;
+    std::streampos last_position = is.tellg();
+    while (std::getline(is, line)) {
+        if (line[0] != '#') break;
+        last_position = is.tellg();
+    }
+    is.clear();
+    is.seekg(last_position, is.beg);
+
+    ImageFileHeader header;
+    is.read((char*)&header.numberOfImages, sizeof(int));
+
+    if (header.numberOfImages == versionMarker) {
+        int version, pixelType;
+        is.read((char*)&version, sizeof(int));
+        if (version != fileVersion) throw std::runtime_error("Unsupported image file version " + std::to_string(version));
+        is.read((char*)&pixelType, sizeof(int));
+        if (pixelType < static_cast<int>(PixelType::FLOAT32) or pixelType > static_cast<int>(PixelType::UINT8))
+            throw std::runtime_error("Unknown pixel type " + std::to_string(pixelType));
+        header.pixelType = static_cast<PixelType>(pixelType);
+        is.read((char*)&header.scale, sizeof(float));
+        is.read((char*)&header.offset, sizeof(float));
+        is.read((char*)&header.numberOfImages, sizeof(int));
+    }
+
+    is.read((char*)&header.numberOfChannels, sizeof(int));
+    is.read((char*)&header.height, sizeof(int));
+    is.read((char*)&header.width, sizeof(int));
+
+    if (!is) throw std::runtime_error("Error reading image file header");
+    return header;
+}
+
+void writeImageFileHeader(std::ostream& os, ImageFileHeader const& header)
+{
+    if (header.pixelType != PixelType::FLOAT32 or header.scale != 1.0f or header.offset != 0.0f) {
+        int pixelType = static_cast<int>(header.pixelType);
+        os.write((char*)&versionMarker, sizeof(int));
+        os.write((char*)&fileVersion, sizeof(int));
+        os.write((char*)&pixelType, sizeof(int));
+        os.write((char*)&header.scale, sizeof(float));
+        os.write((char*)&header.offset, sizeof(float));
+    }
+    os.write((char*)&header.numberOfImages, sizeof(int));
+    os.write((char*)&header.numberOfChannels, sizeof(int));
+    os.write((char*)&header.height, sizeof(int));
+    os.write((char*)&header.width, sizeof(int));
+}
+
+void widenPixels(float *dest, char const *source, size_t size, PixelType pixelType, float scale, float offset)
+{
+    if (pixelType == PixelType::UINT8) {
+        widen(dest, reinterpret_cast<uint8_t const*>(source), size, scale, offset);
+    } else if (pixelType == PixelType::UINT16) {
+        widen(dest, reinterpret_cast<uint16_t const*>(source), size, scale, offset);
+    } else if (pixelType == PixelType::FLOAT16) {
+        uint16_t const *bits = reinterpret_cast<uint16_t const*>(source);
+        for (size_t i = 0; i < size; ++i) dest[i] = float16BitsToFloat(bits[i]) * scale + offset;
+    } else {
+        // Elementwise, source and dest may be identical
+        widen(dest, reinterpret_cast<float const*>(source), size, scale, offset);
+    }
+}
+
+void narrowPixels(char *dest, float const *source, size_t size, PixelType pixelType, float scale, float offset)
+{
+    if (scale == 0.0f) throw std::runtime_error("narrowPixels: scale must not be zero.");
+
+    if (pixelType == PixelType::UINT8) {
+        narrow(reinterpret_cast<uint8_t*>(dest), source, size, scale, offset);
+    } else if (pixelType == PixelType::UINT16) {
+        narrow(reinterpret_cast<uint16_t*>(dest), source, size, scale, offset);
+    } else if (pixelType == PixelType::FLOAT16) {
+        uint16_t *bits = reinterpret_cast<uint16_t*>(dest);
+        for (size_t i = 0; i < size; ++i) bits[i] = floatToFloat16Bits((source[i] - offset) / scale);
+    } else {
+        float *values = reinterpret_cast<float*>(dest);
+        for (size_t i = 0; i < size; ++i) values[i] = (source[i] - offset) / scale;
+    }
+}
+
+} // namespace pink
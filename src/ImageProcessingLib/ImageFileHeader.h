@@ -0,0 +1,60 @@
+/**
+ * @file   ImageProcessingLib/ImageFileHeader.h
+ * @brief  Header of the binary image file format.
+ * @date   Oct 19, 2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+
+#include "PixelType.h"
+
+namespace pink {
+
+/**
+ * @brief Dimensions and pixel type of a binary image file.
+ *
+ * Files written by earlier versions start with the four integers
+ * numberOfImages, numberOfChannels, height, width followed by float pixels.
+ * The versioned header starts with the integer -1 and the version, followed by
+ * the pixel type, the float scale and offset and the four integers above.
+ * The pixel value is scale * stored + offset.
+ */
+struct ImageFileHeader
+{
+    ImageFileHeader(int numberOfImages = 0, int numberOfChannels = 0, int height = 0, int width = 0,
+        PixelType pixelType = PixelType::FLOAT32, float scale = 1.0f, float offset = 0.0f)
+     : numberOfImages(numberOfImages), numberOfChannels(numberOfChannels), height(height), width(width),
+       pixelType(pixelType), scale(scale), offset(offset)
+    {}
+
+    //! Number of pixels of one image including all channels.
+    size_t getImageSize() const { return static_cast<size_t>(numberOfChannels) * height * width; }
+
+    //! Number of stored bytes of one image including all channels.
+    size_t getImageSizeInBytes() const { return getImageSize() * pixelTypeSize(pixelType); }
+
+    int numberOfImages;
+    int numberOfChannels;
+    int height;
+    int width;
+    PixelType pixelType;
+    float scale;
+    float offset;
+};
+
+//! Skip the comment lines starting with # and read the plain or versioned header.
+ImageFileHeader readImageFileHeader(std::istream& is);
+
+//! Write the plain header for float pixels without scaling, otherwise the versioned header.
+void writeImageFileHeader(std::ostream& os, ImageFileHeader const& header);
+
+//! Convert stored pixels to float, dest = scale * stored + offset, float32 may be converted in place.
+void widenPixels(float *dest, char const *source, size_t size, PixelType pixelType, float scale, float offset);
+
+//! Convert float to stored pixels, integer types are rounded and clamped.
+void narrowPixels(char *dest, float const *source, size_t size, PixelType pixelType, float scale, float offset);
+
+} // namespace pink
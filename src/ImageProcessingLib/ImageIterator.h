@@ -6,16 +6,28 @@
 
 #pragma once
 
-#include <fstream>
+#include <algorithm>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
 #include "Image.h"
+#include "ImageReader.h"
 
 namespace pink {
 
-//! Read iteratively a binary image file
+/**
+ * @brief Read iteratively an image file
+ *
+ * The file format is detected by @createImageReader.
+ * Compact pixel types are widened to float when the image is read,
+ * the stored pixels of the current image remain available by @getRawPixel.
+ *
+ * The iterator can be restricted to the range [firstImage, firstImage + numberOfImages)
+ * of the file, e.g. to distribute one file over independent jobs.
+ * The image indices of @seek and @getIndex are relative to the range.
+ */
 template <class T>
 class ImageIterator
 {
@@ -28,36 +40,30 @@ public:
 
     //! Default constructor
     ImageIterator()
-     : numberOfImages_(0), numberOfChannels_(0), count_(0), height_(0), width_(0), ptrStream_(nullptr)
+     : begin_(0), end_(0), count_(0), ptrReader_(nullptr)
     {}
 
-    //! Parameter constructor
-    ImageIterator(std::string const& filename)
-     : numberOfImages_(0), numberOfChannels_(0), count_(0), height_(0), width_(0), ptrStream_(new std::ifstream(filename))
+    //! Parameter constructor, a negative numberOfImages selects all images from firstImage to the end of the file.
+    ImageIterator(std::string const& filename, int firstImage = 0, int numberOfImages = -1)
+     : ptrReader_(createImageReader(filename))
     {
-        if (!(*ptrStream_)) throw std::runtime_error("ImageIterator: Error opening " + filename);
-
-        // Skip all header lines starting with #
-        std::string line;
-        int last_position = ptrStream_->tellg();
-        while (std::getline(*ptrStream_, line)) {
-            if (line[0] != '#') break;
-        	last_position = ptrStream_->tellg();
-        }
+        header_ = ptrReader_->getHeader();
 
-        ptrStream_->seekg(last_position, ptrStream_->beg);
-        ptrStream_->read((char*)&numberOfImages_, sizeof(int));
-        ptrStream_->read((char*)&numberOfChannels_, sizeof(int));
-        ptrStream_->read((char*)&height_, sizeof(int));
-        ptrStream_->read((char*)&width_, sizeof(int));
+        if (firstImage < 0 or firstImage > header_.numberOfImages)
+            throw std::runtime_error("ImageIterator: first image " + std::to_string(firstImage)
+                + " is out of range, the file contains " + std::to_string(header_.numberOfImages) + " images.");
+        begin_ = firstImage;
+        end_ = numberOfImages < 0 ? header_.numberOfImages : std::min(firstImage + numberOfImages, header_.numberOfImages);
+        count_ = begin_;
 
+        if (begin_) ptrReader_->seek(begin_);
         next();
     }
 
     //! Equal comparison
     bool operator == (ImageIterator const& other) const
     {
-        return ptrStream_ == other.ptrStream_;
+        return ptrReader_ == other.ptrReader_;
     }
 
     //! Unequal comparison
@@ -76,7 +82,16 @@ public:
     //! Addition assignment operator
     ImageIterator& operator += (int step)
     {
-        ptrStream_->seekg((step - 1) * height_ * width_ * sizeof(float), ptrStream_->cur);
+        return seek(getIndex() + step);
+    }
+
+    //! Move to the image with the given index within the range, the end is reached for index >= getNumberOfImages().
+    ImageIterator& seek(int image)
+    {
+        if (!ptrReader_) throw std::runtime_error("ImageIterator: seek beyond the end.");
+        if (image < 0) throw std::runtime_error("ImageIterator: negative image index.");
+        count_ = begin_ + std::min(image, end_ - begin_);
+        ptrReader_->seek(count_);
         next();
         return *this;
     }
@@ -93,36 +108,69 @@ public:
         return &(operator*());
     }
 
-    //! Return number of images.
-    int getNumberOfImages() const { return numberOfImages_; }
+    //! Return number of images of the range.
+    int getNumberOfImages() const { return end_ - begin_; }
+
+    //! Return index of the current image within the range.
+    int getIndex() const { return count_ - 1 - begin_; }
+
+    //! Return index of the first image of the range in the file.
+    int getFirstImage() const { return begin_; }
 
     //! Return number of channels.
-    int getNumberOfChannels() const { return numberOfChannels_; }
+    int getNumberOfChannels() const { return header_.numberOfChannels; }
+
+    //! Return type of the stored pixels.
+    PixelType getPixelType() const { return header_.pixelType; }
+
+    //! Return scale of the stored pixels.
+    float getScale() const { return header_.scale; }
+
+    //! Return offset of the stored pixels.
+    float getOffset() const { return header_.offset; }
+
+    //! Return stored pixels of the current image, nullptr for float32.
+    char const* getRawPixel() const { return raw_.empty() ? nullptr : &raw_[0]; }
 
 private:
 
     //! Read next picture
     void next()
     {
-        if (count_ < numberOfImages_) {
-            ptrCurrentImage_ = std::make_shared<ImageType>(height_, width_, numberOfChannels_);
-            ptrStream_->read((char*)&ptrCurrentImage_->getPixel()[0], numberOfChannels_ * height_ * width_ * sizeof(float));
+        if (count_ < end_) {
+            ptrCurrentImage_ = std::make_shared<ImageType>(header_.height, header_.width, header_.numberOfChannels);
+            T *pixel = &ptrCurrentImage_->getPixel()[0];
+            if (header_.pixelType == PixelType::FLOAT32) {
+                ptrReader_->next((char*)pixel);
+                if (header_.scale != 1.0f or header_.offset != 0.0f)
+                    widenPixels(pixel, (char const*)pixel, header_.getImageSize(), header_.pixelType, header_.scale, header_.offset);
+            } else {
+                raw_.resize(header_.getImageSizeInBytes());
+                ptrReader_->next(&raw_[0]);
+                widenPixels(pixel, &raw_[0], header_.getImageSize(), header_.pixelType, header_.scale, header_.offset);
+            }
             ++count_;
         } else {
-            ptrStream_.reset();
+            ptrReader_.reset();
         }
     }
 
-    int numberOfImages_;
-    int numberOfChannels_;
+    ImageFileHeader header_;
+
+    //! Range of the image indices in the file.
+    int begin_;
+    int end_;
+
+    //! Index of the next image in the file.
     int count_;
-    int height_;
-    int width_;
 
-    std::shared_ptr<std::ifstream> ptrStream_;
+    std::shared_ptr<ImageReader> ptrReader_;
 
     PtrImage ptrCurrentImage_;
 
+    //! Stored pixels of the current image for compact pixel types.
+    std::vector<char> raw_;
+
 };
 
 } // namespace pink
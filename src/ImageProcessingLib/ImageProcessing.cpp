@@ -5,6 +5,7 @@
  * @author Bernd Doser, HITS gGmbH
  */
 
+#include <algorithm>
 #include <cmath>
 #include <fstream>
 #include <iostream>
@@ -14,7 +15,14 @@
 #include <stdexcept>
 #include <vector>
 
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define PINK_ROTATION_SIMD
+#endif
+
+#include "ImageFileHeader.h"
 #include "ImageProcessing.h"
+#include "ImageReader.h"
 #include "UtilitiesLib/Error.h"
 
 namespace pink {
@@ -46,51 +54,72 @@ void rotate_nearest_neighbor(int height, int width, float *source, float *dest,
     }
 }
 
-void rotate_bilinear(int height, int width, float *source, float *dest, float alpha)
-{
-    const float cosAlpha = cos(alpha);
-    const float sinAlpha = sin(alpha);
+namespace {
 
-    float x0 = (width-1) * 0.5;
-    float y0 = (height-1) * 0.5;
-    float x1, y1, rx1, ry1, cx1, cy1;
-    int ix1, iy1, ix1b, iy1b;
+//! Edge length of the square tiles of @rotate_90degrees, source and destination tile fit into L1.
+const int transposeTileSize = 32;
 
-    for (int x2 = 0; x2 < width; ++x2) {
-        for (int y2 = 0; y2 < height; ++y2) {
+#ifdef PINK_ROTATION_SIMD
+//! 4x4 block of @rotate_90degrees starting at source row x and column y.
+inline void rotate_90degrees_block(int height, int width, float const *source, float *dest, int x, int y)
+{
+    __m128 r0 = _mm_loadu_ps(source + x*height + y);
+    __m128 r1 = _mm_loadu_ps(source + (x+1)*height + y);
+    __m128 r2 = _mm_loadu_ps(source + (x+2)*height + y);
+    __m128 r3 = _mm_loadu_ps(source + (x+3)*height + y);
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _mm_storeu_ps(dest + (height-y-1)*width + x, r0);
+    _mm_storeu_ps(dest + (height-y-2)*width + x, r1);
+    _mm_storeu_ps(dest + (height-y-3)*width + x, r2);
+    _mm_storeu_ps(dest + (height-y-4)*width + x, r3);
+}
+#endif
 
-            x1 = ((float)x2 - x0) * cosAlpha + ((float)y2 - y0) * sinAlpha + x0;
-//            if (x1 < 0 or x1 >= width) {
-//                dest[x2*height + y2] = 0.0;
-//                continue;
-//            }
-            y1 = ((float)y2 - y0) * cosAlpha - ((float)x2 - x0) * sinAlpha + y0;
-//            if (y1 < 0 or y1 >= height) {
-//                dest[x2*height + y2] = 0.0;
-//                continue;
-//            }
-            ix1 = x1;
-            iy1 = y1;
-            ix1b = ix1 + 1;
-            iy1b = iy1 + 1;
-            rx1 = x1 - ix1;
-            ry1 = y1 - iy1;
-            cx1 = 1.0f - rx1;
-            cy1 = 1.0f - ry1;
-            dest[x2*height + y2] = cx1 * cy1 * source[ix1  * height + iy1 ]
-                                 + cx1 * ry1 * source[ix1  * height + iy1b]
-                                 + rx1 * cy1 * source[ix1b * height + iy1 ]
-                                 + rx1 * ry1 * source[ix1b * height + iy1b];
+void rotate_90degrees_channel(int height, int width, float const *source, float *dest)
+{
+    for (int x0 = 0; x0 < width; x0 += transposeTileSize) {
+        int x1 = std::min(x0 + transposeTileSize, width);
+        for (int y0 = 0; y0 < height; y0 += transposeTileSize) {
+            int y1 = std::min(y0 + transposeTileSize, height);
+            int x = x0;
+#ifdef PINK_ROTATION_SIMD
+            for (; x + 4 <= x1; x += 4) {
+                int y = y0;
+                for (; y + 4 <= y1; y += 4) rotate_90degrees_block(height, width, source, dest, x, y);
+                for (; y < y1; ++y) {
+                    for (int xx = x; xx < x + 4; ++xx) dest[(height-y-1)*width + xx] = source[xx*height + y];
+                }
+            }
+#endif
+            for (; x < x1; ++x) {
+                for (int y = y0; y < y1; ++y) dest[(height-y-1)*width + x] = source[x*height + y];
+            }
         }
     }
 }
 
-void rotate_90degrees(int height, int width, float *source, float *dest)
+//! Copy of one image row, inlined since the rows are too short for memcpy to pay off.
+inline void copyRow(float const *source, float *dest, int width)
 {
-    for (int x = 0; x < width; ++x) {
-        for (int y = 0; y < height; ++y) {
-            dest[(height-y-1)*width + x] = source[x*height + y];
-        }
+    int j = 0;
+#ifdef PINK_ROTATION_SIMD
+    for (; j + 8 <= width; j += 8) {
+        __m128 a = _mm_loadu_ps(source + j);
+        __m128 b = _mm_loadu_ps(source + j + 4);
+        _mm_storeu_ps(dest + j, a);
+        _mm_storeu_ps(dest + j + 4, b);
+    }
+#endif
+    for (; j < width; ++j) dest[j] = source[j];
+}
+
+} // anonymous namespace
+
+void rotate_90degrees(int height, int width, float const *source, float *dest, int numberOfChannels)
+{
+    const int size = height * width;
+    for (int c = 0; c < numberOfChannels; ++c) {
+        rotate_90degrees_channel(height, width, source + c*size, dest + c*size);
     }
 }
 
@@ -98,132 +127,399 @@ void rotate(int height, int width, float *source, float *dest, float alpha, Inte
 {
     if (interpolation == Interpolation::NEAREST_NEIGHBOR)
         rotate_nearest_neighbor(height, width, source, dest, alpha);
-    else if (interpolation == Interpolation::BILINEAR)
-        rotate_bilinear(height, width, source, dest, alpha);
-    else {
+    else if (interpolation == Interpolation::BILINEAR) {
+        // Without margins the rows of rotateAndCrop are the ones of the rotated image
+        const float cosAlpha = cos(alpha);
+        const float sinAlpha = sin(alpha);
+        for (int x2 = 0; x2 < width; ++x2)
+            rotateAndCropRow(height, width, height, width, source, dest + x2*height, x2, cosAlpha, sinAlpha, interpolation);
+    } else if (interpolation == Interpolation::SHEAR) {
+        rotateAndCrop(height, width, height, width, source, dest, alpha, interpolation);
+    } else {
         fatalError("rotateAndCrop: unknown interpolation\n");
     }
 }
 
-void flip(int height, int width, float *source, float *dest)
+void flip(int height, int width, float const *source, float *dest, int numberOfChannels)
 {
-    float *pdest = dest + (height-1) * width;
-    float *psource = source;
-
-    for (int i = 0; i < height; ++i) {
-        for (int j = 0; j < width; ++j) {
-            pdest[j] = psource[j];
+    const int size = height * width;
+    for (int c = 0; c < numberOfChannels; ++c) {
+        float const *psource = source + c*size;
+        float *pdest = dest + c*size + (height-1) * width;
+        for (int i = 0; i < height; ++i, psource += width, pdest -= width) {
+            copyRow(psource, pdest, width);
         }
-        pdest -= width;
-        psource += width;
     }
 }
 
-void crop(int height, int width, int height_new, int width_new, float * source, float *dest)
+void crop(int height, int width, int height_new, int width_new, float const *source, float *dest,
+    int numberOfChannels)
 {
     int width_margin = (width - width_new) / 2;
     int height_margin = (height - height_new) / 2;
 
-    for (int i = 0; i < height_new; ++i) {
-        for (int j = 0; j < width_new; ++j) {
-            dest[i*width_new+j] = source[(i+height_margin)*width + (j+width_margin)];
+    for (int c = 0; c < numberOfChannels; ++c) {
+        float const *psource = source + c*height*width + height_margin*width + width_margin;
+        float *pdest = dest + c*height_new*width_new;
+        for (int i = 0; i < height_new; ++i, psource += width, pdest += width_new) {
+            copyRow(psource, pdest, width_new);
         }
     }
 }
 
-void flipAndCrop(int height, int width, int height_new, int width_new, float *source, float *dest)
+void flipAndCrop(int height, int width, int height_new, int width_new, float const *source, float *dest,
+    int numberOfChannels)
 {
     int width_margin = (width - width_new) / 2;
     int height_margin = (height - height_new) / 2;
 
-    for (int i = 0, ri = height_new-1; i < height_new; ++i, --ri) {
-        for (int j = 0; j < width_new; ++j) {
-            dest[ri*width_new + j] = source[(i+height_margin)*width + (j+width_margin)];
+    for (int c = 0; c < numberOfChannels; ++c) {
+        float const *psource = source + c*height*width + height_margin*width + width_margin;
+        float *pdest = dest + c*height_new*width_new + (height_new-1)*width_new;
+        for (int i = 0; i < height_new; ++i, psource += width, pdest -= width_new) {
+            copyRow(psource, pdest, width_new);
         }
     }
 }
 
-void rotateAndCrop_nearest_neighbor(int height, int width, int height_new, int width_new, float *source, float *dest, float alpha)
+void rotateAndCropRow_nearest_neighbor(int height, int width, int height_new, int width_new, float const *source,
+    float *dest, int x2, float cosAlpha, float sinAlpha)
 {
     const int width_margin = (width - width_new) * 0.5;
     const int height_margin = (height - height_new) * 0.5;
 
-    const float cosAlpha = cos(alpha);
-    const float sinAlpha = sin(alpha);
-
     const float x0 = (width-1) * 0.5;
     const float y0 = (height-1) * 0.5;
     float x1, y1;
 
-    for (int x2 = 0; x2 < width_new; ++x2) {
-        for (int y2 = 0; y2 < height_new; ++y2) {
-            x1 = ((float)x2 + width_margin - x0) * cosAlpha + ((float)y2 + height_margin - y0) * sinAlpha + x0 + 0.1;
-            if (x1 < 0 or x1 >= width) {
-                dest[x2*height_new + y2] = 0.0f;
-                continue;
-            }
-            y1 = ((float)y2 + height_margin - y0) * cosAlpha - ((float)x2 + width_margin - x0) * sinAlpha + y0 + 0.1;
-            if (y1 < 0 or y1 >= height) {
-                dest[x2*height_new + y2] = 0.0f;
-                continue;
-            }
-            dest[x2*height_new + y2] = source[(int)x1*height + (int)y1];
+    for (int y2 = 0; y2 < height_new; ++y2) {
+        x1 = ((float)x2 + width_margin - x0) * cosAlpha + ((float)y2 + height_margin - y0) * sinAlpha + x0 + 0.1;
+        if (x1 < 0 or x1 >= width) {
+            dest[y2] = 0.0f;
+            continue;
+        }
+        y1 = ((float)y2 + height_margin - y0) * cosAlpha - ((float)x2 + width_margin - x0) * sinAlpha + y0 + 0.1;
+        if (y1 < 0 or y1 >= height) {
+            dest[y2] = 0.0f;
+            continue;
         }
+        dest[y2] = source[(int)x1*height + (int)y1];
     }
 }
 
-void rotateAndCrop_bilinear(int height, int width, int height_new, int width_new, float *source, float *dest, float alpha)
+namespace {
+
+/**
+ * Bilinear interpolation at (x1, y1). Pixels outside of the image are zero. Within the interior
+ * (all four neighbors inside) the arithmetic is the same as in the vectorized kernels.
+ */
+inline float bilinearZeroPadded(int height, int width, float const *source, float x1, float y1)
+{
+    if (x1 >= 0.0f and x1 < width - 1 and y1 >= 0.0f and y1 < height - 1) {
+        int ix1 = x1;
+        int iy1 = y1;
+        float rx1 = x1 - ix1;
+        float ry1 = y1 - iy1;
+        float cx1 = 1.0f - rx1;
+        float cy1 = 1.0f - ry1;
+        float const *p = source + ix1 * height + iy1;
+        return cx1 * cy1 * p[0] + cx1 * ry1 * p[1] + rx1 * cy1 * p[height] + rx1 * ry1 * p[height + 1];
+    }
+
+    int ix1 = std::floor(x1);
+    int iy1 = std::floor(y1);
+    float rx1 = x1 - ix1;
+    float ry1 = y1 - iy1;
+    float cx1 = 1.0f - rx1;
+    float cy1 = 1.0f - ry1;
+    auto pixel = [&](int ix, int iy) {
+        return ix >= 0 and ix < width and iy >= 0 and iy < height ? source[ix * height + iy] : 0.0f;
+    };
+    return cx1 * cy1 * pixel(ix1, iy1) + cx1 * ry1 * pixel(ix1, iy1 + 1)
+         + rx1 * cy1 * pixel(ix1 + 1, iy1) + rx1 * ry1 * pixel(ix1 + 1, iy1 + 1);
+}
+
+void rotateAndCropRow_bilinear_scalar(int height, int width, int height_new, int width_new, float const *source,
+    float *dest, int x2, float cosAlpha, float sinAlpha)
 {
     const int width_margin = (width - width_new) * 0.5;
     const int height_margin = (height - height_new) * 0.5;
 
-    const float cosAlpha = cos(alpha);
-    const float sinAlpha = sin(alpha);
+    const float x0 = (width-1) * 0.5;
+    const float y0 = (height-1) * 0.5;
+    const float tx = (float)x2 + width_margin - x0;
+
+    for (int y2 = 0; y2 < height_new; ++y2) {
+        float ty = (float)y2 + height_margin - y0;
+        float x1 = tx * cosAlpha + ty * sinAlpha + x0;
+        float y1 = ty * cosAlpha - tx * sinAlpha + y0;
+        dest[y2] = bilinearZeroPadded(height, width, source, x1, y1);
+    }
+}
+
+#ifdef PINK_ROTATION_SIMD
+
+/**
+ * Eight output pixels at once. If all four neighbors of all pixels are inside the image,
+ * the neighbors are gathered, otherwise the pixels are computed by the zero padded scalar path.
+ */
+__attribute__((target("avx2")))
+void rotateAndCropRow_bilinear_avx2(int height, int width, int height_new, int width_new, float const *source,
+    float *dest, int x2, float cosAlpha, float sinAlpha)
+{
+    const int width_margin = (width - width_new) * 0.5;
+    const int height_margin = (height - height_new) * 0.5;
 
     const float x0 = (width-1) * 0.5;
     const float y0 = (height-1) * 0.5;
-    float x1, y1, rx1, ry1, cx1, cy1;
-    int ix1, iy1, ix1b, iy1b;
-
-    for (int x2 = 0; x2 < width_new; ++x2) {
-        for (int y2 = 0; y2 < height_new; ++y2) {
-            x1 = ((float)x2 + width_margin - x0) * cosAlpha + ((float)y2 + height_margin - y0) * sinAlpha + x0;
-//            if (x1 < 0 or x1 >= width) {
-//                dest[x2*height_new + y2] = 0.0f;
-//                continue;
-//            }
-            y1 = ((float)y2 + height_margin - y0) * cosAlpha - ((float)x2 + width_margin - x0) * sinAlpha + y0;
-//            if (y1 < 0 or y1 >= height) {
-//                dest[x2*height_new + y2] = 0.0f;
-//                continue;
-//            }
-            ix1 = x1;
-            iy1 = y1;
-            ix1b = ix1 + 1;
-            iy1b = iy1 + 1;
-            rx1 = x1 - ix1;
-            ry1 = y1 - iy1;
-            cx1 = 1.0f - rx1;
-            cy1 = 1.0f - ry1;
-            dest[x2*height_new + y2] = cx1 * cy1 * source[ix1  * height + iy1 ]
-                                     + cx1 * ry1 * source[ix1  * height + iy1b]
-                                     + rx1 * cy1 * source[ix1b * height + iy1 ]
-                                     + rx1 * ry1 * source[ix1b * height + iy1b];
+    const float tx = (float)x2 + width_margin - x0;
+
+    const __m256 vcos = _mm256_set1_ps(cosAlpha);
+    const __m256 vsin = _mm256_set1_ps(sinAlpha);
+    const __m256 vx0 = _mm256_set1_ps(x0);
+    const __m256 vy0 = _mm256_set1_ps(y0);
+    const __m256 vtxcos = _mm256_set1_ps(tx * cosAlpha);
+    const __m256 vtxsin = _mm256_set1_ps(tx * sinAlpha);
+    const __m256 vmargin = _mm256_set1_ps(height_margin);
+    const __m256 vzero = _mm256_setzero_ps();
+    const __m256 vone = _mm256_set1_ps(1.0f);
+    const __m256 vxmax = _mm256_set1_ps(width - 1);
+    const __m256 vymax = _mm256_set1_ps(height - 1);
+    const __m256i vheight = _mm256_set1_epi32(height);
+    const __m256i vone_i = _mm256_set1_epi32(1);
+
+    int y2 = 0;
+    for (; y2 <= height_new - 8; y2 += 8) {
+        __m256 vy2 = _mm256_cvtepi32_ps(_mm256_add_epi32(_mm256_set1_epi32(y2), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)));
+        __m256 ty = _mm256_sub_ps(_mm256_add_ps(vy2, vmargin), vy0);
+        __m256 x1 = _mm256_add_ps(_mm256_add_ps(vtxcos, _mm256_mul_ps(ty, vsin)), vx0);
+        __m256 y1 = _mm256_add_ps(_mm256_sub_ps(_mm256_mul_ps(ty, vcos), vtxsin), vy0);
+
+        __m256 inside = _mm256_and_ps(
+            _mm256_and_ps(_mm256_cmp_ps(x1, vzero, _CMP_GE_OQ), _mm256_cmp_ps(x1, vxmax, _CMP_LT_OQ)),
+            _mm256_and_ps(_mm256_cmp_ps(y1, vzero, _CMP_GE_OQ), _mm256_cmp_ps(y1, vymax, _CMP_LT_OQ)));
+
+        if (_mm256_movemask_ps(inside) != 0xff) {
+            float px[8], py[8];
+            _mm256_storeu_ps(px, x1);
+            _mm256_storeu_ps(py, y1);
+            for (int l = 0; l < 8; ++l) dest[y2 + l] = bilinearZeroPadded(height, width, source, px[l], py[l]);
+            continue;
         }
+
+        __m256i ix1 = _mm256_cvttps_epi32(x1);
+        __m256i iy1 = _mm256_cvttps_epi32(y1);
+        __m256 rx1 = _mm256_sub_ps(x1, _mm256_cvtepi32_ps(ix1));
+        __m256 ry1 = _mm256_sub_ps(y1, _mm256_cvtepi32_ps(iy1));
+        __m256 cx1 = _mm256_sub_ps(vone, rx1);
+        __m256 cy1 = _mm256_sub_ps(vone, ry1);
+
+        __m256i index = _mm256_add_epi32(_mm256_mullo_epi32(ix1, vheight), iy1);
+        __m256i indexb = _mm256_add_epi32(index, vheight);
+        __m256 s00 = _mm256_i32gather_ps(source, index, 4);
+        __m256 s01 = _mm256_i32gather_ps(source, _mm256_add_epi32(index, vone_i), 4);
+        __m256 s10 = _mm256_i32gather_ps(source, indexb, 4);
+        __m256 s11 = _mm256_i32gather_ps(source, _mm256_add_epi32(indexb, vone_i), 4);
+
+        __m256 result = _mm256_mul_ps(_mm256_mul_ps(cx1, cy1), s00);
+        result = _mm256_add_ps(result, _mm256_mul_ps(_mm256_mul_ps(cx1, ry1), s01));
+        result = _mm256_add_ps(result, _mm256_mul_ps(_mm256_mul_ps(rx1, cy1), s10));
+        result = _mm256_add_ps(result, _mm256_mul_ps(_mm256_mul_ps(rx1, ry1), s11));
+        _mm256_storeu_ps(dest + y2, result);
+    }
+
+    for (; y2 < height_new; ++y2) {
+        float ty = (float)y2 + height_margin - y0;
+        dest[y2] = bilinearZeroPadded(height, width, source, tx * cosAlpha + ty * sinAlpha + x0, ty * cosAlpha - tx * sinAlpha + y0);
     }
 }
 
-void rotateAndCrop(int height, int width, int height_new, int width_new, float *source, float *dest, float alpha, Interpolation interpolation)
+const bool hasAVX2 = __builtin_cpu_supports("avx2");
+
+#endif
+
+} // anonymous namespace
+
+void rotateAndCropRow_bilinear(int height, int width, int height_new, int width_new, float const *source,
+    float *dest, int x2, float cosAlpha, float sinAlpha)
+{
+#ifdef PINK_ROTATION_SIMD
+    if (hasAVX2) return rotateAndCropRow_bilinear_avx2(height, width, height_new, width_new, source, dest, x2, cosAlpha, sinAlpha);
+#endif
+    rotateAndCropRow_bilinear_scalar(height, width, height_new, width_new, source, dest, x2, cosAlpha, sinAlpha);
+}
+
+namespace {
+
+/**
+ * @brief Linear interpolation of a shifted row: dest[j] = source(j + shift) for j < n_dest.
+ *
+ * Pixels outside of [0, n_source) are zero. The shift is constant along the row,
+ * therefore the inner loop streams through contiguous memory with constant weights.
+ */
+void shiftRow(float const *source, int n_source, float *dest, int n_dest, float shift)
+{
+    const float floorShift = std::floor(shift);
+    const int k = floorShift;
+    const float f = shift - floorShift;
+    const float g = 1.0f - f;
+
+    auto sample = [&](int j) {
+        int i = j + k;
+        float value = 0.0f;
+        if (i >= 0 and i < n_source) value += g * source[i];
+        if (i + 1 >= 0 and i + 1 < n_source) value += f * source[i + 1];
+        return value;
+    };
+
+    // Range where both neighbors are within the source row
+    const int jBegin = std::min(std::max(-k, 0), n_dest);
+    const int jEnd = std::min(std::max(n_source - 1 - k, jBegin), n_dest);
+
+    for (int j = 0; j < jBegin; ++j) dest[j] = sample(j);
+    for (int j = jBegin; j < jEnd; ++j) dest[j] = g * source[j + k] + f * source[j + k + 1];
+    for (int j = jEnd; j < n_dest; ++j) dest[j] = sample(j);
+}
+
+/**
+ * @brief Rotation by three shears (Paeth) of the rectangle with rows [xBegin, xBegin + nx)
+ * and columns [yBegin, yBegin + ny), |alpha| must not exceed 45 degrees.
+ *
+ * The source position of a destination pixel is M(alpha) = B(b) A(a) B(b) with
+ * the row shear B(b) = [[1, 0], [b, 1]], the column shear A(a) = [[1, a], [0, 1]],
+ * a = sin(alpha) and b = -tan(alpha/2).
+ */
+void shearRectangle(int height, int width, float const *source, float *dest,
+    int xBegin, int yBegin, int nx, int ny, float alpha)
+{
+    const float x0 = (width-1) * 0.5;
+    const float y0 = (height-1) * 0.5;
+    const float a = std::sin(alpha);
+    const float b = -std::tan(0.5f * alpha);
+
+    // Columns [yLo, yLo + n2) needed by the last row shear
+    const float bx0 = b * (xBegin - x0);
+    const float bx1 = b * (xBegin + nx - 1 - x0);
+    const int yLo = std::floor(yBegin + std::min(bx0, bx1));
+    const int n2 = static_cast<int>(std::floor(yBegin + ny - 1 + std::max(bx0, bx1))) + 2 - yLo;
+    // Integer and fractional row offsets of the column shear
+    std::vector<int> k(n2);
+    std::vector<float> f(n2), g(n2);
+    for (int j = 0; j < n2; ++j) {
+        float pos = a * (yLo + j - y0);
+        float floorPos = std::floor(pos);
+        k[j] = floorPos;
+        f[j] = pos - floorPos;
+        g[j] = 1.0f - f[j];
+    }
+    const int kMin = *std::min_element(k.begin(), k.end());
+    const int kMax = *std::max_element(k.begin(), k.end());
+
+    // Rows [xLo, xLo + n1) needed by the column shear
+    const int xLo = xBegin + kMin;
+    const int n1 = nx + kMax - kMin + 1;
+
+    // Offset of the upper neighbor of column j relative to row x - xLo of the sheared image
+    std::vector<int> offset(n2);
+    for (int j = 0; j < n2; ++j) offset[j] = (k[j] - kMin) * n2 + j;
+
+    std::vector<float> zeros(height, 0.0f), sheared(n1 * n2), columnSheared(n2);
+
+    // First row shear
+    for (int i = 0; i < n1; ++i) {
+        int x = xLo + i;
+        float const *row = x >= 0 and x < width ? source + x * height : &zeros[0];
+        shiftRow(row, height, &sheared[i * n2], n2, yLo + b * (x - x0));
+    }
+
+    for (int x2 = 0; x2 < nx; ++x2) {
+        // Column shear
+        float const *base = &sheared[x2 * n2];
+        for (int j = 0; j < n2; ++j) columnSheared[j] = g[j] * base[offset[j]] + f[j] * base[offset[j] + n2];
+
+        // Second row shear
+        shiftRow(&columnSheared[0], n2, dest + x2 * ny, ny, yBegin - yLo + b * (x2 + xBegin - x0));
+    }
+}
+
+/**
+ * @brief Shear based @rotateAndCrop.
+ *
+ * The angle is reduced to at most 45 degrees by quarter turns, which are applied exactly
+ * to the cropped result. This requires square images.
+ */
+void rotateAndCrop_shear(int height, int width, int height_new, int width_new, float const *source,
+    float *dest, float alpha)
+{
+    const float halfPi = 0.5 * M_PI;
+    int quarterTurns = std::lround(alpha / halfPi);
+    alpha -= quarterTurns * halfPi;
+    quarterTurns = ((quarterTurns % 4) + 4) % 4;
+
+    int xBegin = (width - width_new) * 0.5;
+    int yBegin = (height - height_new) * 0.5;
+    int nx = width_new;
+    int ny = height_new;
+
+    if (quarterTurns == 0) {
+        shearRectangle(height, width, source, dest, xBegin, yBegin, nx, ny, alpha);
+        return;
+    }
+    if (height != width) fatalError("rotateAndCrop: shear rotation beyond 45 degrees needs square images");
+
+    // Rectangle, which becomes the cropped region after the quarter turns
+    for (int q = 0; q < quarterTurns; ++q) {
+        int xBeginTurned = yBegin;
+        yBegin = width - xBegin - nx;
+        xBegin = xBeginTurned;
+        std::swap(nx, ny);
+    }
+
+    // A half turn reverses the pixel order
+    std::vector<float> sheared(nx * ny);
+    shearRectangle(height, width, source, &sheared[0], xBegin, yBegin, nx, ny, alpha);
+    if (quarterTurns == 2) {
+        std::reverse_copy(sheared.begin(), sheared.end(), dest);
+    } else {
+        rotate_90degrees(ny, nx, &sheared[0], dest);
+        if (quarterTurns == 3) std::reverse(dest, dest + nx * ny);
+    }
+}
+
+} // anonymous namespace
+
+void rotateAndCropRow(int height, int width, int height_new, int width_new, float const *source, float *dest,
+    int x2, float cosAlpha, float sinAlpha, Interpolation interpolation)
 {
     if (interpolation == Interpolation::NEAREST_NEIGHBOR)
-        rotateAndCrop_nearest_neighbor(height, width, height_new, width_new, source, dest, alpha);
+        rotateAndCropRow_nearest_neighbor(height, width, height_new, width_new, source, dest, x2, cosAlpha, sinAlpha);
     else if (interpolation == Interpolation::BILINEAR)
-        rotateAndCrop_bilinear(height, width, height_new, width_new, source, dest, alpha);
+        rotateAndCropRow_bilinear(height, width, height_new, width_new, source, dest, x2, cosAlpha, sinAlpha);
+    else if (interpolation == Interpolation::SHEAR)
+        fatalError("rotateAndCropRow: shear rotation needs the full image, use rotateAndCrop");
     else {
         fatalError("rotateAndCrop: unknown interpolation");
     }
 }
 
+void rotateAndCrop(int height, int width, int height_new, int width_new, float *source, float *dest, float alpha, Interpolation interpolation)
+{
+    const float cosAlpha = cos(alpha);
+    const float sinAlpha = sin(alpha);
+
+    if (interpolation == Interpolation::NEAREST_NEIGHBOR) {
+        for (int x2 = 0; x2 < width_new; ++x2)
+            rotateAndCropRow_nearest_neighbor(height, width, height_new, width_new, source, dest + x2*height_new, x2, cosAlpha, sinAlpha);
+    } else if (interpolation == Interpolation::BILINEAR) {
+        for (int x2 = 0; x2 < width_new; ++x2)
+            rotateAndCropRow_bilinear(height, width, height_new, width_new, source, dest + x2*height_new, x2, cosAlpha, sinAlpha);
+    } else if (interpolation == Interpolation::SHEAR) {
+        rotateAndCrop_shear(height, width, height_new, width_new, source, dest, alpha);
+    } else {
+        fatalError("rotateAndCrop: unknown interpolation");
+    }
+}
+
 float calculateEuclideanDistance(float *a, float *b, int length)
 {
     return sqrt(calculateEuclideanDistanceWithoutSquareRoot(a,b,length));
@@ -284,6 +580,45 @@ void zeroValuesSmallerThanStdDeviation(float *a, int length, float safety)
     }
 }
 
+PrincipalAxis calculatePrincipalAxis(float *image, int dim, int numberOfChannels)
+{
+    double m = 0.0, mx = 0.0, my = 0.0;
+    for (int c = 0; c < numberOfChannels; ++c) {
+        float *p = image + c * dim * dim;
+        for (int x = 0; x < dim; ++x) {
+            for (int y = 0; y < dim; ++y, ++p) {
+                if (*p <= 0.0f) continue;
+                m += *p;
+                mx += *p * x;
+                my += *p * y;
+            }
+        }
+    }
+
+    PrincipalAxis result = {0.0f, 0.0f};
+    if (m <= 0.0) return result;
+    mx /= m;
+    my /= m;
+
+    double mxx = 0.0, myy = 0.0, mxy = 0.0;
+    for (int c = 0; c < numberOfChannels; ++c) {
+        float *p = image + c * dim * dim;
+        for (int x = 0; x < dim; ++x) {
+            for (int y = 0; y < dim; ++y, ++p) {
+                if (*p <= 0.0f) continue;
+                mxx += *p * (x - mx) * (x - mx);
+                myy += *p * (y - my) * (y - my);
+                mxy += *p * (x - mx) * (y - my);
+            }
+        }
+    }
+
+    if (mxx + myy <= 0.0) return result;
+    result.angle = 0.5 * std::atan2(2.0 * mxy, mxx - myy);
+    result.anisotropy = std::sqrt((mxx - myy) * (mxx - myy) + 4.0 * mxy * mxy) / (mxx + myy);
+    return result;
+}
+
 void printImage(float *image, int height, int width)
 {
     for (int j = 0; j < height; ++j) {
@@ -296,32 +631,34 @@ void printImage(float *image, int height, int width)
 }
 
 void writeImagesToBinaryFile(std::vector<float> const& images, int numberOfImages, int numberOfChannels,
-    int height, int width, std::string const& filename)
+    int height, int width, std::string const& filename, PixelType pixelType, float scale, float offset)
 {
     std::ofstream os(filename);
     if (!os) throw std::runtime_error("Error opening " + filename);
 
-    os.write((char*)&numberOfImages, sizeof(int));
-    os.write((char*)&numberOfChannels, sizeof(int));
-    os.write((char*)&height, sizeof(int));
-    os.write((char*)&width, sizeof(int));
-    os.write((char*)&images[0], numberOfImages * numberOfChannels * height * width * sizeof(float));
+    ImageFileHeader header(numberOfImages, numberOfChannels, height, width, pixelType, scale, offset);
+    writeImageFileHeader(os, header);
+
+    std::vector<char> raw(numberOfImages * header.getImageSizeInBytes());
+    narrowPixels(&raw[0], &images[0], numberOfImages * header.getImageSize(), pixelType, scale, offset);
+    os.write(&raw[0], raw.size());
 }
 
 void readImagesFromBinaryFile(std::vector<float> &images, int &numberOfImages, int &numberOfChannels,
     int &height, int &width, std::string const& filename)
 {
-    std::ifstream is(filename);
-    if (!is) throw std::runtime_error("Error opening " + filename);
-
-    is.read((char*)&numberOfImages, sizeof(int));
-    is.read((char*)&numberOfChannels, sizeof(int));
-    is.read((char*)&height, sizeof(int));
-    is.read((char*)&width, sizeof(int));
-
-    int size = numberOfImages * numberOfChannels * height * width;
-    images.resize(size);
-    is.read((char*)&images[0], size * sizeof(float));
+    std::shared_ptr<ImageReader> ptrReader = createImageReader(filename);
+    ImageFileHeader const& header = ptrReader->getHeader();
+    numberOfImages = header.numberOfImages;
+    numberOfChannels = header.numberOfChannels;
+    height = header.height;
+    width = header.width;
+
+    std::vector<char> raw(numberOfImages * header.getImageSizeInBytes());
+    for (int i = 0; i < numberOfImages; ++i) ptrReader->next(&raw[i * header.getImageSizeInBytes()]);
+
+    images.resize(numberOfImages * header.getImageSize());
+    widenPixels(&images[0], &raw[0], images.size(), header.pixelType, header.scale, header.offset);
 }
 
 void writeRotatedImages(float* images, int image_dim, int numberOfImages, std::string const& filename)
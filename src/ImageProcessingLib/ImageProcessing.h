@@ -11,6 +11,7 @@
 #include <vector>
 
 #include "Interpolation.h"
+#include "PixelType.h"
 
 namespace pink {
 
@@ -34,25 +35,30 @@ void rotate(int height, int width, float *source, float *dest, float alpha,
 
 /**
  * @brief Special rotation of 90 degrees clockwise.
+ *
+ * The transposition is done in cache-sized tiles of 4x4 SIMD blocks.
+ * The channels are stored one after another.
  */
-void rotate_90degrees(int height, int width, float *source, float *dest);
+void rotate_90degrees(int height, int width, float const *source, float *dest, int numberOfChannels = 1);
 
 /**
  * @brief Plain-C function for image mirroring.
  */
-void flip(int height, int width, float * source, float *dest);
+void flip(int height, int width, float const *source, float *dest, int numberOfChannels = 1);
 
 /**
  * @brief Plain-C function for cropping an image.
  */
-void crop(int height, int width, int height_new, int width_new, float * source, float *dest);
+void crop(int height, int width, int height_new, int width_new, float const *source, float *dest,
+    int numberOfChannels = 1);
 
 /**
  * @brief Plain-C function for flipping and cropping an image.
  *
  * The combined execution is more efficient.
  */
-void flipAndCrop(int height, int width, int height_new, int width_new, float *source, float *dest);
+void flipAndCrop(int height, int width, int height_new, int width_new, float const *source, float *dest,
+    int numberOfChannels = 1);
 
 /**
  * @brief Plain-C function for rotating and cropping an image.
@@ -62,6 +68,15 @@ void flipAndCrop(int height, int width, int height_new, int width_new, float *so
 void rotateAndCrop(int height, int width, int height_new, int width_new, float *source,
     float *dest, float alpha, Interpolation interpolation = Interpolation::BILINEAR);
 
+/**
+ * @brief Row x2 of @rotateAndCrop, used to sample rotated images on the fly.
+ *
+ * The height_new pixels written to dest are identical to dest[x2 * height_new + y2] of @rotateAndCrop
+ * with cosAlpha = cos(alpha) and sinAlpha = sin(alpha) evaluated in float.
+ */
+void rotateAndCropRow(int height, int width, int height_new, int width_new, float const *source, float *dest,
+    int x2, float cosAlpha, float sinAlpha, Interpolation interpolation = Interpolation::BILINEAR);
+
 /**
  * @brief Euclidean distance of two float arrays.
  *
@@ -105,12 +120,34 @@ float stdDeviation(float *a, int length);
  */
 void zeroValuesSmallerThanStdDeviation(float *a, int length, float safety);
 
+//! Orientation of an image given by the second moments of the pixel values.
+struct PrincipalAxis
+{
+    //! Angle in radians within (-pi/2, pi/2], same orientation as the rotation angle of @rotate.
+    float angle;
+
+    //! Normalized difference of the eigenvalues, 0 for isotropic and 1 for line shaped images.
+    float anisotropy;
+};
+
+/**
+ * @brief Principal axis of an image using the second moments of the pixel values.
+ *
+ * All channels are summed up, negative pixel values are ignored.
+ * The principal axis of a rotated image (@rotate with angle alpha)
+ * is the one of the original image plus alpha. Flipping (@flip) negates the angle.
+ */
+PrincipalAxis calculatePrincipalAxis(float *image, int dim, int numberOfChannels = 1);
+
 //! For debugging: printing images on stdout.
 void printImage(float *image, int height, int width);
 
+//! Write images, compact pixel types store (value - offset) / scale rounded and clamped for integers.
 void writeImagesToBinaryFile(std::vector<float> const& images, int numberOfImages, int numberOfChannels,
-    int height, int width, std::string const& filename);
+    int height, int width, std::string const& filename, PixelType pixelType = PixelType::FLOAT32,
+    float scale = 1.0f, float offset = 0.0f);
 
+//! Read images of all pixel types widened to float.
 void readImagesFromBinaryFile(std::vector<float> &images, int &numberOfImages, int &numberOfChannels,
     int &height, int &width, std::string const& filename);
 
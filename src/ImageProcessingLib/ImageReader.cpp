@@ -0,0 +1,44 @@
+/**
+ * @file   ImageProcessingLib/ImageReader.cpp
+ * @brief  Sequential access to the stored pixels of an image file.
+ * @date   Oct 19, 2026
+ */
+
+#include <stdexcept>
+
+#include "FitsImageReader.h"
+#include "ImageContainer.h"
+#include "ImageReader.h"
+#include "NpyImageReader.h"
+
+namespace pink {
+
+BinaryImageReader::BinaryImageReader(std::string const& filename)
+ : is_(filename)
+{
+    if (!is_) throw std::runtime_error("ImageReader: Error opening " + filename);
+    header_ = readImageFileHeader(is_);
+    dataOffset_ = is_.tellg();
+}
+
+void BinaryImageReader::next(char *raw)
+{
+    is_.read(raw, header_.getImageSizeInBytes());
+}
+
+void BinaryImageReader::seek(int image)
+{
+    if (image < 0 or image > header_.numberOfImages) throw std::runtime_error("ImageReader: image index out of range.");
+    is_.clear();
+    is_.seekg(dataOffset_ + static_cast<std::streamoff>(image) * header_.getImageSizeInBytes());
+}
+
+std::shared_ptr<ImageReader> createImageReader(std::string const& filename, int numberOfThreads)
+{
+    if (isImageContainer(filename)) return std::make_shared<ImageContainerReader>(filename, numberOfThreads);
+    if (isNpyFile(filename)) return std::make_shared<NpyImageReader>(filename);
+    if (isFitsFile(filename)) return std::make_shared<FitsImageReader>(filename);
+    return std::make_shared<BinaryImageReader>(filename);
+}
+
+} // namespace pink
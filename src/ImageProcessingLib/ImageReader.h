@@ -0,0 +1,74 @@
+/**
+ * @file   ImageProcessingLib/ImageReader.h
+ * @brief  Sequential access to the stored pixels of an image file.
+ * @date   Oct 19, 2026
+ */
+
+#pragma once
+
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include "ImageFileHeader.h"
+
+namespace pink {
+
+/**
+ * @brief Base class of the readers of the supported image file formats.
+ *
+ * The images are returned in the stored pixel type (@ImageFileHeader),
+ * all channels of one image are contiguous.
+ */
+class ImageReader
+{
+public:
+
+    virtual ~ImageReader() {}
+
+    ImageFileHeader const& getHeader() const { return header_; }
+
+    //! Read the stored pixels of the next image, header.getImageSizeInBytes() bytes.
+    virtual void next(char *raw) = 0;
+
+    //! Continue reading at the image with the given index, numberOfImages is the end of the file.
+    virtual void seek(int image) = 0;
+
+protected:
+
+    ImageFileHeader header_;
+
+};
+
+//! Reader of the binary image file format.
+class BinaryImageReader : public ImageReader
+{
+public:
+
+    BinaryImageReader(std::string const& filename);
+
+    void next(char *raw);
+
+    void seek(int image);
+
+private:
+
+    std::ifstream is_;
+
+    //! File position of the first image.
+    std::streamoff dataOffset_;
+
+};
+
+/**
+ * @brief Open the reader fitting to the file format.
+ *
+ * The format is detected by the magic at the start of the file:
+ * image container, NumPy .npy or .npz (@NpyImageReader), FITS (@FitsImageReader),
+ * otherwise the binary image format. A directory is read as directory of FITS files.
+ * Blocks of image containers (@ImageContainerReader) are decompressed
+ * by numberOfThreads threads, zero selects the number by the hardware.
+ */
+std::shared_ptr<ImageReader> createImageReader(std::string const& filename, int numberOfThreads = 0);
+
+} // namespace pink
@@ -15,13 +15,15 @@ namespace pink {
 enum class Interpolation
 {
     NEAREST_NEIGHBOR,  //!< Refuse values behind the comma.
-    BILINEAR           //!< Interpolate value by distance to pixels.
+    BILINEAR,          //!< Interpolate value by distance to pixels.
+    SHEAR              //!< Three linear interpolated shears, only for whole images (@rotateAndCrop).
 };
 
 inline std::ostream& operator << (std::ostream& os, Interpolation interpolation)
 {
     if (interpolation == Interpolation::NEAREST_NEIGHBOR) os << "nearest_neighbor";
     else if (interpolation == Interpolation::BILINEAR) os << "bilinear";
+    else if (interpolation == Interpolation::SHEAR) os << "shear";
     else os << "undefined";
     return os;
 }
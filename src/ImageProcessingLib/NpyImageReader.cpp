@@ -0,0 +1,169 @@
+/**
+ * @file   ImageProcessingLib/NpyImageReader.cpp
+ * @brief  Read images directly from NumPy .npy and .npz files.
+ * @date   Oct 19, 2026
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#include "NpyImageReader.h"
+
+namespace pink {
+
+namespace {
+
+const char npyMagic[6] = {'\x93', 'N', 'U', 'M', 'P', 'Y'};
+const char zipMagic[4] = {'P', 'K', '\x03', '\x04'};
+
+//! Size of the zip local file header without file name and extra field.
+const size_t zipHeaderSize = 30;
+
+uint16_t readUInt16(char const *p)
+{
+    return static_cast<uint8_t>(p[0]) | static_cast<uint8_t>(p[1]) << 8;
+}
+
+uint32_t readUInt32(char const *p)
+{
+    return readUInt16(p) | static_cast<uint32_t>(readUInt16(p + 2)) << 16;
+}
+
+//! Return the value of key in the python dictionary of the .npy header, e.g. 'descr': '<f4'.
+std::string dictValue(std::string const& dict, std::string const& key, std::string const& filename)
+{
+    size_t pos = dict.find("'" + key + "'");
+    if (pos == std::string::npos) throw std::runtime_error("NpyImageReader: " + key + " missing in header of " + filename);
+    pos = dict.find(':', pos);
+    size_t begin = dict.find_first_not_of(' ', pos + 1);
+    size_t end = dict[begin] == '(' ? dict.find(')', begin) + 1 : dict.find_first_of(",}", begin);
+    return dict.substr(begin, end - begin);
+}
+
+} // anonymous namespace
+
+bool isNpyFile(std::string const& filename)
+{
+    std::ifstream is(filename, std::ios::binary);
+    char magic[sizeof(npyMagic)];
+    is.read(magic, sizeof(magic));
+    return is and (std::equal(npyMagic, npyMagic + sizeof(npyMagic), magic)
+        or std::equal(zipMagic, zipMagic + sizeof(zipMagic), magic));
+}
+
+NpyImageReader::NpyImageReader(std::string const& filename)
+ : map_(nullptr),
+   mapSize_(0),
+   data_(nullptr),
+   currentImage_(0)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("NpyImageReader: Error opening " + filename);
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 or st.st_size < static_cast<off_t>(zipHeaderSize)) {
+        ::close(fd);
+        throw std::runtime_error("NpyImageReader: " + filename + " is too short.");
+    }
+    mapSize_ = st.st_size;
+
+    void *map = mmap(nullptr, mapSize_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) throw std::runtime_error("NpyImageReader: mmap of " + filename + " failed.");
+    map_ = static_cast<char*>(map);
+    madvise(map_, mapSize_, MADV_SEQUENTIAL);
+
+    try {
+        if (std::equal(zipMagic, zipMagic + sizeof(zipMagic), map_)) {
+            // First member of the archive, only stored members can be mapped
+            if (readUInt16(map_ + 8) != 0)
+                throw std::runtime_error("NpyImageReader: compressed arrays in " + filename
+                    + " are not supported, please use numpy.savez instead of numpy.savez_compressed.");
+            parseHeader(zipHeaderSize + readUInt16(map_ + 26) + readUInt16(map_ + 28), filename);
+        } else {
+            parseHeader(0, filename);
+        }
+    } catch (...) {
+        munmap(map_, mapSize_);
+        throw;
+    }
+}
+
+NpyImageReader::~NpyImageReader()
+{
+    munmap(map_, mapSize_);
+}
+
+void NpyImageReader::parseHeader(size_t offset, std::string const& filename)
+{
+    char const *p = map_ + offset;
+    if (offset + 10 > mapSize_ or !std::equal(npyMagic, npyMagic + sizeof(npyMagic), p))
+        throw std::runtime_error("NpyImageReader: " + filename + " is not a .npy file.");
+
+    // Version 1.0 has a 2 byte header length, version 2.0 and 3.0 a 4 byte one
+    int majorVersion = static_cast<uint8_t>(p[6]);
+    size_t headerLength = majorVersion == 1 ? readUInt16(p + 8) : readUInt32(p + 8);
+    size_t dataOffset = offset + (majorVersion == 1 ? 10 : 12) + headerLength;
+    if (dataOffset > mapSize_) throw std::runtime_error("NpyImageReader: header of " + filename + " is truncated.");
+
+    std::string dict(p + (majorVersion == 1 ? 10 : 12), headerLength);
+
+    if (dictValue(dict, "fortran_order", filename) != "False")
+        throw std::runtime_error("NpyImageReader: Fortran order of " + filename
+            + " is not supported, please store the array with numpy.ascontiguousarray.");
+
+    std::string descr = dictValue(dict, "descr", filename);
+    if (descr == "'<f4'") header_.pixelType = PixelType::FLOAT32;
+    else if (descr == "'<f2'") header_.pixelType = PixelType::FLOAT16;
+    else if (descr == "'<u2'") header_.pixelType = PixelType::UINT16;
+    else if (descr == "'|u1'" or descr == "'<u1'") header_.pixelType = PixelType::UINT8;
+    else throw std::runtime_error("NpyImageReader: dtype " + descr + " of " + filename
+        + " is not supported, only float32, float16, uint16 and uint8 in little endian.");
+
+    // Shape (N, C, H, W) or (N, H, W)
+    std::string shape = dictValue(dict, "shape", filename);
+    std::vector<long> dims;
+    for (size_t pos = shape.find_first_of("0123456789"); pos != std::string::npos;
+         pos = shape.find_first_of("0123456789", shape.find_first_not_of("0123456789", pos))) {
+        dims.push_back(std::stol(shape.substr(pos)));
+    }
+    if (dims.size() == 3) dims.insert(dims.begin() + 1, 1);
+    if (dims.size() != 4) throw std::runtime_error("NpyImageReader: shape " + shape + " of " + filename
+        + " is not supported, only (N, C, H, W) and (N, H, W).");
+
+    header_.numberOfImages = dims[0];
+    header_.numberOfChannels = dims[1];
+    header_.height = dims[2];
+    header_.width = dims[3];
+
+    if (dataOffset + header_.numberOfImages * header_.getImageSizeInBytes() > mapSize_)
+        throw std::runtime_error("NpyImageReader: data of " + filename + " is truncated.");
+
+    firstImage_ = map_ + dataOffset;
+    data_ = firstImage_;
+}
+
+void NpyImageReader::next(char *raw)
+{
+    if (currentImage_ >= header_.numberOfImages) throw std::runtime_error("NpyImageReader: no more images.");
+    std::memcpy(raw, data_, header_.getImageSizeInBytes());
+    data_ += header_.getImageSizeInBytes();
+    ++currentImage_;
+}
+
+void NpyImageReader::seek(int image)
+{
+    if (image < 0 or image > header_.numberOfImages) throw std::runtime_error("NpyImageReader: image index out of range.");
+    data_ = firstImage_ + static_cast<size_t>(image) * header_.getImageSizeInBytes();
+    currentImage_ = image;
+}
+
+} // namespace pink
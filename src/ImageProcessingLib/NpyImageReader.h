@@ -0,0 +1,59 @@
+/**
+ * @file   ImageProcessingLib/NpyImageReader.h
+ * @brief  Read images directly from NumPy .npy and .npz files.
+ * @date   Oct 19, 2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "ImageReader.h"
+
+namespace pink {
+
+/**
+ * @brief Memory mapped reader of NumPy arrays with shape (N, C, H, W) or (N, H, W).
+ *
+ * The array must be stored in C order with little endian float32, float16, uint16 or uint8 elements,
+ * which is identical to the pixel layout of the binary image format.
+ * Only the header is parsed on construction, the pixels are read on access.
+ * For .npz archives the first array is used, it must be stored without compression (numpy.savez).
+ */
+class NpyImageReader : public ImageReader
+{
+public:
+
+    NpyImageReader(std::string const& filename);
+
+    ~NpyImageReader();
+
+    void next(char *raw);
+
+    void seek(int image);
+
+private:
+
+    //! Parse the .npy header at position offset and set header_ and data_.
+    void parseHeader(size_t offset, std::string const& filename);
+
+    char *map_;
+
+    size_t mapSize_;
+
+    //! First pixel of the first image.
+    char const *firstImage_;
+
+    //! First pixel of the current image.
+    char const *data_;
+
+    //! Index of the next image returned by @next.
+    int currentImage_;
+
+};
+
+//! Return true if the file starts with the magic of a .npy file or of a zip archive (.npz).
+bool isNpyFile(std::string const& filename);
+
+} // namespace pink
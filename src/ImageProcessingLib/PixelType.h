@@ -0,0 +1,39 @@
+/**
+ * @file   ImageProcessingLib/PixelType.h
+ * @date   Oct 19, 2026
+ */
+
+#pragma once
+
+#include <iostream>
+
+namespace pink {
+
+//! Type of the pixels stored in an image file, the values are written into the file header
+enum class PixelType {
+    FLOAT32 = 0,
+    FLOAT16 = 1,
+    UINT16 = 2,
+    UINT8 = 3
+};
+
+//! Number of bytes of one stored pixel.
+inline int pixelTypeSize(PixelType type)
+{
+    if (type == PixelType::FLOAT16 or type == PixelType::UINT16) return 2;
+    if (type == PixelType::UINT8) return 1;
+    return 4;
+}
+
+//! Pretty printing of PixelType.
+inline std::ostream& operator << (std::ostream& os, PixelType type)
+{
+    if (type == PixelType::FLOAT32) os << "float32";
+    else if (type == PixelType::FLOAT16) os << "float16";
+    else if (type == PixelType::UINT16) os << "uint16";
+    else if (type == PixelType::UINT8) os << "uint8";
+    else os << "undefined";
+    return os;
+}
+
+} // namespace pink
@@ -0,0 +1,42 @@
+/**
+ * @file   Pink/merge.cpp
+ * @brief  Merge result files of mapping jobs over consecutive image ranges.
+ * @date   Oct 19, 2026
+ */
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "UtilitiesLib/Error.h"
+#include "UtilitiesLib/MergeResultFiles.h"
+
+using namespace pink;
+
+int main(int argc, char **argv)
+{
+    if (argc < 3 or std::string(argv[1]) == "-h" or std::string(argv[1]) == "--help") {
+        std::cout << "\n"
+                     "  Usage:\n"
+                     "\n"
+                     "    PinkMerge <output-file> <input-file> [<input-file> ...]\n"
+                     "\n"
+                     "  Concatenate the mapping result files or the rot/flip files of consecutive image ranges\n"
+                     "  (Pink --map with --first-image and --num-images) in the given order.\n"
+                     << std::endl;
+        return argc < 3 ? 1 : 0;
+    }
+
+    std::vector<std::string> inputFilenames(argv + 2, argv + argc);
+
+    try {
+        auto numberOfImages = mergeResultFiles(argv[1], inputFilenames);
+        std::cout << "  Merged " << inputFilenames.size() << " files with " << numberOfImages
+                  << " images into " << argv[1] << std::endl;
+    } catch (std::exception const& e) {
+        fatalError(e.what());
+    }
+
+    return 0;
+}
@@ -0,0 +1,130 @@
+/**
+ * @file   SelfOrganizingMapLib/EuclideanDistanceTile.h
+ * @brief  Register-blocked micro-kernel for squared euclidean distances.
+ * @date   Oct 18, 2026
+ */
+
+#pragma once
+
+#include <algorithm>
+
+namespace pink {
+
+//! Number of pixels processed in one vector register.
+#if defined(__AVX512F__)
+const int distanceVectorWidth = 16;
+#elif defined(__AVX__)
+const int distanceVectorWidth = 8;
+#else
+const int distanceVectorWidth = 4;
+#endif
+
+/**
+ * @brief Squared euclidean distances between NN neurons and NR rotated images.
+ *
+ * The NN * NR partial sums are kept in registers, therefore each neuron pixel is loaded once
+ * for NR images and each image pixel once for NN neurons. The differences are squared directly,
+ * no norm expansion is used. The distance of neuron n and image r is stored in result[n * NR + r].
+ */
+template <int NN, int NR>
+void euclideanDistanceTile(float const * const *neurons, float const * const *images, int length, float *result)
+{
+    const int W = distanceVectorWidth;
+    float sum[NN][NR][W];
+    for (int n = 0; n < NN; ++n)
+        for (int r = 0; r < NR; ++r)
+            for (int w = 0; w < W; ++w) sum[n][r][w] = 0.0;
+
+    int p = 0;
+    for (; p <= length - W; p += W) {
+        for (int n = 0; n < NN; ++n) {
+            float const *pn = neurons[n] + p;
+            for (int r = 0; r < NR; ++r) {
+                float const *pi = images[r] + p;
+                #pragma omp simd
+                for (int w = 0; w < W; ++w) {
+                    float tmp = pn[w] - pi[w];
+                    sum[n][r][w] += tmp * tmp;
+                }
+            }
+        }
+    }
+
+    for (int n = 0; n < NN; ++n) {
+        for (int r = 0; r < NR; ++r) {
+            float c = 0.0;
+            for (int w = 0; w < W; ++w) c += sum[n][r][w];
+            for (int i = p; i < length; ++i) {
+                float tmp = neurons[n][i] - images[r][i];
+                c += tmp * tmp;
+            }
+            result[n * NR + r] = c;
+        }
+    }
+}
+
+//! Number of pixels between two checks of the bound in @euclideanDistanceTileBounded.
+const int distanceBoundInterval = 256;
+
+/**
+ * @brief Same as @euclideanDistanceTile, but the tile is abandoned if all partial sums exceed their bounds.
+ *
+ * The partial sums are checked every distanceBoundInterval pixels against bound[n] of the neuron.
+ * Returns false if the tile was abandoned, the result is not written in this case.
+ * The partial sums are lower bounds of the distances, a completed tile gives exactly
+ * the result of @euclideanDistanceTile.
+ */
+template <int NN, int NR>
+bool euclideanDistanceTileBounded(float const * const *neurons, float const * const *images, int length,
+    float *result, float const *bound)
+{
+    const int W = distanceVectorWidth;
+    float sum[NN][NR][W];
+    for (int n = 0; n < NN; ++n)
+        for (int r = 0; r < NR; ++r)
+            for (int w = 0; w < W; ++w) sum[n][r][w] = 0.0;
+
+    int p = 0;
+    while (p <= length - W) {
+        int end = std::min(p + distanceBoundInterval, length - W + 1);
+        for (; p < end; p += W) {
+            for (int n = 0; n < NN; ++n) {
+                float const *pn = neurons[n] + p;
+                for (int r = 0; r < NR; ++r) {
+                    float const *pi = images[r] + p;
+                    #pragma omp simd
+                    for (int w = 0; w < W; ++w) {
+                        float tmp = pn[w] - pi[w];
+                        sum[n][r][w] += tmp * tmp;
+                    }
+                }
+            }
+        }
+
+        // Same order of summation as the final result
+        bool abandon = true;
+        for (int n = 0; n < NN and abandon; ++n) {
+            for (int r = 0; r < NR and abandon; ++r) {
+                float c = 0.0;
+                for (int w = 0; w < W; ++w) c += sum[n][r][w];
+                if (!(c > bound[n])) abandon = false;
+            }
+        }
+        if (abandon) return false;
+    }
+
+    for (int n = 0; n < NN; ++n) {
+        for (int r = 0; r < NR; ++r) {
+            float c = 0.0;
+            for (int w = 0; w < W; ++w) c += sum[n][r][w];
+            for (int i = p; i < length; ++i) {
+                float tmp = neurons[n][i] - images[r][i];
+                c += tmp * tmp;
+            }
+            result[n * NR + r] = c;
+        }
+    }
+    return true;
+}
+
+} // namespace pink
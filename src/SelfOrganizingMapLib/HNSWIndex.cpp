@@ -0,0 +1,293 @@
+/**
+ * @file   SelfOrganizingMapLib/HNSWIndex.cpp
+ * @brief  Hierarchical navigable small world graph for approximate nearest neighbor search.
+ * @date   Oct 18, 2026
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+
+#include "HNSWIndex.h"
+
+namespace pink {
+
+namespace {
+
+const char magic[8] = {'P', 'I', 'N', 'K', 'H', 'N', 'S', 'W'};
+const int fileVersion = 1;
+
+} // anonymous namespace
+
+HNSWIndex::HNSWIndex(int dim, int M, int efConstruction, int seed)
+ : dim_(dim),
+   M_(M),
+   maxM0_(2 * M),
+   efConstruction_(std::max(efConstruction, M)),
+   levelFactor_(1.0 / std::log(std::max(M, 2))),
+   numberOfVectors_(0),
+   maxLevel_(-1),
+   entryPoint_(-1),
+   rng_(seed)
+{
+    if (dim <= 0) throw std::runtime_error("HNSWIndex: dimension must be positive.");
+    if (M < 2) throw std::runtime_error("HNSWIndex: M must be larger than 1.");
+}
+
+void HNSWIndex::addVectors(float const *data, int numberOfVectors)
+{
+    data_.insert(data_.end(), data, data + static_cast<size_t>(numberOfVectors) * dim_);
+    numberOfVectors_ += numberOfVectors;
+}
+
+void HNSWIndex::build()
+{
+    links_.clear();
+    links_.resize(numberOfVectors_);
+    maxLevel_ = -1;
+    entryPoint_ = -1;
+    for (int id = 0; id < numberOfVectors_; ++id) insert(id);
+}
+
+float HNSWIndex::distance(float const *query, int id) const
+{
+    float const *p = &data_[static_cast<size_t>(id) * dim_];
+    float c = 0.0;
+    float tmp;
+    for (int i = 0; i < dim_; ++i) {
+        tmp = query[i] - p[i];
+        c += tmp * tmp;
+    }
+    return c;
+}
+
+std::vector<HNSWIndex::Neighbor> HNSWIndex::searchLayer(float const *query,
+    std::vector<Neighbor> const& entryPoints, int ef, int level) const
+{
+    std::vector<char> visited(numberOfVectors_, 0);
+
+    // Closest candidate on top
+    std::priority_queue<Neighbor, std::vector<Neighbor>, std::greater<Neighbor>> candidates;
+
+    // Furthest result on top
+    std::priority_queue<Neighbor> results;
+
+    for (auto const& e : entryPoints) {
+        visited[e.second] = 1;
+        candidates.push(e);
+        results.push(e);
+    }
+    while (static_cast<int>(results.size()) > ef) results.pop();
+
+    while (!candidates.empty()) {
+        Neighbor current = candidates.top();
+        if (current.first > results.top().first) break;
+        candidates.pop();
+
+        for (int id : links_[current.second][level]) {
+            if (visited[id]) continue;
+            visited[id] = 1;
+            float d = distance(query, id);
+            if (static_cast<int>(results.size()) < ef or d < results.top().first) {
+                candidates.push(Neighbor(d, id));
+                results.push(Neighbor(d, id));
+                if (static_cast<int>(results.size()) > ef) results.pop();
+            }
+        }
+    }
+
+    std::vector<Neighbor> sorted(results.size());
+    for (int i = sorted.size() - 1; i >= 0; --i) {
+        sorted[i] = results.top();
+        results.pop();
+    }
+    return sorted;
+}
+
+std::vector<int> HNSWIndex::selectNeighbors(std::vector<Neighbor> const& candidates, int M) const
+{
+    std::vector<int> selected;
+    std::vector<int> discarded;
+
+    for (auto const& c : candidates) {
+        if (static_cast<int>(selected.size()) == M) break;
+        bool good = true;
+        float const *pc = &data_[static_cast<size_t>(c.second) * dim_];
+        for (int s : selected) {
+            if (distance(pc, s) < c.first) {
+                good = false;
+                break;
+            }
+        }
+        if (good) selected.push_back(c.second);
+        else discarded.push_back(c.second);
+    }
+
+    // Fill up with discarded candidates to keep the graph connected
+    for (size_t i = 0; i < discarded.size() and static_cast<int>(selected.size()) < M; ++i)
+        selected.push_back(discarded[i]);
+
+    return selected;
+}
+
+void HNSWIndex::insert(int id)
+{
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    int level = static_cast<int>(-std::log(1.0 - uniform(rng_)) * levelFactor_);
+
+    links_[id].resize(level + 1);
+
+    if (entryPoint_ == -1) {
+        entryPoint_ = id;
+        maxLevel_ = level;
+        return;
+    }
+
+    float const *query = &data_[static_cast<size_t>(id) * dim_];
+    std::vector<Neighbor> entryPoints(1, Neighbor(distance(query, entryPoint_), entryPoint_));
+
+    for (int l = maxLevel_; l > level; --l) {
+        entryPoints = searchLayer(query, entryPoints, 1, l);
+    }
+
+    for (int l = std::min(level, maxLevel_); l >= 0; --l) {
+        std::vector<Neighbor> candidates = searchLayer(query, entryPoints, efConstruction_, l);
+        int maxM = l == 0 ? maxM0_ : M_;
+
+        links_[id][l] = selectNeighbors(candidates, M_);
+
+        for (int neighbor : links_[id][l]) {
+            std::vector<int>& neighborLinks = links_[neighbor][l];
+            neighborLinks.push_back(id);
+            if (static_cast<int>(neighborLinks.size()) > maxM) {
+                float const *pn = &data_[static_cast<size_t>(neighbor) * dim_];
+                std::vector<Neighbor> neighborCandidates;
+                for (int n : neighborLinks) neighborCandidates.push_back(Neighbor(distance(pn, n), n));
+                std::sort(neighborCandidates.begin(), neighborCandidates.end());
+                neighborLinks = selectNeighbors(neighborCandidates, maxM);
+            }
+        }
+        entryPoints = candidates;
+    }
+
+    if (level > maxLevel_) {
+        maxLevel_ = level;
+        entryPoint_ = id;
+    }
+}
+
+std::vector<HNSWIndex::Neighbor> HNSWIndex::search(float const *query, int k, int ef) const
+{
+    if (entryPoint_ == -1) return std::vector<Neighbor>();
+
+    std::vector<Neighbor> entryPoints(1, Neighbor(distance(query, entryPoint_), entryPoint_));
+
+    for (int l = maxLevel_; l > 0; --l) {
+        entryPoints = searchLayer(query, entryPoints, 1, l);
+    }
+
+    std::vector<Neighbor> result = searchLayer(query, entryPoints, std::max(ef, k), 0);
+    if (static_cast<int>(result.size()) > k) result.resize(k);
+    return result;
+}
+
+uint64_t HNSWIndex::hash() const
+{
+    // FNV-1a over the raw bytes
+    uint64_t h = 14695981039346656037ULL;
+    unsigned char const *p = reinterpret_cast<unsigned char const*>(data_.data());
+    for (size_t i = 0; i < data_.size() * sizeof(float); ++i) {
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+void HNSWIndex::save(std::string const& filename) const
+{
+    std::ofstream os(filename, std::ios::binary);
+    if (!os) throw std::runtime_error("Error opening " + filename);
+
+    uint64_t h = hash();
+    os.write(magic, sizeof(magic));
+    os.write((char*)&fileVersion, sizeof(int));
+    os.write((char*)&dim_, sizeof(int));
+    os.write((char*)&numberOfVectors_, sizeof(int));
+    os.write((char*)&M_, sizeof(int));
+    os.write((char*)&efConstruction_, sizeof(int));
+    os.write((char*)&maxLevel_, sizeof(int));
+    os.write((char*)&entryPoint_, sizeof(int));
+    os.write((char*)&h, sizeof(uint64_t));
+
+    for (auto const& levels : links_) {
+        int numberOfLevels = levels.size();
+        os.write((char*)&numberOfLevels, sizeof(int));
+        for (auto const& neighbors : levels) {
+            int numberOfNeighbors = neighbors.size();
+            os.write((char*)&numberOfNeighbors, sizeof(int));
+            os.write((char*)neighbors.data(), numberOfNeighbors * sizeof(int));
+        }
+    }
+}
+
+bool HNSWIndex::load(std::string const& filename)
+{
+    std::ifstream is(filename, std::ios::binary);
+    if (!is) return false;
+
+    char fileMagic[sizeof(magic)];
+    int version, dim, numberOfVectors, M, efConstruction, maxLevel, entryPoint;
+    uint64_t h;
+
+    is.read(fileMagic, sizeof(fileMagic));
+    if (!is or !std::equal(fileMagic, fileMagic + sizeof(magic), magic)) return false;
+    is.read((char*)&version, sizeof(int));
+    is.read((char*)&dim, sizeof(int));
+    is.read((char*)&numberOfVectors, sizeof(int));
+    is.read((char*)&M, sizeof(int));
+    is.read((char*)&efConstruction, sizeof(int));
+    is.read((char*)&maxLevel, sizeof(int));
+    is.read((char*)&entryPoint, sizeof(int));
+    is.read((char*)&h, sizeof(uint64_t));
+
+    if (!is or version != fileVersion or dim != dim_ or numberOfVectors != numberOfVectors_
+        or M != M_ or efConstruction != efConstruction_ or h != hash()) return false;
+
+    std::vector<std::vector<std::vector<int>>> links(numberOfVectors);
+    for (auto& levels : links) {
+        int numberOfLevels;
+        is.read((char*)&numberOfLevels, sizeof(int));
+        if (!is or numberOfLevels < 1 or numberOfLevels > maxLevel + 1) return false;
+        levels.resize(numberOfLevels);
+        for (auto& neighbors : levels) {
+            int numberOfNeighbors;
+            is.read((char*)&numberOfNeighbors, sizeof(int));
+            if (!is or numberOfNeighbors < 0 or numberOfNeighbors > maxM0_) return false;
+            neighbors.resize(numberOfNeighbors);
+            is.read((char*)neighbors.data(), numberOfNeighbors * sizeof(int));
+            for (int id : neighbors) if (id < 0 or id >= numberOfVectors) return false;
+        }
+    }
+    if (!is) return false;
+
+    // The search starts at the entry point on the top level and follows the neighbors on their levels
+    if (numberOfVectors == 0) {
+        if (entryPoint != -1) return false;
+    } else if (entryPoint < 0 or entryPoint >= numberOfVectors
+        or static_cast<int>(links[entryPoint].size()) != maxLevel + 1) return false;
+    for (auto const& levels : links) {
+        for (size_t level = 0; level < levels.size(); ++level) {
+            for (int id : levels[level]) if (links[id].size() <= level) return false;
+        }
+    }
+
+    links_.swap(links);
+    maxLevel_ = maxLevel;
+    entryPoint_ = entryPoint;
+    return true;
+}
+
+} // namespace pink
@@ -0,0 +1,89 @@
+/**
+ * @file   SelfOrganizingMapLib/HNSWIndex.h
+ * @brief  Hierarchical navigable small world graph for approximate nearest neighbor search.
+ * @date   Oct 18, 2026
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace pink {
+
+/**
+ * @brief Approximate nearest neighbor index (HNSW) using squared euclidean distances.
+ *
+ * The vectors are stored in the index. Only the graph is written to file,
+ * the vectors must be added again before @load is called. A hash over the
+ * vectors is stored together with the graph to detect outdated index files.
+ */
+class HNSWIndex
+{
+public:
+
+    //! Pair of squared euclidean distance and id.
+    typedef std::pair<float, int> Neighbor;
+
+    HNSWIndex(int dim, int M = 16, int efConstruction = 200, int seed = 1234);
+
+    //! Copy vectors into the index, the graph is not touched.
+    void addVectors(float const *data, int numberOfVectors);
+
+    //! Insert all vectors into the graph.
+    void build();
+
+    //! Return the k nearest neighbors sorted by distance.
+    std::vector<Neighbor> search(float const *query, int k, int ef) const;
+
+    //! Write graph to file.
+    void save(std::string const& filename) const;
+
+    //! Read graph from file, returns false if the file does not fit to the stored vectors.
+    bool load(std::string const& filename);
+
+    int getDimension() const { return dim_; }
+
+    int getNumberOfVectors() const { return numberOfVectors_; }
+
+private:
+
+    //! Squared euclidean distance between stored vector and query.
+    float distance(float const *query, int id) const;
+
+    //! Greedy search on one layer, returns the ef closest nodes sorted by distance.
+    std::vector<Neighbor> searchLayer(float const *query, std::vector<Neighbor> const& entryPoints,
+        int ef, int level) const;
+
+    //! Keep the M closest neighbors preferring diverse directions (HNSW heuristic).
+    std::vector<int> selectNeighbors(std::vector<Neighbor> const& candidates, int M) const;
+
+    //! Insert vector with given id into the graph.
+    void insert(int id);
+
+    //! Hash over all stored vectors.
+    uint64_t hash() const;
+
+    int dim_;
+    int M_;
+    int maxM0_;
+    int efConstruction_;
+    double levelFactor_;
+
+    int numberOfVectors_;
+    int maxLevel_;
+    int entryPoint_;
+
+    std::vector<float> data_;
+
+    //! Neighbor lists: links_[id][level]
+    std::vector<std::vector<std::vector<int>>> links_;
+
+    std::mt19937 rng_;
+
+};
+
+} // namespace pink
@@ -0,0 +1,176 @@
+/**
+ * @file   SelfOrganizingMapLib/MappingResultWriter.cpp
+ * @brief  Writing the result files of the mapping.
+ * @date   Oct 19, 2026
+ */
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef PINK_USE_ZLIB
+#include <zlib.h>
+#endif
+
+#include "MappingResultWriter.h"
+#include "UtilitiesLib/Error.h"
+
+namespace pink {
+
+namespace {
+
+//! Largest finite value of float16.
+const float maxFloat16 = 65504.0f;
+
+//! Append value to the record at position pos.
+template <class T>
+void put(std::vector<char>& buffer, size_t& pos, T value)
+{
+    std::memcpy(&buffer[pos], &value, sizeof(T));
+    pos += sizeof(T);
+}
+
+//! Open file for the result writer.
+std::unique_ptr<AsyncFileWriter> openFile(std::string const& filename, InputData const& inputData)
+{
+    try {
+        return std::unique_ptr<AsyncFileWriter>(new AsyncFileWriter(filename,
+            static_cast<size_t>(inputData.writeBufferSize) << 20, 4, inputData.directIO));
+    } catch (std::runtime_error const&) {
+        fatalError("Error opening " + filename);
+    }
+    return nullptr;
+}
+
+void writeHeader(AsyncFileWriter& file, ResultFileHeader const& header)
+{
+    std::ostringstream os;
+    writeResultFileHeader(os, header);
+    file.write(os.str().data(), os.str().size());
+}
+
+} // anonymous namespace
+
+MappingResultWriter::MappingResultWriter(InputData const& inputData)
+ : inputData_(inputData),
+   header_(inputData.numberOfImages, inputData.som_width, inputData.som_height, inputData.som_depth,
+       inputData.resultTopK ? ResultType::TOP_K : ResultType::DISTANCES, inputData.resultTopK,
+       inputData.resultEncoding, inputData.resultCompression),
+   resultFile_(openFile(inputData.resultFilename, inputData)),
+   row_(header_.getRowSizeInBytes(inputData.som_size)),
+   rowsPerBlock_(std::max<int>(1, blockSizeInBytes / row_.size())),
+   rowsInBlock_(0),
+   overflowReported_(false)
+{
+    writeHeader(*resultFile_, header_);
+
+    if (header_.codec != ImageCodec::NONE) block_.resize(rowsPerBlock_ * row_.size());
+
+    if (inputData_.write_rot_flip) {
+        rotFlipFile_ = openFile(inputData_.rot_flip_filename, inputData_);
+        writeHeader(*rotFlipFile_, ResultFileHeader(inputData_.numberOfImages, inputData_.som_width,
+            inputData_.som_height, inputData_.som_depth));
+        rotFlipRow_.resize(inputData_.som_size * (sizeof(char) + sizeof(float)));
+    }
+}
+
+MappingResultWriter::~MappingResultWriter()
+{
+    close();
+}
+
+void MappingResultWriter::flush()
+{
+    try {
+        resultFile_->flush();
+        if (rotFlipFile_) rotFlipFile_->flush();
+    } catch (std::runtime_error const& e) {
+        fatalError(e.what());
+    }
+}
+
+void MappingResultWriter::close()
+{
+    if (rowsInBlock_) writeBlock();
+    try {
+        resultFile_->close();
+        if (rotFlipFile_) rotFlipFile_->close();
+    } catch (std::runtime_error const& e) {
+        fatalError(e.what());
+    }
+}
+
+double MappingResultWriter::getStallTime() const
+{
+    return resultFile_->getStallTime() + (rotFlipFile_ ? rotFlipFile_->getStallTime() : 0.0);
+}
+
+void MappingResultWriter::write(float const *euclideanDistanceMatrix, int const *bestRotationMatrix)
+{
+    if (header_.encoding == ResultEncoding::FLOAT16 and !overflowReported_) {
+        for (int i = 0; i != inputData_.som_size; ++i) {
+            if (euclideanDistanceMatrix[i] > maxFloat16 and euclideanDistanceMatrix[i] < FLT_MAX) {
+                std::cout << "  Warning: distances larger than " << maxFloat16 << " are written as infinity"
+                          << " with result-encoding float16, please use uint16." << std::endl;
+                overflowReported_ = true;
+                break;
+            }
+        }
+    }
+    encodeDistances(&row_[0], euclideanDistanceMatrix, inputData_.som_size, header_.encoding);
+    writeRow();
+
+    if (inputData_.write_rot_flip) {
+        float angleStepRadians = 2.0 * M_PI / inputData_.numberOfRotations;
+        size_t pos = 0;
+        for (int i = 0; i != inputData_.som_size; ++i) {
+            put<char>(rotFlipRow_, pos, bestRotationMatrix[i] / inputData_.numberOfRotations);
+            put<float>(rotFlipRow_, pos, (bestRotationMatrix[i] % inputData_.numberOfRotations) * angleStepRadians);
+        }
+        rotFlipFile_->write(&rotFlipRow_[0], rotFlipRow_.size());
+    }
+}
+
+void MappingResultWriter::write(BestMatch const *bestMatches)
+{
+    float angleStepRadians = 2.0 * M_PI / inputData_.numberOfRotations;
+    size_t pos = 0;
+    for (int i = 0; i != header_.numberOfBestMatches; ++i) {
+        put<int>(row_, pos, bestMatches[i].neuron);
+        put<float>(row_, pos, bestMatches[i].distance);
+        put<char>(row_, pos, bestMatches[i].rotation / inputData_.numberOfRotations);
+        put<float>(row_, pos, (bestMatches[i].rotation % inputData_.numberOfRotations) * angleStepRadians);
+    }
+    writeRow();
+}
+
+void MappingResultWriter::writeRow()
+{
+    if (header_.codec == ImageCodec::NONE) {
+        resultFile_->write(&row_[0], row_.size());
+        return;
+    }
+    std::copy(row_.begin(), row_.end(), block_.begin() + rowsInBlock_ * row_.size());
+    if (++rowsInBlock_ == rowsPerBlock_) writeBlock();
+}
+
+void MappingResultWriter::writeBlock()
+{
+#ifdef PINK_USE_ZLIB
+    const uLong size = rowsInBlock_ * row_.size();
+    uLongf compressedSize = compressBound(size);
+    compressed_.resize(compressedSize);
+    if (compress2((Bytef*)&compressed_[0], &compressedSize, (Bytef const*)&block_[0], size, 1) != Z_OK)
+        fatalError("MappingResultWriter: compression failed.");
+
+    int64_t blockHeader[2] = {rowsInBlock_, static_cast<int64_t>(compressedSize)};
+    resultFile_->write(blockHeader, resultBlockHeaderSize);
+    resultFile_->write(&compressed_[0], compressedSize);
+#endif
+    rowsInBlock_ = 0;
+}
+
+} // namespace pink
@@ -0,0 +1,93 @@
+/**
+ * @file   SelfOrganizingMapLib/MappingResultWriter.h
+ * @brief  Writing the result files of the mapping.
+ * @date   Oct 19, 2026
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "SelfOrganizingMap.h"
+#include "UtilitiesLib/AsyncFileWriter.h"
+#include "UtilitiesLib/InputData.h"
+#include "UtilitiesLib/ResultFileHeader.h"
+
+namespace pink {
+
+/**
+ * @brief Result file and optional rot/flip file of the mapping.
+ *
+ * With InputData::resultTopK only the best matching neurons are written (ResultType::TOP_K),
+ * otherwise the distances of all neurons in the format of InputData::resultEncoding.
+ * With InputData::resultCompression the rows are collected into blocks of about blockSizeInBytes,
+ * the last block is written by @close.
+ * The files are written in the background by @AsyncFileWriter with buffers of InputData::writeBufferSize.
+ */
+class MappingResultWriter
+{
+public:
+
+    //! Uncompressed size of a block.
+    static const size_t blockSizeInBytes = 1 << 20;
+
+    //! Open the files and write the headers.
+    MappingResultWriter(InputData const& inputData);
+
+    ~MappingResultWriter();
+
+    //! Distances of all neurons and the best rotations for the rot/flip file.
+    void write(float const *euclideanDistanceMatrix, int const *bestRotationMatrix);
+
+    //! Best matching neurons sorted by distance, resultTopK entries.
+    void write(BestMatch const *bestMatches);
+
+    //! Write all complete rows, a partial block remains in memory.
+    void flush();
+
+    //! Write the last block and close the files, called by the destructor.
+    void close();
+
+    //! Seconds the mapping waited for the output.
+    double getStallTime() const;
+
+    ResultFileHeader const& getHeader() const { return header_; }
+
+private:
+
+    //! Write row_ into the result file or append it to the block.
+    void writeRow();
+
+    //! Compress and write the block.
+    void writeBlock();
+
+    InputData const& inputData_;
+
+    ResultFileHeader header_;
+
+    std::unique_ptr<AsyncFileWriter> resultFile_;
+
+    std::unique_ptr<AsyncFileWriter> rotFlipFile_;
+
+    //! Result of one image.
+    std::vector<char> row_;
+
+    //! Rot/flip record of one image.
+    std::vector<char> rotFlipRow_;
+
+    //! Rows not yet compressed.
+    std::vector<char> block_;
+
+    int rowsPerBlock_;
+
+    int rowsInBlock_;
+
+    std::vector<char> compressed_;
+
+    //! Float16 distances out of range were reported.
+    bool overflowReported_;
+
+};
+
+} // namespace pink
@@ -0,0 +1,106 @@
+/**
+ * @file   SelfOrganizingMapLib/NeuronPrototypes.cpp
+ * @brief  Closest images of every neuron during mapping.
+ * @date   Oct 19, 2026
+ */
+
+#include <cfloat>
+#include <cmath>
+#include <fstream>
+
+#include "ImageProcessingLib/ImageFileHeader.h"
+#include "NeuronPrototypes.h"
+#include "UtilitiesLib/Error.h"
+
+namespace pink {
+
+namespace {
+
+const char magic[8] = {'P', 'I', 'N', 'K', 'P', 'R', 'O', 'T'};
+const int fileVersion = 2;
+
+} // anonymous namespace
+
+NeuronPrototypes::NeuronPrototypes(int som_size, int numberOfPrototypes, int cutoutSize)
+ : numberOfPrototypes_(numberOfPrototypes),
+   cutoutSize_(cutoutSize),
+   numberOfImages_(0),
+   prototypes_(som_size, BoundedHeap<Prototype>(numberOfPrototypes)),
+   cutouts_(static_cast<size_t>(som_size) * numberOfPrototypes * cutoutSize, 0.0)
+{}
+
+void NeuronPrototypes::add(int image, float const *euclideanDistanceMatrix, int const *bestRotationMatrix,
+    CutoutFunction const& cutout)
+{
+    ++numberOfImages_;
+    const int som_size = prototypes_.size();
+
+    // Every heap is only touched by the thread of its neuron, no merge is needed
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < som_size; ++i) {
+        BoundedHeap<Prototype>& heap = prototypes_[i];
+        const float distance = euclideanDistanceMatrix[i];
+        if (distance == FLT_MAX) continue;
+
+        // The slot of the replaced prototype is reused for the cutout
+        int slot = heap.full() ? heap.top().slot : heap.size();
+        if (!heap.push(Prototype{image, distance, bestRotationMatrix[i], slot})) continue;
+        if (cutoutSize_ and cutout)
+            cutout(&cutouts_[(static_cast<size_t>(i) * numberOfPrototypes_ + slot) * cutoutSize_], bestRotationMatrix[i]);
+    }
+}
+
+void NeuronPrototypes::write(std::string const& filename, InputData const& inputData) const
+{
+    std::ofstream os(filename, std::ios::binary);
+    if (!os) fatalError("Error opening " + filename);
+
+    int som_size = prototypes_.size();
+    os.write(magic, sizeof(magic));
+    os.write((char*)&fileVersion, sizeof(int));
+    os.write((char*)&numberOfImages_, sizeof(int64_t));
+    os.write((char*)&inputData.som_width, sizeof(int));
+    os.write((char*)&inputData.som_height, sizeof(int));
+    os.write((char*)&inputData.som_depth, sizeof(int));
+    os.write((char*)&som_size, sizeof(int));
+    os.write((char*)&numberOfPrototypes_, sizeof(int));
+
+    float angleStepRadians = 2.0 * M_PI / inputData.numberOfRotations;
+    const Prototype missing{-1, FLT_MAX, 0, 0};
+    for (int i = 0; i < som_size; ++i) {
+        std::vector<Prototype> prototypes = getPrototypes(i);
+        prototypes.resize(numberOfPrototypes_, missing);
+        for (auto const& prototype : prototypes) {
+            char flip = prototype.rotation / inputData.numberOfRotations;
+            float angle = (prototype.rotation % inputData.numberOfRotations) * angleStepRadians;
+            os.write((char*)&i, sizeof(int));
+            os.write((char*)&prototype.image, sizeof(int));
+            os.write((char*)&prototype.distance, sizeof(float));
+            os.write(&flip, sizeof(char));
+            os.write((char*)&angle, sizeof(float));
+        }
+    }
+    if (!os) fatalError("Error writing " + filename);
+}
+
+void NeuronPrototypes::writeCutouts(std::string const& filename, InputData const& inputData) const
+{
+    std::ofstream os(filename, std::ios::binary);
+    if (!os) fatalError("Error opening " + filename);
+
+    int som_size = prototypes_.size();
+    writeImageFileHeader(os, ImageFileHeader(som_size * numberOfPrototypes_, inputData.numberOfChannels,
+        inputData.neuron_dim, inputData.neuron_dim));
+
+    const std::vector<float> zero(cutoutSize_, 0.0);
+    for (int i = 0; i < som_size; ++i) {
+        std::vector<Prototype> prototypes = getPrototypes(i);
+        for (int j = 0; j < numberOfPrototypes_; ++j) {
+            float const *cutout = j < static_cast<int>(prototypes.size()) ? getCutout(i, prototypes[j]) : zero.data();
+            os.write((char*)cutout, cutoutSize_ * sizeof(float));
+        }
+    }
+    if (!os) fatalError("Error writing " + filename);
+}
+
+} // namespace pink
@@ -0,0 +1,97 @@
+/**
+ * @file   SelfOrganizingMapLib/NeuronPrototypes.h
+ * @brief  Closest images of every neuron during mapping.
+ * @date   Oct 19, 2026
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "UtilitiesLib/BoundedHeap.h"
+#include "UtilitiesLib/InputData.h"
+
+namespace pink {
+
+//! Image close to a neuron with its best rotation.
+struct Prototype
+{
+    int image;
+    float distance;
+    int rotation;
+
+    //! Index of the cutout of the neuron.
+    int slot;
+};
+
+//! Order by distance, ties by image index.
+inline bool operator < (Prototype const& a, Prototype const& b)
+{
+    return a.distance < b.distance or (a.distance == b.distance and a.image < b.image);
+}
+
+/**
+ * @brief The numberOfPrototypes closest images of every neuron in one pass over the images.
+ *
+ * In contrast to @NeuronStatistics every image is a candidate for all neurons, not only for
+ * its best matching neuron. The memory is O(som_size * numberOfPrototypes), including the
+ * rotated and flipped images if cutoutSize is not zero.
+ *
+ * The prototypes file starts with the magic PINKPROT, the version (int), the number of images (int64)
+ * and the integers som_width, som_height, som_depth, som_size and number of prototypes.
+ * Version 1 stored the number of images as int.
+ * Every neuron follows with its prototypes sorted by distance as neuron (int), image index (int),
+ * squared euclidean distance (float), flip (char) and rotation angle in radians (float).
+ * Missing prototypes have the image index -1.
+ */
+class NeuronPrototypes
+{
+public:
+
+    //! Function copying the rotated image of a rotation into its first argument.
+    typedef std::function<void(float*, int)> CutoutFunction;
+
+    NeuronPrototypes(int som_size, int numberOfPrototypes, int cutoutSize = 0);
+
+    /**
+     * @brief Add image with the distances and best rotations of all neurons.
+     *
+     * The neurons are distributed over the threads. Neurons with distance FLT_MAX are skipped,
+     * e.g. the ones not compared by ann-top-k. The cutout function is called for accepted
+     * prototypes if cutoutSize is not zero and must be thread-safe.
+     */
+    void add(int image, float const *euclideanDistanceMatrix, int const *bestRotationMatrix,
+        CutoutFunction const& cutout = CutoutFunction());
+
+    void write(std::string const& filename, InputData const& inputData) const;
+
+    //! Write the cutouts of all prototypes as binary image file, missing prototypes are zero images.
+    void writeCutouts(std::string const& filename, InputData const& inputData) const;
+
+    //! Prototypes of neuron sorted by distance.
+    std::vector<Prototype> getPrototypes(int neuron) const { return prototypes_[neuron].sorted(); }
+
+    //! Rotated and flipped image of a prototype of neuron.
+    float const* getCutout(int neuron, Prototype const& prototype) const
+    {
+        return &cutouts_[(static_cast<size_t>(neuron) * numberOfPrototypes_ + prototype.slot) * cutoutSize_];
+    }
+
+private:
+
+    int numberOfPrototypes_;
+
+    int cutoutSize_;
+
+    int64_t numberOfImages_;
+
+    std::vector<BoundedHeap<Prototype>> prototypes_;
+
+    std::vector<float> cutouts_;
+
+};
+
+} // namespace pink
@@ -0,0 +1,70 @@
+/**
+ * @file   SelfOrganizingMapLib/NeuronStatistics.cpp
+ * @brief  Per neuron aggregates of the best matching neurons during mapping.
+ * @date   Oct 19, 2026
+ */
+
+#include <cfloat>
+#include <fstream>
+
+#include "NeuronStatistics.h"
+#include "UtilitiesLib/Error.h"
+
+namespace pink {
+
+namespace {
+
+const char magic[8] = {'P', 'I', 'N', 'K', 'S', 'T', 'A', 'T'};
+const int fileVersion = 2;
+
+} // anonymous namespace
+
+NeuronStatistics::NeuronStatistics(int som_size, int numberOfExamples)
+ : numberOfExamples_(numberOfExamples),
+   numberOfImages_(0),
+   count_(som_size, 0),
+   sum_(som_size, 0.0),
+   sumOfSquares_(som_size, 0.0),
+   examples_(som_size, BoundedHeap<NeuronExample>(numberOfExamples))
+{}
+
+void NeuronStatistics::add(int image, int neuron, float distance)
+{
+    ++numberOfImages_;
+    ++count_[neuron];
+    sum_[neuron] += distance;
+    sumOfSquares_[neuron] += static_cast<double>(distance) * distance;
+    examples_[neuron].push(NeuronExample{image, distance});
+}
+
+void NeuronStatistics::write(std::string const& filename, InputData const& inputData) const
+{
+    std::ofstream os(filename, std::ios::binary);
+    if (!os) fatalError("Error opening " + filename);
+
+    int som_size = count_.size();
+    os.write(magic, sizeof(magic));
+    os.write((char*)&fileVersion, sizeof(int));
+    os.write((char*)&numberOfImages_, sizeof(int64_t));
+    os.write((char*)&inputData.som_width, sizeof(int));
+    os.write((char*)&inputData.som_height, sizeof(int));
+    os.write((char*)&inputData.som_depth, sizeof(int));
+    os.write((char*)&som_size, sizeof(int));
+    os.write((char*)&numberOfExamples_, sizeof(int));
+
+    const NeuronExample missing{-1, FLT_MAX};
+    for (int i = 0; i < som_size; ++i) {
+        os.write((char*)&count_[i], sizeof(int64_t));
+        os.write((char*)&sum_[i], sizeof(double));
+        os.write((char*)&sumOfSquares_[i], sizeof(double));
+        std::vector<NeuronExample> examples = examples_[i].sorted();
+        examples.resize(numberOfExamples_, missing);
+        for (auto const& example : examples) {
+            os.write((char*)&example.image, sizeof(int));
+            os.write((char*)&example.distance, sizeof(float));
+        }
+    }
+    if (!os) fatalError("Error writing " + filename);
+}
+
+} // namespace pink
@@ -0,0 +1,77 @@
+/**
+ * @file   SelfOrganizingMapLib/NeuronStatistics.h
+ * @brief  Per neuron aggregates of the best matching neurons during mapping.
+ * @date   Oct 19, 2026
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "UtilitiesLib/BoundedHeap.h"
+#include "UtilitiesLib/InputData.h"
+
+namespace pink {
+
+//! Image mapped to a neuron.
+struct NeuronExample
+{
+    int image;
+    float distance;
+};
+
+//! Order by distance, ties by image index.
+inline bool operator < (NeuronExample const& a, NeuronExample const& b)
+{
+    return a.distance < b.distance or (a.distance == b.distance and a.image < b.image);
+}
+
+/**
+ * @brief Histogram, distance moments and closest examples of the images per best matching neuron.
+ *
+ * The statistics file starts with the magic PINKSTAT, the version (int), the number of images (int64)
+ * and the integers som_width, som_height, som_depth, som_size and number of examples.
+ * Version 1 stored the number of images as int.
+ * Every neuron follows with the number of images (int64), the sum and the sum of squares of
+ * their squared euclidean distances (double) and the examples as image index (int) and distance (float)
+ * sorted by distance. Missing examples have the image index -1.
+ */
+class NeuronStatistics
+{
+public:
+
+    NeuronStatistics(int som_size, int numberOfExamples);
+
+    //! Add image with its best matching neuron.
+    void add(int image, int neuron, float distance);
+
+    void write(std::string const& filename, InputData const& inputData) const;
+
+    int64_t getCount(int neuron) const { return count_[neuron]; }
+
+    double getSum(int neuron) const { return sum_[neuron]; }
+
+    double getSumOfSquares(int neuron) const { return sumOfSquares_[neuron]; }
+
+    //! Closest images of neuron sorted by distance.
+    std::vector<NeuronExample> getExamples(int neuron) const { return examples_[neuron].sorted(); }
+
+private:
+
+    int numberOfExamples_;
+
+    int64_t numberOfImages_;
+
+    std::vector<int64_t> count_;
+
+    std::vector<double> sum_;
+
+    std::vector<double> sumOfSquares_;
+
+    std::vector<BoundedHeap<NeuronExample>> examples_;
+
+};
+
+} // namespace pink
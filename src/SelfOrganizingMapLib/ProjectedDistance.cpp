@@ -0,0 +1,159 @@
+/**
+ * @file   SelfOrganizingMapLib/ProjectedDistance.cpp
+ * @brief  Approximate euclidean distances in the subspace of the principal components.
+ * @date   Oct 18, 2026
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "EuclideanDistanceTile.h"
+#include "ProjectedDistance.h"
+#include "UtilitiesLib/Filler.h"
+
+namespace pink {
+
+namespace {
+
+//! Modified Gram-Schmidt of the columns of the dim x k matrix q, linear dependent columns are set to zero.
+void orthonormalize(float *q, int dim, int k)
+{
+    for (int c = 0; c < k; ++c) {
+        for (int b = 0; b < c; ++b) {
+            float dot = 0.0;
+            for (int p = 0; p < dim; ++p) dot += q[p * k + b] * q[p * k + c];
+            for (int p = 0; p < dim; ++p) q[p * k + c] -= dot * q[p * k + b];
+        }
+        float norm = 0.0;
+        for (int p = 0; p < dim; ++p) norm += q[p * k + c] * q[p * k + c];
+        norm = std::sqrt(norm);
+        float factor = norm > 1e-12 ? 1.0 / norm : 0.0;
+        for (int p = 0; p < dim; ++p) q[p * k + c] *= factor;
+    }
+}
+
+/**
+ * @brief Coordinates of NI images for NC consecutive components.
+ *
+ * The basis pointer is shifted to the first component, k is the row length of the basis.
+ * The coordinate of image i and component c is stored at result[i * resultStride + c].
+ */
+template <int NI, int NC>
+void projectionBlock(float const * const *images, float const *basis, int k, int dim, float *result, int resultStride)
+{
+    float sum[NI][NC];
+    for (int i = 0; i < NI; ++i)
+        for (int c = 0; c < NC; ++c) sum[i][c] = 0.0;
+
+    for (int p = 0; p < dim; ++p) {
+        float const *pb = basis + p * k;
+        for (int i = 0; i < NI; ++i) {
+            float x = images[i][p];
+            #pragma omp simd
+            for (int c = 0; c < NC; ++c) sum[i][c] += x * pb[c];
+        }
+    }
+
+    for (int i = 0; i < NI; ++i)
+        for (int c = 0; c < NC; ++c) result[i * resultStride + c] = sum[i][c];
+}
+
+} // anonymous namespace
+
+void calculatePrincipalComponents(float *basis, float const *data, int numberOfVectors, int dim,
+    int numberOfComponents, int numberOfIterations, int seed)
+{
+    int k = numberOfComponents;
+
+    std::vector<float> mean(dim, 0.0);
+    for (int i = 0; i < numberOfVectors; ++i)
+        for (int p = 0; p < dim; ++p) mean[p] += data[static_cast<size_t>(i) * dim + p];
+    for (int p = 0; p < dim; ++p) mean[p] /= numberOfVectors;
+
+    // Start with random subspace
+    fillWithRandomNumbers(basis, dim * k, seed);
+    orthonormalize(basis, dim, k);
+
+    std::vector<float> z(static_cast<size_t>(numberOfVectors) * k);
+
+    for (int iteration = 0; iteration < numberOfIterations; ++iteration) {
+        // z = (X - mean) * basis
+        #pragma omp parallel for
+        for (int i = 0; i < numberOfVectors; ++i) {
+            float *pz = &z[static_cast<size_t>(i) * k];
+            for (int c = 0; c < k; ++c) pz[c] = 0.0;
+            for (int p = 0; p < dim; ++p) {
+                float x = data[static_cast<size_t>(i) * dim + p] - mean[p];
+                #pragma omp simd
+                for (int c = 0; c < k; ++c) pz[c] += x * basis[p * k + c];
+            }
+        }
+
+        // basis = (X - mean)^T * z
+        #pragma omp parallel for
+        for (int p = 0; p < dim; ++p) {
+            float *pb = basis + p * k;
+            for (int c = 0; c < k; ++c) pb[c] = 0.0;
+            for (int i = 0; i < numberOfVectors; ++i) {
+                float x = data[static_cast<size_t>(i) * dim + p] - mean[p];
+                float const *pz = &z[static_cast<size_t>(i) * k];
+                #pragma omp simd
+                for (int c = 0; c < k; ++c) pb[c] += x * pz[c];
+            }
+        }
+
+        orthonormalize(basis, dim, k);
+    }
+}
+
+void projectImages(float *projections, float const *basis, float const *images, int numberOfImages, int dim,
+    int numberOfComponents)
+{
+    // Register blocking: NI images times NC components
+    const int NI = 4;
+    const int NC = 8;
+    int k = numberOfComponents;
+    int numberOfImageBlocks = (numberOfImages + NI - 1) / NI;
+
+    #pragma omp parallel for
+    for (int b = 0; b < numberOfImageBlocks; ++b) {
+        // Incomplete blocks repeat the last image
+        float const *image[NI];
+        for (int i = 0; i < NI; ++i)
+            image[i] = images + static_cast<size_t>(std::min(b * NI + i, numberOfImages - 1)) * dim;
+        int numberOfBlockImages = std::min(NI, numberOfImages - b * NI);
+
+        std::vector<float> result(NI * k);
+        int c = 0;
+        for (; c <= k - NC; c += NC) projectionBlock<NI, NC>(image, basis + c, k, dim, &result[c], k);
+        for (; c < k; ++c) projectionBlock<NI, 1>(image, basis + c, k, dim, &result[c], k);
+
+        std::copy(result.begin(), result.begin() + numberOfBlockImages * k,
+            projections + static_cast<size_t>(b) * NI * k);
+    }
+}
+
+void generateProjectedScores(float *scores, float const *neuronProjections, int som_size,
+    float const *imageProjections, int numberOfRotations, int numberOfComponents)
+{
+    const int NR = 4;
+
+    #pragma omp parallel for
+    for (int i = 0; i < som_size; ++i) {
+        float const *neuron = neuronProjections + static_cast<size_t>(i) * numberOfComponents;
+        float *pscores = scores + static_cast<size_t>(i) * numberOfRotations;
+        int j = 0;
+        for (; j <= numberOfRotations - NR; j += NR) {
+            float const *images[NR];
+            for (int r = 0; r < NR; ++r) images[r] = imageProjections + static_cast<size_t>(j + r) * numberOfComponents;
+            euclideanDistanceTile<1, NR>(&neuron, images, numberOfComponents, pscores + j);
+        }
+        for (; j < numberOfRotations; ++j) {
+            float const *image = imageProjections + static_cast<size_t>(j) * numberOfComponents;
+            euclideanDistanceTile<1, 1>(&neuron, &image, numberOfComponents, pscores + j);
+        }
+    }
+}
+
+} // namespace pink
@@ -0,0 +1,32 @@
+/**
+ * @file   SelfOrganizingMapLib/ProjectedDistance.h
+ * @brief  Approximate euclidean distances in the subspace of the principal components.
+ * @date   Oct 18, 2026
+ */
+
+#pragma once
+
+namespace pink {
+
+/**
+ * @brief Orthonormal basis of the leading principal components computed by subspace iteration.
+ *
+ * The data are centered by their mean. Component c of pixel p is stored at basis[p * numberOfComponents + c].
+ */
+void calculatePrincipalComponents(float *basis, float const *data, int numberOfVectors, int dim,
+    int numberOfComponents, int numberOfIterations = 8, int seed = 1234);
+
+//! Coordinates of the images in the basis, stored at projections[image * numberOfComponents + c].
+void projectImages(float *projections, float const *basis, float const *images, int numberOfImages, int dim,
+    int numberOfComponents);
+
+/**
+ * @brief Squared euclidean distances of all projected neurons and rotated images.
+ *
+ * The distance in the subspace is a lower bound of the full distance. The score of neuron i
+ * and rotation j is stored at scores[i * numberOfRotations + j].
+ */
+void generateProjectedScores(float *scores, float const *neuronProjections, int som_size,
+    float const *imageProjections, int numberOfRotations, int numberOfComponents);
+
+} // namespace pink
@@ -0,0 +1,159 @@
+/**
+ * @file   SelfOrganizingMapLib/QuantizedDistance.cpp
+ * @brief  Approximate euclidean distances of int8 quantized images.
+ * @date   Oct 18, 2026
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define PINK_INT8_AVX2
+#endif
+
+#include "QuantizedDistance.h"
+
+namespace pink {
+
+void QuantizedImages::quantize(float const *images, int numberOfImages, int image_size)
+{
+    this->numberOfImages = numberOfImages;
+    this->image_size = image_size;
+    data.resize(static_cast<size_t>(numberOfImages) * image_size);
+    scale.resize(numberOfImages);
+    squaredNorm.resize(numberOfImages);
+
+    #pragma omp parallel for
+    for (int i = 0; i < numberOfImages; ++i) {
+        quantizeImage(images + static_cast<size_t>(i) * image_size, i);
+    }
+}
+
+void QuantizedImages::quantizeImage(float const *image, int i)
+{
+    // Local size, the int8 stores may alias the members
+    const int size = image_size;
+
+    float maxAbs = 0.0;
+    float norm = 0.0;
+    #pragma omp simd reduction(max:maxAbs) reduction(+:norm)
+    for (int p = 0; p < size; ++p) {
+        float a = std::fabs(image[p]);
+        maxAbs = a > maxAbs ? a : maxAbs;
+        norm += image[p] * image[p];
+    }
+
+    float inverse = maxAbs > 0.0 ? 127 / maxAbs : 0.0;
+    int8_t *q = &data[static_cast<size_t>(i) * size];
+    for (int p = 0; p < size; ++p) {
+        // Round half away from zero, vectorizable in contrast to lrint
+        float x = image[p] * inverse;
+        q[p] = static_cast<int8_t>(static_cast<int>(x + std::copysign(0.5f, x)));
+    }
+
+    scale[i] = maxAbs / 127;
+    squaredNorm[i] = norm;
+}
+
+int32_t dotProductInt8Scalar(int8_t const *a, int8_t const *b, int length)
+{
+    int32_t c = 0;
+    for (int i = 0; i < length; ++i) c += a[i] * b[i];
+    return c;
+}
+
+#ifdef PINK_INT8_AVX2
+
+namespace {
+
+__attribute__((target("avx2")))
+int32_t dotProductInt8AVX2(int8_t const *a, int8_t const *b, int length)
+{
+    // Values are within [-127,127], the pairwise int16 sums of maddubs can not saturate
+    __m256i sum = _mm256_setzero_si256();
+    __m256i ones = _mm256_set1_epi16(1);
+    int i = 0;
+    for (; i <= length - 32; i += 32) {
+        __m256i va = _mm256_loadu_si256((__m256i const*)(a + i));
+        __m256i vb = _mm256_loadu_si256((__m256i const*)(b + i));
+        __m256i products = _mm256_maddubs_epi16(_mm256_abs_epi8(va), _mm256_sign_epi8(vb, va));
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(products, ones));
+    }
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4e));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xb1));
+    return _mm_cvtsi128_si32(s) + dotProductInt8Scalar(a + i, b + i, length - i);
+}
+
+//! Dot products of a with four vectors b, each pixel of a is loaded once.
+__attribute__((target("avx2")))
+void dotProductInt8x4AVX2(int8_t const *a, int8_t const * const *b, int length, int32_t *result)
+{
+    __m256i sum[4] = {_mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256()};
+    __m256i ones = _mm256_set1_epi16(1);
+    int i = 0;
+    for (; i <= length - 32; i += 32) {
+        __m256i va = _mm256_loadu_si256((__m256i const*)(a + i));
+        __m256i absa = _mm256_abs_epi8(va);
+        for (int r = 0; r < 4; ++r) {
+            __m256i vb = _mm256_loadu_si256((__m256i const*)(b[r] + i));
+            __m256i products = _mm256_maddubs_epi16(absa, _mm256_sign_epi8(vb, va));
+            sum[r] = _mm256_add_epi32(sum[r], _mm256_madd_epi16(products, ones));
+        }
+    }
+    for (int r = 0; r < 4; ++r) {
+        __m128i s = _mm_add_epi32(_mm256_castsi256_si128(sum[r]), _mm256_extracti128_si256(sum[r], 1));
+        s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4e));
+        s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xb1));
+        result[r] = _mm_cvtsi128_si32(s) + dotProductInt8Scalar(a + i, b[r] + i, length - i);
+    }
+}
+
+const bool hasAVX2 = __builtin_cpu_supports("avx2");
+
+} // anonymous namespace
+
+#endif
+
+int32_t dotProductInt8(int8_t const *a, int8_t const *b, int length)
+{
+#ifdef PINK_INT8_AVX2
+    if (hasAVX2) return dotProductInt8AVX2(a, b, length);
+#endif
+    return dotProductInt8Scalar(a, b, length);
+}
+
+void generateQuantizedScores(float *scores, QuantizedImages const& som, QuantizedImages const& rotatedImages)
+{
+    int image_size = som.image_size;
+    int numberOfRotations = rotatedImages.numberOfImages;
+
+    #pragma omp parallel for
+    for (int i = 0; i < som.numberOfImages; ++i) {
+        int8_t const *neuron = &som.data[static_cast<size_t>(i) * image_size];
+        float *pscores = scores + static_cast<size_t>(i) * numberOfRotations;
+        int32_t dot[4];
+        int j = 0;
+#ifdef PINK_INT8_AVX2
+        if (hasAVX2) {
+            for (; j <= numberOfRotations - 4; j += 4) {
+                int8_t const *images[4];
+                for (int r = 0; r < 4; ++r) images[r] = &rotatedImages.data[static_cast<size_t>(j + r) * image_size];
+                dotProductInt8x4AVX2(neuron, images, image_size, dot);
+                for (int r = 0; r < 4; ++r) {
+                    pscores[j + r] = som.squaredNorm[i] + rotatedImages.squaredNorm[j + r]
+                        - 2 * som.scale[i] * rotatedImages.scale[j + r] * dot[r];
+                }
+            }
+        }
+#endif
+        for (; j < numberOfRotations; ++j) {
+            dot[0] = dotProductInt8(neuron, &rotatedImages.data[static_cast<size_t>(j) * image_size], image_size);
+            pscores[j] = som.squaredNorm[i] + rotatedImages.squaredNorm[j]
+                - 2 * som.scale[i] * rotatedImages.scale[j] * dot[0];
+        }
+    }
+}
+
+} // namespace pink
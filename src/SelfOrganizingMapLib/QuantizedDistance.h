@@ -0,0 +1,51 @@
+/**
+ * @file   SelfOrganizingMapLib/QuantizedDistance.h
+ * @brief  Approximate euclidean distances of int8 quantized images.
+ * @date   Oct 18, 2026
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace pink {
+
+/**
+ * @brief Images quantized to int8 with one symmetric scale per image.
+ *
+ * Pixel p of image i is approximated by scale[i] * data[i * image_size + p].
+ * The squared norms are calculated from the unquantized images.
+ */
+struct QuantizedImages
+{
+    QuantizedImages() : numberOfImages(0), image_size(0) {}
+
+    //! Quantize images, the memory is reused if the sizes are unchanged.
+    void quantize(float const *images, int numberOfImages, int image_size);
+
+    //! Quantize only image i, the sizes must be set by @quantize before.
+    void quantizeImage(float const *image, int i);
+
+    int numberOfImages;
+    int image_size;
+    std::vector<int8_t> data;
+    std::vector<float> scale;
+    std::vector<float> squaredNorm;
+};
+
+//! Dot product of two int8 vectors, AVX2 is used if supported by the CPU. The result is exact.
+int32_t dotProductInt8(int8_t const *a, int8_t const *b, int length);
+
+//! Same as @dotProductInt8 without SIMD intrinsics.
+int32_t dotProductInt8Scalar(int8_t const *a, int8_t const *b, int length);
+
+/**
+ * @brief Approximate squared euclidean distances of all neurons and rotated images.
+ *
+ * |a - b|^2 = |a|^2 + |b|^2 - 2 a.b, where the dot product is calculated with int8 values.
+ * The score of neuron i and rotation j is stored at scores[i * numberOfRotations + j].
+ */
+void generateQuantizedScores(float *scores, QuantizedImages const& som, QuantizedImages const& rotatedImages);
+
+} // namespace pink
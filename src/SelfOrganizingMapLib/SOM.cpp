@@ -5,11 +5,14 @@
  * @author Bernd Doser, HITS gGmbH
  */
 
+#include <algorithm>
 #include <cmath>
 #include <fstream>
 #include <iostream>
 #include <iomanip>
 
+#include "ProjectedDistance.h"
+#include "SelfOrganizingMap.h"
 #include "SOM.h"
 #include "UtilitiesLib/Error.h"
 #include "UtilitiesLib/Filler.h"
@@ -19,6 +22,13 @@ namespace pink {
 SOM::SOM(InputData const& inputData)
  : inputData_(inputData),
    som_(inputData.numberOfChannels * inputData.som_size * inputData.neuron_size),
+   useFusedRotation_(inputData.rotationLayout == RotationLayout::BLOCKED and !inputData.annTopK
+       and inputData.orientationWindow <= 0.0 and inputData.prefilter == Prefilter::OFF
+       and inputData.storage == StorageType::FLOAT32 and inputData.interpolation != Interpolation::SHEAR
+       and inputData.additionalSOMFilenames.empty()
+       and useFusedRotation(inputData.som_size, inputData.numberOfRotations, inputData.useFlip,
+           inputData.neuron_dim, inputData.numberOfChannels)),
+   pcaUpdateCount_(0),
    updateCounterMatrix_(inputData.som_size)
 {
     // Initialize SOM
@@ -37,12 +47,15 @@ SOM::SOM(InputData const& inputData)
         std::ifstream is(inputData.somFilename);
         if (!is) throw std::runtime_error("Error opening " + inputData.somFilename);
 
-        // Skip all header lines starting with #
+        // Skip all header lines starting with #, the storage line marks a compact SOM
+        StorageType fileStorage = StorageType::FLOAT32;
         std::string line;
         int last_position = is.tellg();
         while (std::getline(is, line)) {
             if (line[0] != '#') break;
-            header_ += line + '\n';
+            if (line == "# storage: bfloat16") fileStorage = StorageType::BFLOAT16;
+            else if (line == "# storage: float16") fileStorage = StorageType::FLOAT16;
+            else header_ += line + '\n';
         	last_position = is.tellg();
         }
 
@@ -60,8 +73,18 @@ SOM::SOM(InputData const& inputData)
         if (tmp != inputData.neuron_dim) throw std::runtime_error("readSOM: wrong neuron_dim.");
         is.read((char*)&tmp, sizeof(int));
         if (tmp != inputData.neuron_dim) throw std::runtime_error("readSOM: wrong neuron_dim.");
-        is.read((char*)&som_[0], inputData.numberOfChannels * inputData.som_size * inputData.neuron_dim
-            * inputData.neuron_dim * sizeof(float));
+        if (fileStorage == StorageType::BFLOAT16) {
+            std::vector<bfloat16> data(som_.size());
+            is.read((char*)&data[0], data.size() * sizeof(bfloat16));
+            convertToFloat(&som_[0], &data[0], som_.size());
+        } else if (fileStorage == StorageType::FLOAT16) {
+            std::vector<float16> data(som_.size());
+            is.read((char*)&data[0], data.size() * sizeof(float16));
+            convertToFloat(&som_[0], &data[0], som_.size());
+        } else {
+            is.read((char*)&som_[0], inputData.numberOfChannels * inputData.som_size * inputData.neuron_dim
+                * inputData.neuron_dim * sizeof(float));
+        }
     } else
         fatalError("Unknown initType.");
 
@@ -97,6 +120,28 @@ SOM::SOM(InputData const& inputData)
     } else {
         fatalError("Unknown layout.");
     }
+
+    // Reduced precision storage
+    if (inputData_.storage == StorageType::BFLOAT16) somBFloat16_.resize(som_.size());
+    else if (inputData_.storage == StorageType::FLOAT16) somFloat16_.resize(som_.size());
+    for (int i = 0; i < inputData_.som_size; ++i) updateCompactNeuron(i);
+
+    // Mapping uses only the reduced precision copy
+    if (inputData_.executionPath == ExecutionPath::MAP and inputData_.storage != StorageType::FLOAT32) {
+        som_.clear();
+        som_.shrink_to_fit();
+    }
+
+    // Integer input images are rotated in fixed point
+    if (!useFusedRotation_ and inputData_.rotationLayout == RotationLayout::BLOCKED
+        and inputData_.interpolation == Interpolation::BILINEAR and inputData_.numberOfRotations % 4 == 0
+        and (inputData_.imagePixelType == PixelType::UINT8 or inputData_.imagePixelType == PixelType::UINT16)) {
+        fixedPointRotations_ = fixedPointRotations(inputData_.numberOfRotations, inputData_.image_dim, inputData_.neuron_dim);
+    }
+
+    if (inputData_.prefilter == Prefilter::INT8) {
+        quantizedSom_.quantize(&som_[0], inputData_.som_size, inputData_.numberOfChannels * inputData_.neuron_size);
+    }
 }
 
 void SOM::write(std::string const& filename) const
@@ -105,14 +150,22 @@ void SOM::write(std::string const& filename) const
     if (!os) throw std::runtime_error("Error opening " + filename);
 
     os << header_;
+    if (inputData_.writeCompactSOM) os << "# storage: " << inputData_.storage << "\n";
     os.write((char*)&inputData_.numberOfChannels, sizeof(int));
     os.write((char*)&inputData_.som_width, sizeof(int));
     os.write((char*)&inputData_.som_height, sizeof(int));
     os.write((char*)&inputData_.som_depth, sizeof(int));
     os.write((char*)&inputData_.neuron_dim, sizeof(int));
     os.write((char*)&inputData_.neuron_dim, sizeof(int));
-    os.write((char*)&som_[0], inputData_.numberOfChannels * inputData_.som_size
-        * inputData_.neuron_dim * inputData_.neuron_dim * sizeof(float));
+
+    if (inputData_.writeCompactSOM and inputData_.storage == StorageType::BFLOAT16) {
+        os.write((char*)&somBFloat16_[0], somBFloat16_.size() * sizeof(bfloat16));
+    } else if (inputData_.writeCompactSOM and inputData_.storage == StorageType::FLOAT16) {
+        os.write((char*)&somFloat16_[0], somFloat16_.size() * sizeof(float16));
+    } else {
+        os.write((char*)&som_[0], inputData_.numberOfChannels * inputData_.som_size
+            * inputData_.neuron_dim * inputData_.neuron_dim * sizeof(float));
+    }
 }
 
 void SOM::updateNeurons(float *rotatedImages, int bestMatch, int *bestRotationMatrix)
@@ -120,15 +173,213 @@ void SOM::updateNeurons(float *rotatedImages, int bestMatch, int *bestRotationMa
     float distance, factor;
     float *current_neuron = &som_[0];
 
+    // Offset between two rotated images and between two pixels
+    int rotationOffset = inputData_.numberOfChannels * inputData_.neuron_size;
+    int stride = 1;
+    if (inputData_.rotationLayout == RotationLayout::INTERLEAVED) {
+        rotationOffset = 1;
+        stride = interleavedStride(inputData_.numberOfRotationsAndFlip);
+    }
+
+    // The dihedral layout and the fused kernel materialize the best rotated image of each updated neuron
+    std::vector<float> bestRotatedImage;
+    if (inputData_.rotationLayout == RotationLayout::DIHEDRAL or useFusedRotation_) bestRotatedImage.resize(rotationOffset);
+
     for (int i = 0; i < inputData_.som_size; ++i) {
         distance = (*ptrDistanceFunctor_)(bestMatch, i);
         if (inputData_.maxUpdateDistance <= 0.0 or distance < inputData_.maxUpdateDistance) {
             factor = (*ptrDistributionFunctor_)(distance) * inputData_.damping;
-            updateSingleNeuron(current_neuron, rotatedImages + bestRotationMatrix[i]
-                * inputData_.numberOfChannels * inputData_.neuron_size, factor);
+            if (useFusedRotation_) {
+                generateRotatedImage(&bestRotatedImage[0], rotatedImages, bestRotationMatrix[i],
+                    inputData_.numberOfRotations, inputData_.image_dim, inputData_.neuron_dim,
+                    inputData_.interpolation, inputData_.numberOfChannels);
+                updateSingleNeuron(current_neuron, &bestRotatedImage[0], factor);
+            } else if (inputData_.rotationLayout == RotationLayout::DIHEDRAL) {
+                generateDihedralImage(&bestRotatedImage[0], rotatedImages, bestRotationMatrix[i],
+                    inputData_.numberOfRotations, inputData_.neuron_dim, inputData_.numberOfChannels);
+                updateSingleNeuron(current_neuron, &bestRotatedImage[0], factor);
+            } else
+                updateSingleNeuron(current_neuron, rotatedImages + bestRotationMatrix[i] * rotationOffset, factor, stride);
+            updateCompactNeuron(i);
         }
         current_neuron += inputData_.numberOfChannels * inputData_.neuron_size;
     }
+
+    if (!pcaBasis_.empty()) {
+        projectImages(&pcaNeuronProjections_[0], &pcaBasis_[0], &som_[0], inputData_.som_size,
+            inputData_.numberOfChannels * inputData_.neuron_size, pcaNeuronProjections_.size() / inputData_.som_size);
+        ++pcaUpdateCount_;
+    }
+}
+
+void SOM::getRotatedImage(float *dest, float *rotatedImages, int rotation) const
+{
+    const int size = inputData_.numberOfChannels * inputData_.neuron_size;
+
+    if (useFusedRotation_) {
+        generateRotatedImage(dest, rotatedImages, rotation, inputData_.numberOfRotations, inputData_.image_dim,
+            inputData_.neuron_dim, inputData_.interpolation, inputData_.numberOfChannels);
+    } else if (inputData_.rotationLayout == RotationLayout::DIHEDRAL) {
+        generateDihedralImage(dest, rotatedImages, rotation, inputData_.numberOfRotations,
+            inputData_.neuron_dim, inputData_.numberOfChannels);
+    } else if (inputData_.rotationLayout == RotationLayout::INTERLEAVED) {
+        const int stride = interleavedStride(inputData_.numberOfRotationsAndFlip);
+        for (int i = 0; i < size; ++i) dest[i] = rotatedImages[i * stride + rotation];
+    } else {
+        std::copy(rotatedImages + rotation * size, rotatedImages + (rotation + 1) * size, dest);
+    }
+}
+
+int SOM::getRotatedImagesSize() const
+{
+    if (useFusedRotation_)
+        return inputData_.numberOfChannels * inputData_.image_size;
+    if (inputData_.rotationLayout == RotationLayout::INTERLEAVED)
+        return inputData_.numberOfChannels * inputData_.neuron_size * interleavedStride(inputData_.numberOfRotationsAndFlip);
+    if (inputData_.rotationLayout == RotationLayout::DIHEDRAL)
+        return inputData_.numberOfChannels * inputData_.neuron_size * dihedralNumberOfImages(inputData_.numberOfRotations);
+    return inputData_.numberOfChannels * inputData_.neuron_size * inputData_.numberOfRotationsAndFlip;
+}
+
+void SOM::computeRotatedImages(float *rotatedImages, float *image)
+{
+    if (useFusedRotation_) {
+        std::copy(image, image + inputData_.numberOfChannels * inputData_.image_size, rotatedImages);
+    } else if (inputData_.rotationLayout == RotationLayout::INTERLEAVED) {
+        generateRotatedImagesInterleaved(rotatedImages, image, inputData_.numberOfRotations,
+            inputData_.image_dim, inputData_.neuron_dim, inputData_.useFlip, inputData_.interpolation,
+            inputData_.numberOfChannels);
+    } else if (inputData_.rotationLayout == RotationLayout::DIHEDRAL) {
+        generateRotatedImagesDihedral(rotatedImages, image, inputData_.numberOfRotations,
+            inputData_.image_dim, inputData_.neuron_dim, inputData_.interpolation, inputData_.numberOfChannels);
+    } else {
+        generateRotatedImages(rotatedImages, image, inputData_.numberOfRotations,
+            inputData_.image_dim, inputData_.neuron_dim, inputData_.useFlip, inputData_.interpolation,
+            inputData_.numberOfChannels);
+    }
+}
+
+void SOM::computeRotatedImages(float *rotatedImages, ImageIterator<float> const& iterImage)
+{
+    char const *rawImage = iterImage.getRawPixel();
+    float *image = iterImage->getPointerOfFirstPixel();
+
+    if (fixedPointRotations_.empty() or !rawImage) {
+        computeRotatedImages(rotatedImages, image);
+    } else if (iterImage.getPixelType() == PixelType::UINT8) {
+        generateRotatedImages(rotatedImages, image, reinterpret_cast<uint8_t const*>(rawImage),
+            iterImage.getScale(), iterImage.getOffset(), fixedPointRotations_, inputData_.numberOfRotations,
+            inputData_.image_dim, inputData_.neuron_dim, inputData_.useFlip, inputData_.numberOfChannels);
+    } else if (iterImage.getPixelType() == PixelType::UINT16) {
+        generateRotatedImages(rotatedImages, image, reinterpret_cast<uint16_t const*>(rawImage),
+            iterImage.getScale(), iterImage.getOffset(), fixedPointRotations_, inputData_.numberOfRotations,
+            inputData_.image_dim, inputData_.neuron_dim, inputData_.useFlip, inputData_.numberOfChannels);
+    } else {
+        computeRotatedImages(rotatedImages, image);
+    }
+}
+
+void SOM::computeDistances(float *euclideanDistanceMatrix, int *bestRotationMatrix, float *rotatedImages)
+{
+    int image_size = inputData_.numberOfChannels * inputData_.neuron_size;
+
+    if (useFusedRotation_) {
+        generateEuclideanDistanceMatrixFused(euclideanDistanceMatrix, bestRotationMatrix,
+            inputData_.som_size, &som_[0], rotatedImages, inputData_.numberOfRotations, inputData_.image_dim,
+            inputData_.neuron_dim, inputData_.useFlip, inputData_.interpolation, inputData_.numberOfChannels);
+    } else if (inputData_.rotationLayout == RotationLayout::INTERLEAVED) {
+        generateEuclideanDistanceMatrixInterleaved(euclideanDistanceMatrix, bestRotationMatrix,
+            inputData_.som_size, &som_[0], image_size, inputData_.numberOfRotationsAndFlip, rotatedImages);
+    } else if (inputData_.rotationLayout == RotationLayout::DIHEDRAL) {
+        generateEuclideanDistanceMatrixDihedral(euclideanDistanceMatrix, bestRotationMatrix,
+            inputData_.som_size, &som_[0], inputData_.neuron_dim, inputData_.numberOfChannels,
+            inputData_.numberOfRotations, inputData_.useFlip, rotatedImages, inputData_.distanceTile);
+    } else if (inputData_.orientationWindow > 0.0) {
+        // The first rotated image is the unrotated cropped image
+        PrincipalAxis imageAxis = calculatePrincipalAxis(rotatedImages, inputData_.neuron_dim, inputData_.numberOfChannels);
+        generateEuclideanDistanceMatrixWithPrincipalAxes(euclideanDistanceMatrix, bestRotationMatrix,
+            inputData_.som_size, &som_[0], image_size, inputData_.numberOfRotations, inputData_.useFlip,
+            rotatedImages, imageAxis, &neuronPrincipalAxes_[0], inputData_.orientationWindow, inputData_.minAnisotropy);
+    } else if (inputData_.prefilter == Prefilter::INT8) {
+        quantizedRotatedImages_.quantize(rotatedImages, inputData_.numberOfRotationsAndFlip, image_size);
+        prefilterScores_.resize(inputData_.som_size * inputData_.numberOfRotationsAndFlip);
+        generateQuantizedScores(&prefilterScores_[0], quantizedSom_, quantizedRotatedImages_);
+        generateEuclideanDistanceMatrixFromCandidates(euclideanDistanceMatrix, bestRotationMatrix,
+            inputData_.som_size, &som_[0], image_size, inputData_.numberOfRotationsAndFlip, rotatedImages,
+            &prefilterScores_[0], inputData_.rerankCandidates);
+    } else if (inputData_.prefilter == Prefilter::PCA) {
+        if (pcaBasis_.empty() or (inputData_.pcaRefresh and pcaUpdateCount_ >= inputData_.pcaRefresh))
+            updatePrincipalComponents(rotatedImages);
+        int numberOfComponents = pcaBasis_.size() / image_size;
+        pcaImageProjections_.resize(inputData_.numberOfRotationsAndFlip * numberOfComponents);
+        projectImages(&pcaImageProjections_[0], &pcaBasis_[0], rotatedImages, inputData_.numberOfRotationsAndFlip,
+            image_size, numberOfComponents);
+        prefilterScores_.resize(inputData_.som_size * inputData_.numberOfRotationsAndFlip);
+        generateProjectedScores(&prefilterScores_[0], &pcaNeuronProjections_[0], inputData_.som_size,
+            &pcaImageProjections_[0], inputData_.numberOfRotationsAndFlip, numberOfComponents);
+        generateEuclideanDistanceMatrixFromCandidates(euclideanDistanceMatrix, bestRotationMatrix,
+            inputData_.som_size, &som_[0], image_size, inputData_.numberOfRotationsAndFlip, rotatedImages,
+            &prefilterScores_[0], inputData_.rerankCandidates);
+    } else if (inputData_.storage == StorageType::BFLOAT16) {
+        generateEuclideanDistanceMatrix(euclideanDistanceMatrix, bestRotationMatrix,
+            inputData_.som_size, &somBFloat16_[0], image_size, inputData_.numberOfRotationsAndFlip,
+            rotatedImages, inputData_.distanceTile);
+    } else if (inputData_.storage == StorageType::FLOAT16) {
+        generateEuclideanDistanceMatrix(euclideanDistanceMatrix, bestRotationMatrix,
+            inputData_.som_size, &somFloat16_[0], image_size, inputData_.numberOfRotationsAndFlip,
+            rotatedImages, inputData_.distanceTile);
+    } else {
+        generateEuclideanDistanceMatrix(euclideanDistanceMatrix, bestRotationMatrix,
+            inputData_.som_size, &som_[0], image_size, inputData_.numberOfRotationsAndFlip, rotatedImages,
+            inputData_.distanceTile);
+    }
+}
+
+void SOM::computeBestMatches(BestMatch *bestMatches, float *euclideanDistanceMatrix, int *bestRotationMatrix,
+    float *rotatedImages)
+{
+    if (!useFusedRotation_ and inputData_.rotationLayout == RotationLayout::BLOCKED and inputData_.orientationWindow <= 0.0
+        and inputData_.prefilter == Prefilter::OFF and inputData_.storage == StorageType::FLOAT32) {
+        generateBestMatchingNeurons(bestMatches, inputData_.resultTopK, inputData_.som_size, &som_[0],
+            inputData_.numberOfChannels * inputData_.neuron_size, inputData_.numberOfRotationsAndFlip, rotatedImages,
+            inputData_.distanceTile);
+    } else {
+        computeDistances(euclideanDistanceMatrix, bestRotationMatrix, rotatedImages);
+        findBestMatchingNeurons(bestMatches, inputData_.resultTopK, euclideanDistanceMatrix, bestRotationMatrix,
+            inputData_.som_size);
+    }
+}
+
+void SOM::updatePrincipalAxes()
+{
+    int image_size = inputData_.numberOfChannels * inputData_.neuron_size;
+    neuronPrincipalAxes_.resize(inputData_.som_size);
+
+    #pragma omp parallel for
+    for (int i = 0; i < inputData_.som_size; ++i) {
+        neuronPrincipalAxes_[i] = calculatePrincipalAxis(&som_[i * image_size], inputData_.neuron_dim,
+            inputData_.numberOfChannels);
+    }
+}
+
+void SOM::updatePrincipalComponents(float *rotatedImages)
+{
+    int image_size = inputData_.numberOfChannels * inputData_.neuron_size;
+    int numberOfComponents = std::min(inputData_.pcaComponents, image_size);
+
+    // Sample of neurons and rotated images
+    std::vector<float> data(som_);
+    data.insert(data.end(), rotatedImages, rotatedImages + inputData_.numberOfRotationsAndFlip * image_size);
+
+    pcaBasis_.resize(image_size * numberOfComponents);
+    calculatePrincipalComponents(&pcaBasis_[0], &data[0], inputData_.som_size + inputData_.numberOfRotationsAndFlip,
+        image_size, numberOfComponents, 8, inputData_.seed);
+
+    pcaNeuronProjections_.resize(inputData_.som_size * numberOfComponents);
+    projectImages(&pcaNeuronProjections_[0], &pcaBasis_[0], &som_[0], inputData_.som_size, image_size,
+        numberOfComponents);
+
+    pcaUpdateCount_ = 0;
 }
 
 void SOM::printUpdateCounter() const
@@ -157,11 +408,20 @@ void SOM::printUpdateCounter() const
     }
 }
 
-void SOM::updateSingleNeuron(float *neuron, float *image, float factor)
+void SOM::updateSingleNeuron(float *neuron, float *image, float factor, int stride)
 {
     for (int i = 0; i < inputData_.numberOfChannels * inputData_.neuron_size; ++i) {
-        neuron[i] -= (neuron[i] - image[i]) * factor;
+        neuron[i] -= (neuron[i] - image[i * stride]) * factor;
     }
 }
 
+void SOM::updateCompactNeuron(int neuron)
+{
+    int image_size = inputData_.numberOfChannels * inputData_.neuron_size;
+    if (inputData_.storage == StorageType::BFLOAT16)
+        convertFromFloat(&somBFloat16_[neuron * image_size], &som_[neuron * image_size], image_size);
+    else if (inputData_.storage == StorageType::FLOAT16)
+        convertFromFloat(&somFloat16_[neuron * image_size], &som_[neuron * image_size], image_size);
+}
+
 } // namespace pink
@@ -11,8 +11,14 @@
 #include <memory>
 #include <vector>
 
+#include "ImageProcessingLib/FixedPointRotation.h"
+#include "ImageProcessingLib/ImageIterator.h"
+#include "ImageProcessingLib/ImageProcessing.h"
+#include "QuantizedDistance.h"
+#include "SelfOrganizingMap.h"
 #include "UtilitiesLib/DistanceFunctor.h"
 #include "UtilitiesLib/DistributionFunctor.h"
+#include "UtilitiesLib/HalfPrecision.h"
 #include "UtilitiesLib/InputData.h"
 
 using myclock = std::chrono::steady_clock;
@@ -28,6 +34,7 @@ public:
 
     SOM(InputData const& inputData);
 
+    //! Write SOM as float, or with the precision of the storage type if compact SOM is selected.
     void write(std::string const& filename) const;
 
     int getSize() const { return som_.size(); }
@@ -57,20 +64,83 @@ public:
     //! Print matrix of SOM updates.
     void printUpdateCounter() const;
 
+    //! Number of floats needed for the rotated images of one input image, or the input image itself for the fused kernel.
+    int getRotatedImagesSize() const;
+
+    //! Generate rotated and flipped images in the selected layout, the fused kernel only copies the input image.
+    void computeRotatedImages(float *rotatedImages, float *image);
+
+    //! Same as above for the current image, integer images are rotated from the stored pixels in fixed point.
+    void computeRotatedImages(float *rotatedImages, ImageIterator<float> const& iterImage);
+
+    //! Copy rotated image rotation of @computeRotatedImages into dest, independent of the layout.
+    void getRotatedImage(float *dest, float *rotatedImages, int rotation) const;
+
+    //! Euclidean distances and best rotations of all neurons for the given rotated images.
+    void computeDistances(float *euclideanDistanceMatrix, int *bestRotationMatrix, float *rotatedImages);
+
+    /**
+     * @brief The resultTopK best matching neurons for the given rotated images.
+     *
+     * For the blocked layout without prefilter the distances are calculated by @generateBestMatchingNeurons,
+     * otherwise the best matches are selected from @computeDistances using the given matrices.
+     */
+    void computeBestMatches(BestMatch *bestMatches, float *euclideanDistanceMatrix, int *bestRotationMatrix,
+        float *rotatedImages);
+
+    //! Calculate principal axes of all neurons, needed for orientation prior.
+    void updatePrincipalAxes();
+
 private:
 
-    //! Updating one single neuron.
-    void updateSingleNeuron(float *neuron, float *image, float factor);
+    //! Updating one single neuron, the pixels of the image are separated by stride.
+    void updateSingleNeuron(float *neuron, float *image, float factor, int stride = 1);
+
+    //! Copy neuron into the reduced precision storage.
+    void updateCompactNeuron(int neuron);
+
+    //! Calculate principal components of the neurons and the rotations of one image and project the neurons.
+    void updatePrincipalComponents(float *rotatedImages);
 
     InputData const& inputData_;
 
     //! The real self organizing matrix.
     std::vector<float> som_;
 
+    //! Reduced precision copies of the SOM used for the distances, the updates use som_.
+    //! som_ is released after the conversion for mapping.
+    std::vector<bfloat16> somBFloat16_;
+    std::vector<float16> somFloat16_;
+
+    //! Quantized SOM and rotated images for the int8 prefilter.
+    QuantizedImages quantizedSom_;
+    QuantizedImages quantizedRotatedImages_;
+
+    //! Principal components and projections of neurons and rotated images for the PCA prefilter.
+    std::vector<float> pcaBasis_;
+    std::vector<float> pcaNeuronProjections_;
+    std::vector<float> pcaImageProjections_;
+
+    //! Rotated images are sampled within the distance kernel, only the input image is stored.
+    //! Not used if several SOMs are mapped, they share the rotated images.
+    bool useFusedRotation_;
+
+    //! Bilinear rotations of integer input images, empty for float input.
+    std::vector<FixedPointRotation> fixedPointRotations_;
+
+    //! Number of SOM updates since the principal components were calculated.
+    int pcaUpdateCount_;
+
+    //! Approximate distances of all neurons and rotations.
+    std::vector<float> prefilterScores_;
+
     std::shared_ptr<DistributionFunctorBase> ptrDistributionFunctor_;
 
     std::shared_ptr<DistanceFunctorBase> ptrDistanceFunctor_;
 
+    //! Principal axes of all neurons
+    std::vector<PrincipalAxis> neuronPrincipalAxes_;
+
     // Counting updates of each neuron
     std::vector<int> updateCounterMatrix_;
 
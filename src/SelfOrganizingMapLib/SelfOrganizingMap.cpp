@@ -7,7 +7,10 @@
 
 #include "ImageProcessingLib/Image.h"
 #include "ImageProcessingLib/ImageProcessing.h"
+#include "EuclideanDistanceTile.h"
 #include "SelfOrganizingMap.h"
+#include "UtilitiesLib/Error.h"
+#include <algorithm>
 #include <cmath>
 #include <ctype.h>
 #include <float.h>
@@ -16,44 +19,45 @@
 #include <omp.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#include <vector>
 
 namespace pink {
 
-void generateRotatedImages(float *rotatedImages, float *image, int num_rot, int image_dim, int neuron_dim,
-    bool useFlip, Interpolation interpolation, int numberOfChannels)
+namespace {
+
+/**
+ * Blocked layout of @generateRotatedImages, rotateChannel(dest, i, c) writes channel c
+ * of the input image rotated by i angle steps to dest for 0 < i < num_rot/4.
+ */
+template <class RotateChannel>
+void generateRotatedImagesBlocked(float *rotatedImages, float *image, int num_rot, int image_dim, int neuron_dim,
+    bool useFlip, int numberOfChannels, RotateChannel const& rotateChannel)
 {
-    int image_size = image_dim * image_dim;
     int neuron_size = neuron_dim * neuron_dim;
 
     int num_real_rot = num_rot/4;
-    float angleStepRadians = 2.0 * M_PI / num_rot;
 
     int offset1 = num_real_rot * numberOfChannels * neuron_size;
     int offset2 = 2 * offset1;
     int offset3 = 3 * offset1;
 
     // Copy original image to first position of image array
-    #pragma omp parallel for
-    for (int c = 0; c < numberOfChannels; ++c) {
-        float *currentImage = image + c*image_size;
-        float *currentRotatedImages = rotatedImages + c*neuron_size;
-        crop(image_dim, image_dim, neuron_dim, neuron_dim, currentImage, currentRotatedImages);
-        rotate_90degrees(neuron_dim, neuron_dim, currentRotatedImages, currentRotatedImages + offset1);
-        rotate_90degrees(neuron_dim, neuron_dim, currentRotatedImages + offset1, currentRotatedImages + offset2);
-        rotate_90degrees(neuron_dim, neuron_dim, currentRotatedImages + offset2, currentRotatedImages + offset3);
-    }
+    crop(image_dim, image_dim, neuron_dim, neuron_dim, image, rotatedImages, numberOfChannels);
+    rotate_90degrees(neuron_dim, neuron_dim, rotatedImages, rotatedImages + offset1, numberOfChannels);
+    rotate_90degrees(neuron_dim, neuron_dim, rotatedImages + offset1, rotatedImages + offset2, numberOfChannels);
+    rotate_90degrees(neuron_dim, neuron_dim, rotatedImages + offset2, rotatedImages + offset3, numberOfChannels);
 
     // Rotate images
     #pragma omp parallel for
     for (int i = 1; i < num_real_rot; ++i) {
+        float *currentRotatedImages = rotatedImages + i*numberOfChannels*neuron_size;
         for (int c = 0; c < numberOfChannels; ++c) {
-            float *currentImage = image + c*image_size;
-            float *currentRotatedImage = rotatedImages + (i*numberOfChannels + c)*neuron_size;
-            rotateAndCrop(image_dim, image_dim, neuron_dim, neuron_dim, currentImage, currentRotatedImage, i*angleStepRadians, interpolation);
-            rotate_90degrees(neuron_dim, neuron_dim, currentRotatedImage, currentRotatedImage + offset1);
-            rotate_90degrees(neuron_dim, neuron_dim, currentRotatedImage + offset1, currentRotatedImage + offset2);
-            rotate_90degrees(neuron_dim, neuron_dim, currentRotatedImage + offset2, currentRotatedImage + offset3);
+            rotateChannel(currentRotatedImages + c*neuron_size, i, c);
         }
+        rotate_90degrees(neuron_dim, neuron_dim, currentRotatedImages, currentRotatedImages + offset1, numberOfChannels);
+        rotate_90degrees(neuron_dim, neuron_dim, currentRotatedImages + offset1, currentRotatedImages + offset2, numberOfChannels);
+        rotate_90degrees(neuron_dim, neuron_dim, currentRotatedImages + offset2, currentRotatedImages + offset3, numberOfChannels);
     }
 
     // Flip images
@@ -63,36 +67,791 @@ void generateRotatedImages(float *rotatedImages, float *image, int num_rot, int
 
         #pragma omp parallel for
         for (int i = 0; i < num_rot; ++i) {
-            for (int c = 0; c < numberOfChannels; ++c) {
-                flip(neuron_dim, neuron_dim, rotatedImages + (i*numberOfChannels + c)*neuron_size,
-                    flippedRotatedImages + (i*numberOfChannels + c)*neuron_size);
+            flip(neuron_dim, neuron_dim, rotatedImages + i*numberOfChannels*neuron_size,
+                flippedRotatedImages + i*numberOfChannels*neuron_size, numberOfChannels);
+        }
+    }
+}
+
+template <class Pixel>
+void generateRotatedImagesFixedPoint(float *rotatedImages, float *image, Pixel const *rawImage, float scale,
+    float offset, std::vector<FixedPointRotation> const& rotations, int num_rot, int image_dim, int neuron_dim,
+    bool useFlip, int numberOfChannels)
+{
+    if (static_cast<int>(rotations.size()) + 1 < num_rot/4)
+        fatalError("generateRotatedImages: number of fixed point rotations does not fit.");
+
+    int image_size = image_dim * image_dim;
+    generateRotatedImagesBlocked(rotatedImages, image, num_rot, image_dim, neuron_dim, useFlip, numberOfChannels,
+        [&](float *dest, int i, int c) { rotations[i - 1].apply(rawImage + c*image_size, dest, scale, offset); });
+}
+
+} // anonymous namespace
+
+void generateRotatedImages(float *rotatedImages, float *image, int num_rot, int image_dim, int neuron_dim,
+    bool useFlip, Interpolation interpolation, int numberOfChannels)
+{
+    int image_size = image_dim * image_dim;
+    float angleStepRadians = 2.0 * M_PI / num_rot;
+
+    generateRotatedImagesBlocked(rotatedImages, image, num_rot, image_dim, neuron_dim, useFlip, numberOfChannels,
+        [&](float *dest, int i, int c) {
+            rotateAndCrop(image_dim, image_dim, neuron_dim, neuron_dim, image + c*image_size,
+                dest, i*angleStepRadians, interpolation);
+        });
+}
+
+std::vector<FixedPointRotation> fixedPointRotations(int numberOfRotations, int image_dim, int neuron_dim)
+{
+    float angleStepRadians = 2.0 * M_PI / numberOfRotations;
+
+    std::vector<FixedPointRotation> rotations;
+    for (int i = 1; i < numberOfRotations/4; ++i) {
+        rotations.push_back(FixedPointRotation(image_dim, image_dim, neuron_dim, neuron_dim, i*angleStepRadians));
+    }
+    return rotations;
+}
+
+void generateRotatedImages(float *rotatedImages, float *image, uint8_t const *rawImage, float scale, float offset,
+    std::vector<FixedPointRotation> const& rotations, int numberOfRotations, int image_dim, int neuron_dim,
+    bool useFlip, int numberOfChannels)
+{
+    generateRotatedImagesFixedPoint(rotatedImages, image, rawImage, scale, offset, rotations, numberOfRotations,
+        image_dim, neuron_dim, useFlip, numberOfChannels);
+}
+
+void generateRotatedImages(float *rotatedImages, float *image, uint16_t const *rawImage, float scale, float offset,
+    std::vector<FixedPointRotation> const& rotations, int numberOfRotations, int image_dim, int neuron_dim,
+    bool useFlip, int numberOfChannels)
+{
+    generateRotatedImagesFixedPoint(rotatedImages, image, rawImage, scale, offset, rotations, numberOfRotations,
+        image_dim, neuron_dim, useFlip, numberOfChannels);
+}
+
+void generateRotatedImagesInterleaved(float *rotatedImages, float *image, int num_rot, int image_dim, int neuron_dim,
+    bool useFlip, Interpolation interpolation, int numberOfChannels)
+{
+    int image_size = image_dim * image_dim;
+    int neuron_size = neuron_dim * neuron_dim;
+
+    int num_real_rot = num_rot == 1 ? 1 : num_rot/4;
+    int num_90degrees_rot = num_rot == 1 ? 1 : 4;
+    float angleStepRadians = 2.0 * M_PI / num_rot;
+    int stride = interleavedStride(useFlip ? 2 * num_rot : num_rot);
+
+    #pragma omp parallel for
+    for (int i = 0; i < num_real_rot; ++i) {
+        std::vector<float> current(neuron_size), previous(neuron_size), flipped(neuron_size);
+        for (int c = 0; c < numberOfChannels; ++c) {
+            float *currentImage = image + c*image_size;
+            if (i == 0) crop(image_dim, image_dim, neuron_dim, neuron_dim, currentImage, &current[0]);
+            else rotateAndCrop(image_dim, image_dim, neuron_dim, neuron_dim, currentImage, &current[0], i*angleStepRadians, interpolation);
+
+            for (int q = 0; q < num_90degrees_rot; ++q) {
+                if (q != 0) {
+                    current.swap(previous);
+                    rotate_90degrees(neuron_dim, neuron_dim, &previous[0], &current[0]);
+                }
+                float *dest = rotatedImages + c*neuron_size*stride + q*num_real_rot + i;
+                for (int p = 0; p < neuron_size; ++p) dest[p*stride] = current[p];
+
+                if (useFlip) {
+                    flip(neuron_dim, neuron_dim, &current[0], &flipped[0]);
+                    dest += num_rot;
+                    for (int p = 0; p < neuron_size; ++p) dest[p*stride] = flipped[p];
+                }
             }
         }
     }
 }
 
+void generateRotatedImagesDihedral(float *rotatedImages, float *image, int num_rot, int image_dim, int neuron_dim,
+    Interpolation interpolation, int numberOfChannels)
+{
+    int image_size = image_dim * image_dim;
+    int neuron_size = neuron_dim * neuron_dim;
+
+    int num_real_rot = dihedralNumberOfImages(num_rot);
+    float angleStepRadians = 2.0 * M_PI / num_rot;
+
+    #pragma omp parallel for
+    for (int i = 0; i < num_real_rot; ++i) {
+        for (int c = 0; c < numberOfChannels; ++c) {
+            float *currentImage = image + c*image_size;
+            float *currentRotatedImage = rotatedImages + (i*numberOfChannels + c)*neuron_size;
+            if (i == 0) crop(image_dim, image_dim, neuron_dim, neuron_dim, currentImage, currentRotatedImage);
+            else rotateAndCrop(image_dim, image_dim, neuron_dim, neuron_dim, currentImage, currentRotatedImage, i*angleStepRadians, interpolation);
+        }
+    }
+}
+
+void generateDihedralImage(float *dest, float const *rotatedImages, int rotation, int num_rot,
+    int neuron_dim, int numberOfChannels)
+{
+    int neuron_size = neuron_dim * neuron_dim;
+    int num_real_rot = dihedralNumberOfImages(num_rot);
+
+    bool flip = rotation >= num_rot;
+    int quarterTurns = (rotation % num_rot) / num_real_rot;
+    float const *source = rotatedImages + (rotation % num_rot % num_real_rot) * numberOfChannels * neuron_size;
+
+    for (int c = 0; c < numberOfChannels; ++c) {
+        for (int x = 0; x < neuron_dim; ++x) {
+            for (int y = 0; y < neuron_dim; ++y) {
+                dest[c*neuron_size + x*neuron_dim + y] = source[c*neuron_size + dihedralPixelIndex(quarterTurns, flip, x, y, neuron_dim)];
+            }
+        }
+    }
+}
+
+namespace {
+
+//! Largest number of neurons or rotations of a supported tile.
+const int maxTileDimension = 8;
+
+typedef void (*DistanceTileKernel)(float const * const *, float const * const *, int, float *);
+
+DistanceTileKernel getDistanceTileKernel(DistanceTile const& tile)
+{
+    int n = tile.neurons, r = tile.rotations;
+    if (n == 1 and r == 1) return euclideanDistanceTile<1,1>;
+    if (n == 2 and r == 2) return euclideanDistanceTile<2,2>;
+    if (n == 2 and r == 4) return euclideanDistanceTile<2,4>;
+    if (n == 4 and r == 2) return euclideanDistanceTile<4,2>;
+    if (n == 4 and r == 4) return euclideanDistanceTile<4,4>;
+    if (n == 4 and r == 8) return euclideanDistanceTile<4,8>;
+    if (n == 8 and r == 4) return euclideanDistanceTile<8,4>;
+    return NULL;
+}
+
+typedef bool (*BoundedDistanceTileKernel)(float const * const *, float const * const *, int, float *, float const *);
+
+BoundedDistanceTileKernel getBoundedDistanceTileKernel(DistanceTile const& tile)
+{
+    int n = tile.neurons, r = tile.rotations;
+    if (n == 1 and r == 1) return euclideanDistanceTileBounded<1,1>;
+    if (n == 2 and r == 2) return euclideanDistanceTileBounded<2,2>;
+    if (n == 2 and r == 4) return euclideanDistanceTileBounded<2,4>;
+    if (n == 4 and r == 2) return euclideanDistanceTileBounded<4,2>;
+    if (n == 4 and r == 4) return euclideanDistanceTileBounded<4,4>;
+    if (n == 4 and r == 8) return euclideanDistanceTileBounded<4,8>;
+    if (n == 8 and r == 4) return euclideanDistanceTileBounded<8,4>;
+    return NULL;
+}
+
+//! Size of the (per core) second level cache in bytes.
+size_t getL2CacheSize()
+{
+    long size = -1;
+#ifdef _SC_LEVEL2_CACHE_SIZE
+    size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+    return size > 0 ? size : 256 * 1024;
+}
+
+//! Float neurons are used in place.
+float const* getFloatNeurons(float const *neurons, int, std::vector<float>&)
+{
+    return neurons;
+}
+
+//! Reduced precision neurons are widened into buffer.
+template <class T>
+float const* getFloatNeurons(T const *neurons, int size, std::vector<float>& buffer)
+{
+    buffer.resize(size);
+    convertToFloat(&buffer[0], neurons, size);
+    return &buffer[0];
+}
+
+/**
+ * Inverse dihedral transformations of a neuron, transformation t is t % numberOfQuarterTurns
+ * quarter turns followed by a flip if t >= numberOfQuarterTurns. Comparing the result with
+ * an untransformed image is the same as comparing the neuron with the transformed image.
+ */
+void writeInverseDihedralTransformations(float *transformed, float const *neuron, int numberOfTransformations,
+    int numberOfQuarterTurns, int neuron_dim, int numberOfChannels)
+{
+    int neuron_size = neuron_dim * neuron_dim;
+    for (int t = 0; t < numberOfTransformations; ++t) {
+        int quarterTurns = t % numberOfQuarterTurns;
+        bool flip = t >= numberOfQuarterTurns;
+        for (int c = 0; c < numberOfChannels; ++c) {
+            float *ptrans = transformed + (t * numberOfChannels + c) * neuron_size;
+            float const *pneuron = neuron + c * neuron_size;
+            for (int x = 0; x < neuron_dim; ++x) {
+                for (int y = 0; y < neuron_dim; ++y) {
+                    ptrans[dihedralPixelIndex(quarterTurns, flip, x, y, neuron_dim)] = pneuron[x * neuron_dim + y];
+                }
+            }
+        }
+    }
+}
+
+template <class T>
+void generateEuclideanDistanceMatrixTiled(float *euclideanDistanceMatrix, int *bestRotationMatrix,
+    int som_size, T const* som, int image_size, int num_rot, float const* rotatedImages, DistanceTile const& tile)
+{
+    DistanceTileKernel kernel = getDistanceTileKernel(tile);
+    if (!kernel) fatalError("Unsupported distance tile.");
+
+    const int NN = tile.neurons;
+    const int NR = tile.rotations;
+
+    // Neuron and rotation blocks share the second level cache
+    int imagesPerBlock = std::max<size_t>(1, getL2CacheSize() / 2 / (image_size * sizeof(float)));
+    int neuronBlockSize = std::max(1, imagesPerBlock / NN) * NN;
+    int rotationBlockSize = std::max(1, imagesPerBlock / NR) * NR;
+
+    // Split into smaller blocks if there is not enough work for all threads
+    int numberOfThreads = omp_get_max_threads();
+    auto numberOfBlocks = [&]() {
+        return ((som_size + neuronBlockSize - 1) / neuronBlockSize) * ((num_rot + rotationBlockSize - 1) / rotationBlockSize);
+    };
+    while (numberOfBlocks() < numberOfThreads and neuronBlockSize > NN) neuronBlockSize -= NN;
+    while (numberOfBlocks() < numberOfThreads and rotationBlockSize > NR) rotationBlockSize -= NR;
+
+    int numberOfNeuronBlocks = (som_size + neuronBlockSize - 1) / neuronBlockSize;
+    int numberOfRotationBlocks = (num_rot + rotationBlockSize - 1) / rotationBlockSize;
+
+    // Best match of each neuron within each rotation block
+    std::vector<float> blockDistance(numberOfRotationBlocks * som_size, FLT_MAX);
+    std::vector<int> blockRotation(numberOfRotationBlocks * som_size, 0);
+
+    #pragma omp parallel
+    {
+    // Widened neuron tile for reduced precision storage
+    std::vector<float> buffer;
+
+    #pragma omp for collapse(2) schedule(dynamic)
+    for (int nb = 0; nb < numberOfNeuronBlocks; ++nb) {
+        for (int rb = 0; rb < numberOfRotationBlocks; ++rb) {
+            int neuronEnd = std::min(som_size, (nb + 1) * neuronBlockSize);
+            int rotationEnd = std::min(num_rot, (rb + 1) * rotationBlockSize);
+            float *pdist = &blockDistance[rb * som_size];
+            int *prot = &blockRotation[rb * som_size];
+
+            float const *neurons[maxTileDimension];
+            float const *images[maxTileDimension];
+            float result[maxTileDimension * maxTileDimension];
+
+            for (int i = nb * neuronBlockSize; i < neuronEnd; i += NN) {
+                // Incomplete tiles repeat the last neuron or image, the surplus results are ignored
+                int numberOfNeurons = std::min(NN, neuronEnd - i);
+                float const *tile = getFloatNeurons(som + i * image_size, numberOfNeurons * image_size, buffer);
+                for (int n = 0; n < NN; ++n) neurons[n] = tile + std::min(n, numberOfNeurons - 1) * image_size;
+
+                for (int j = rb * rotationBlockSize; j < rotationEnd; j += NR) {
+                    int numberOfImages = std::min(NR, rotationEnd - j);
+                    for (int r = 0; r < NR; ++r) images[r] = rotatedImages + (j + std::min(r, numberOfImages - 1)) * image_size;
+
+                    kernel(neurons, images, image_size, result);
+
+                    for (int n = 0; n < numberOfNeurons; ++n) {
+                        for (int r = 0; r < numberOfImages; ++r) {
+                            if (result[n * NR + r] < pdist[i + n]) {
+                                pdist[i + n] = result[n * NR + r];
+                                prot[i + n] = j + r;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    }
+
+    // Reduction over the rotation blocks, ties are resolved to the lowest rotation
+    for (int i = 0; i < som_size; ++i) {
+        euclideanDistanceMatrix[i] = FLT_MAX;
+        bestRotationMatrix[i] = 0;
+        for (int rb = 0; rb < numberOfRotationBlocks; ++rb) {
+            if (blockDistance[rb * som_size + i] < euclideanDistanceMatrix[i]) {
+                euclideanDistanceMatrix[i] = blockDistance[rb * som_size + i];
+                bestRotationMatrix[i] = blockRotation[rb * som_size + i];
+            }
+        }
+    }
+}
+
+} // anonymous namespace
+
+void generateEuclideanDistanceMatrix(float *euclideanDistanceMatrix, int *bestRotationMatrix,
+    int som_size, float* som, int image_size, int num_rot, float* rotatedImages, DistanceTile const& tile)
+{
+    generateEuclideanDistanceMatrixTiled<float>(euclideanDistanceMatrix, bestRotationMatrix,
+        som_size, som, image_size, num_rot, rotatedImages, tile);
+}
+
+void generateEuclideanDistanceMatrix(float *euclideanDistanceMatrix, int *bestRotationMatrix,
+    int som_size, bfloat16 const* som, int image_size, int num_rot, float* rotatedImages,
+    DistanceTile const& tile)
+{
+    generateEuclideanDistanceMatrixTiled<bfloat16>(euclideanDistanceMatrix, bestRotationMatrix,
+        som_size, som, image_size, num_rot, rotatedImages, tile);
+}
+
 void generateEuclideanDistanceMatrix(float *euclideanDistanceMatrix, int *bestRotationMatrix,
+    int som_size, float16 const* som, int image_size, int num_rot, float* rotatedImages,
+    DistanceTile const& tile)
+{
+    generateEuclideanDistanceMatrixTiled<float16>(euclideanDistanceMatrix, bestRotationMatrix,
+        som_size, som, image_size, num_rot, rotatedImages, tile);
+}
+
+void generateEuclideanDistanceMatrixInterleaved(float *euclideanDistanceMatrix, int *bestRotationMatrix,
     int som_size, float* som, int image_size, int num_rot, float* rotatedImages)
 {
-    float tmp;
-    float* pdist = euclideanDistanceMatrix;
-    int* prot = bestRotationMatrix;
-    float *psom = NULL;
+    int stride = interleavedStride(num_rot);
+
+    // Number of pixels processed for all rotations before the next pixels are read
+    const int pixelBlockSize = 16;
+
+    #pragma omp parallel
+    {
+        std::vector<float> distances(stride);
+
+        #pragma omp for
+        for (int i = 0; i < som_size; ++i) {
+            float *psom = som + i*image_size;
+            std::fill(distances.begin(), distances.end(), 0.0f);
+
+            for (int pb = 0; pb < image_size; pb += pixelBlockSize) {
+                int pe = std::min(pb + pixelBlockSize, image_size);
+                for (int jb = 0; jb < stride; jb += interleavedBlockSize) {
+                    float c[interleavedBlockSize];
+                    for (int l = 0; l < interleavedBlockSize; ++l) c[l] = distances[jb + l];
+                    float *prot = rotatedImages + pb*stride + jb;
+                    for (int p = pb; p < pe; ++p, prot += stride) {
+                        float n = psom[p];
+                        #pragma omp simd
+                        for (int l = 0; l < interleavedBlockSize; ++l) {
+                            float tmp = n - prot[l];
+                            c[l] += tmp * tmp;
+                        }
+                    }
+                    for (int l = 0; l < interleavedBlockSize; ++l) distances[jb + l] = c[l];
+                }
+            }
+
+            float minDistance = FLT_MAX;
+            int bestRotation = 0;
+            for (int j = 0; j < num_rot; ++j) {
+                if (distances[j] < minDistance) {
+                    minDistance = distances[j];
+                    bestRotation = j;
+                }
+            }
+            euclideanDistanceMatrix[i] = minDistance;
+            bestRotationMatrix[i] = bestRotation;
+        }
+    }
+}
+
+void generateEuclideanDistanceMatrixDihedral(float *euclideanDistanceMatrix, int *bestRotationMatrix,
+    int som_size, float* som, int neuron_dim, int numberOfChannels, int num_rot, bool useFlip,
+    float* rotatedImages, DistanceTile const& tile)
+{
+    DistanceTileKernel kernel = getDistanceTileKernel(tile);
+    if (!kernel) fatalError("Unsupported distance tile.");
+
+    const int NN = tile.neurons;
+    const int NR = tile.rotations;
+
+    int neuron_size = neuron_dim * neuron_dim;
+    int image_size = numberOfChannels * neuron_size;
+    int num_real_rot = dihedralNumberOfImages(num_rot);
+    int numberOfQuarterTurns = num_rot == 1 ? 1 : 4;
+    int numberOfTransformations = useFlip ? 2 * numberOfQuarterTurns : numberOfQuarterTurns;
+
+    #pragma omp parallel
+    {
+    // Inverse transformations of the current neuron
+    std::vector<float> transformed(numberOfTransformations * image_size);
+
+    #pragma omp for schedule(dynamic)
+    for (int i = 0; i < som_size; ++i) {
+        writeInverseDihedralTransformations(&transformed[0], som + i*image_size, numberOfTransformations,
+            numberOfQuarterTurns, neuron_dim, numberOfChannels);
+
+        float const *neurons[maxTileDimension];
+        float const *images[maxTileDimension];
+        float result[maxTileDimension * maxTileDimension];
+
+        float minDistance = FLT_MAX;
+        int bestRotation = 0;
+
+        // The stored images of a tile are compared with all transformations before the next are read
+        for (int j = 0; j < num_real_rot; j += NR) {
+            // Incomplete tiles repeat the last transformation or image, the surplus results are ignored
+            int numberOfImages = std::min(NR, num_real_rot - j);
+            for (int r = 0; r < NR; ++r) images[r] = rotatedImages + (j + std::min(r, numberOfImages - 1)) * image_size;
+
+            for (int t = 0; t < numberOfTransformations; t += NN) {
+                int numberOfNeurons = std::min(NN, numberOfTransformations - t);
+                for (int n = 0; n < NN; ++n) neurons[n] = &transformed[(t + std::min(n, numberOfNeurons - 1)) * image_size];
+
+                kernel(neurons, images, image_size, result);
+
+                for (int n = 0; n < numberOfNeurons; ++n) {
+                    int quarterTurns = (t + n) % numberOfQuarterTurns;
+                    int flipOffset = t + n >= numberOfQuarterTurns ? num_rot : 0;
+                    for (int r = 0; r < numberOfImages; ++r) {
+                        int rotation = flipOffset + quarterTurns * num_real_rot + j + r;
+                        float d = result[n * NR + r];
+                        if (d < minDistance or (d == minDistance and rotation < bestRotation)) {
+                            minDistance = d;
+                            bestRotation = rotation;
+                        }
+                    }
+                }
+            }
+        }
+        euclideanDistanceMatrix[i] = minDistance;
+        bestRotationMatrix[i] = bestRotation;
+    }
+    }
+}
+
+namespace {
+
+//! Number of pixels of a rotated image sampled at once by the fused kernel.
+const int fusedChunkSize = 256;
+
+//! Transformed neurons and rotations compared at once by the fused kernel.
+const int fusedTileNeurons = 2;
+const int fusedTileRotations = 4;
+
+//! Largest number of neuron blocks for which sampling on the fly is faster than the rotation stack.
+const int maxFusedNeuronBlocks = 1;
+
+//! Number of neurons sharing the samples of the fused kernel.
+int getFusedNeuronBlockSize(int numberOfTransformations, int image_size)
+{
+    return std::max<size_t>(1, getL2CacheSize() / 2 / (numberOfTransformations * image_size * sizeof(float)));
+}
 
-    for (int i = 0; i < som_size; ++i) euclideanDistanceMatrix[i] = FLT_MAX;
+} // anonymous namespace
 
-    for (int i = 0; i < som_size; ++i, ++pdist, ++prot) {
-        psom = som + i*image_size;
-        #pragma omp parallel for private(tmp)
+void generateRotatedImage(float *dest, float *image, int rotation, int num_rot, int image_dim, int neuron_dim,
+    Interpolation interpolation, int numberOfChannels)
+{
+    int image_size = image_dim * image_dim;
+    int neuron_size = neuron_dim * neuron_dim;
+    int num_real_rot = dihedralNumberOfImages(num_rot);
+    int i = rotation % num_rot % num_real_rot;
+    float angleStepRadians = 2.0 * M_PI / num_rot;
+
+    std::vector<float> stored(numberOfChannels * neuron_size);
+    for (int c = 0; c < numberOfChannels; ++c) {
+        if (i == 0) crop(image_dim, image_dim, neuron_dim, neuron_dim, image + c*image_size, &stored[c*neuron_size]);
+        else rotateAndCrop(image_dim, image_dim, neuron_dim, neuron_dim, image + c*image_size, &stored[c*neuron_size],
+            i*angleStepRadians, interpolation);
+    }
+
+    // Same quarter turn and flip, but referring to the single stored image
+    generateDihedralImage(dest, &stored[0], rotation - i, num_rot, neuron_dim, numberOfChannels);
+}
+
+bool useFusedRotation(int som_size, int num_rot, bool useFlip, int neuron_dim, int numberOfChannels)
+{
+    if (som_size <= 0 or neuron_dim <= 0 or numberOfChannels <= 0) return false;
+
+    int numberOfTransformations = (num_rot == 1 ? 1 : 4) * (useFlip ? 2 : 1);
+    int neuronBlockSize = getFusedNeuronBlockSize(numberOfTransformations, numberOfChannels * neuron_dim * neuron_dim);
+    int numberOfNeuronBlocks = (som_size + neuronBlockSize - 1) / neuronBlockSize;
+    return numberOfNeuronBlocks <= maxFusedNeuronBlocks;
+}
+
+void generateEuclideanDistanceMatrixFused(float *euclideanDistanceMatrix, int *bestRotationMatrix,
+    int som_size, float* som, float* image, int num_rot, int image_dim, int neuron_dim, bool useFlip,
+    Interpolation interpolation, int numberOfChannels)
+{
+    int source_size = image_dim * image_dim;
+    int neuron_size = neuron_dim * neuron_dim;
+    int image_size = numberOfChannels * neuron_size;
+    int margin = (image_dim - neuron_dim) / 2;
+
+    int num_real_rot = dihedralNumberOfImages(num_rot);
+    int numberOfQuarterTurns = num_rot == 1 ? 1 : 4;
+    int numberOfTransformations = useFlip ? 2 * numberOfQuarterTurns : numberOfQuarterTurns;
+    float angleStepRadians = 2.0 * M_PI / num_rot;
+
+    int rowsPerChunk = std::max(1, std::min(neuron_dim, fusedChunkSize / neuron_dim));
+
+    // Split the rotations if there are not enough neuron blocks for all threads
+    int neuronBlockSize = std::min(som_size, getFusedNeuronBlockSize(numberOfTransformations, image_size));
+    int numberOfThreads = omp_get_max_threads();
+    int numberOfNeuronBlocks = (som_size + neuronBlockSize - 1) / neuronBlockSize;
+    int rotationBlockSize = num_real_rot;
+    while (numberOfNeuronBlocks * ((num_real_rot + rotationBlockSize - 1) / rotationBlockSize) < numberOfThreads
+        and rotationBlockSize > 1) rotationBlockSize = (rotationBlockSize + 1) / 2;
+    int numberOfRotationBlocks = (num_real_rot + rotationBlockSize - 1) / rotationBlockSize;
+
+    // Best match of each neuron within each rotation block
+    std::vector<float> blockDistance(numberOfRotationBlocks * som_size, FLT_MAX);
+    std::vector<int> blockRotation(numberOfRotationBlocks * som_size, 0);
+
+    #pragma omp parallel
+    {
+    // Inverse transformations of the neuron block, sampled pixels and distances of the current rotation
+    std::vector<float> transformed(neuronBlockSize * numberOfTransformations * image_size);
+    std::vector<float> chunk(fusedTileRotations * rowsPerChunk * neuron_dim);
+    std::vector<float> distances(neuronBlockSize * numberOfTransformations * fusedTileRotations);
+    float cosAlpha[fusedTileRotations], sinAlpha[fusedTileRotations];
+
+    #pragma omp for collapse(2) schedule(dynamic)
+    for (int nb = 0; nb < numberOfNeuronBlocks; ++nb) {
+        for (int rb = 0; rb < numberOfRotationBlocks; ++rb) {
+            int neuronBegin = nb * neuronBlockSize;
+            int numberOfNeurons = std::min(neuronBlockSize, som_size - neuronBegin);
+            int numberOfVariants = numberOfNeurons * numberOfTransformations;
+
+            for (int n = 0; n < numberOfNeurons; ++n) {
+                writeInverseDihedralTransformations(&transformed[n * numberOfTransformations * image_size],
+                    som + (neuronBegin + n) * image_size, numberOfTransformations, numberOfQuarterTurns,
+                    neuron_dim, numberOfChannels);
+            }
+
+            float *pdist = &blockDistance[rb * som_size + neuronBegin];
+            int *prot = &blockRotation[rb * som_size + neuronBegin];
+
+            int rotationEnd = std::min(num_real_rot, (rb + 1) * rotationBlockSize);
+            for (int i = rb * rotationBlockSize; i < rotationEnd; i += fusedTileRotations) {
+                int numberOfRotations = std::min(fusedTileRotations, rotationEnd - i);
+                for (int r = 0; r < numberOfRotations; ++r) {
+                    const float alpha = (i + r) * angleStepRadians;
+                    cosAlpha[r] = cos(alpha);
+                    sinAlpha[r] = sin(alpha);
+                }
+                std::fill(distances.begin(), distances.end(), 0.0f);
+
+                for (int c = 0; c < numberOfChannels; ++c) {
+                    float *currentImage = image + c * source_size;
+                    for (int xb = 0; xb < neuron_dim; xb += rowsPerChunk) {
+                        int numberOfRows = std::min(rowsPerChunk, neuron_dim - xb);
+                        int length = numberOfRows * neuron_dim;
+
+                        // Sample the rows of the rotated images, identical to crop or rotateAndCrop
+                        for (int r = 0; r < numberOfRotations; ++r) {
+                            for (int x = 0; x < numberOfRows; ++x) {
+                                float *row = &chunk[(r * rowsPerChunk + x) * neuron_dim];
+                                if (i + r == 0) std::copy(currentImage + (xb + x + margin) * image_dim + margin,
+                                    currentImage + (xb + x + margin) * image_dim + margin + neuron_dim, row);
+                                else rotateAndCropRow(image_dim, image_dim, neuron_dim, neuron_dim, currentImage, row,
+                                    xb + x, cosAlpha[r], sinAlpha[r], interpolation);
+                            }
+                        }
+
+                        // Incomplete tiles repeat the last variant or rotation, the surplus results are ignored
+                        float const *neurons[fusedTileNeurons];
+                        float const *images[fusedTileRotations];
+                        float result[fusedTileNeurons * fusedTileRotations];
+                        for (int r = 0; r < fusedTileRotations; ++r)
+                            images[r] = &chunk[std::min(r, numberOfRotations - 1) * rowsPerChunk * neuron_dim];
+
+                        int offset = c * neuron_size + xb * neuron_dim;
+                        for (int v = 0; v < numberOfVariants; v += fusedTileNeurons) {
+                            int numberOfTileVariants = std::min(fusedTileNeurons, numberOfVariants - v);
+                            for (int k = 0; k < fusedTileNeurons; ++k)
+                                neurons[k] = &transformed[(v + std::min(k, numberOfTileVariants - 1)) * image_size + offset];
+                            euclideanDistanceTile<fusedTileNeurons, fusedTileRotations>(neurons, images, length, result);
+                            for (int k = 0; k < numberOfTileVariants; ++k)
+                                for (int r = 0; r < numberOfRotations; ++r)
+                                    distances[(v + k) * fusedTileRotations + r] += result[k * fusedTileRotations + r];
+                        }
+                    }
+                }
+
+                for (int n = 0; n < numberOfNeurons; ++n) {
+                    for (int t = 0; t < numberOfTransformations; ++t) {
+                        for (int r = 0; r < numberOfRotations; ++r) {
+                            int rotation = (t >= numberOfQuarterTurns ? num_rot : 0)
+                                + t % numberOfQuarterTurns * num_real_rot + i + r;
+                            float d = distances[(n * numberOfTransformations + t) * fusedTileRotations + r];
+                            if (d < pdist[n] or (d == pdist[n] and rotation < prot[n])) {
+                                pdist[n] = d;
+                                prot[n] = rotation;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    }
+
+    // Reduction over the rotation blocks, ties are resolved to the lowest rotation
+    for (int i = 0; i < som_size; ++i) {
+        euclideanDistanceMatrix[i] = FLT_MAX;
+        bestRotationMatrix[i] = 0;
+        for (int rb = 0; rb < numberOfRotationBlocks; ++rb) {
+            float d = blockDistance[rb * som_size + i];
+            int rotation = blockRotation[rb * som_size + i];
+            if (d < euclideanDistanceMatrix[i] or (d == euclideanDistanceMatrix[i] and rotation < bestRotationMatrix[i])) {
+                euclideanDistanceMatrix[i] = d;
+                bestRotationMatrix[i] = rotation;
+            }
+        }
+    }
+}
+
+void generateEuclideanDistanceMatrixWithPrincipalAxes(float *euclideanDistanceMatrix, int *bestRotationMatrix,
+    int som_size, float* som, int image_size, int num_rot, bool useFlip, float* rotatedImages,
+    PrincipalAxis const& imageAxis, PrincipalAxis const* neuronAxes, float window, float minAnisotropy)
+{
+    int numberOfFlips = useFlip ? 2 : 1;
+    float angleStepRadians = 2.0 * M_PI / num_rot;
+
+    // The two windows of an axis must not overlap
+    bool fullSearch = num_rot < 4 or imageAxis.anisotropy < minAnisotropy
+        or 2.0 * window + angleStepRadians >= M_PI;
+
+    #pragma omp parallel for
+    for (int i = 0; i < som_size; ++i) {
+        float *psom = som + i*image_size;
+        float minDistance = FLT_MAX;
+        int bestRotation = 0;
+
+        if (fullSearch or neuronAxes[i].anisotropy < minAnisotropy) {
+            for (int j = 0; j < numberOfFlips * num_rot; ++j) {
+                float tmp = calculateEuclideanDistanceWithoutSquareRoot(psom, rotatedImages + j*image_size, image_size);
+                if (tmp < minDistance) {
+                    minDistance = tmp;
+                    bestRotation = j;
+                }
+            }
+        } else {
+            for (int f = 0; f < numberOfFlips; ++f) {
+                // Rotation angle alpha for which image angle + alpha (unflipped)
+                // or -(image angle + alpha) (flipped) is the neuron angle
+                float alignment = f ? -neuronAxes[i].angle - imageAxis.angle : neuronAxes[i].angle - imageAxis.angle;
+                for (int axis = 0; axis < 2; ++axis) {
+                    float center = (alignment + axis * M_PI) / angleStepRadians;
+                    int first = std::ceil(center - window / angleStepRadians);
+                    int last = std::floor(center + window / angleStepRadians);
+                    int nearest = std::floor(center + 0.5f);
+                    first = std::min(first, nearest);
+                    last = std::max(last, nearest);
+                    for (int r = first; r <= last; ++r) {
+                        int j = f * num_rot + ((r % num_rot) + num_rot) % num_rot;
+                        float tmp = calculateEuclideanDistanceWithoutSquareRoot(psom, rotatedImages + j*image_size, image_size);
+                        if (tmp < minDistance) {
+                            minDistance = tmp;
+                            bestRotation = j;
+                        }
+                    }
+                }
+            }
+        }
+
+        euclideanDistanceMatrix[i] = minDistance;
+        bestRotationMatrix[i] = bestRotation;
+    }
+}
+
+void generateRotatedNeurons(float *rotatedNeurons, float *som, int som_size, int neuron_dim,
+    int numberOfRotations, bool useFlip, Interpolation interpolation, int numberOfChannels)
+{
+    int neuron_size = neuron_dim * neuron_dim;
+    int numberOfRotationsAndFlip = useFlip ? 2 * numberOfRotations : numberOfRotations;
+    float angleStepRadians = 2.0 * M_PI / numberOfRotations;
+
+    // Zero padding, so that all interpolation points are within the image
+    int margin = std::ceil(neuron_dim * (M_SQRT2 - 1.0) * 0.5) + 1;
+    int padded_dim = neuron_dim + 2 * margin;
+
+    #pragma omp parallel for
+    for (int i = 0; i < som_size; ++i) {
+        std::vector<float> padded(padded_dim * padded_dim, 0.0f), flipped(neuron_size);
+        for (int j = 0; j < numberOfRotationsAndFlip; ++j) {
+            float angle = -(j % numberOfRotations) * angleStepRadians;
+            float *current = rotatedNeurons + (i*numberOfRotationsAndFlip + j)*numberOfChannels*neuron_size;
+            for (int c = 0; c < numberOfChannels; ++c) {
+                float *neuron = som + (i*numberOfChannels + c)*neuron_size;
+                if (j >= numberOfRotations) {
+                    flip(neuron_dim, neuron_dim, neuron, &flipped[0]);
+                    neuron = &flipped[0];
+                }
+                for (int x = 0; x < neuron_dim; ++x) {
+                    std::copy(neuron + x*neuron_dim, neuron + (x+1)*neuron_dim,
+                        &padded[(x + margin)*padded_dim + margin]);
+                }
+                rotateAndCrop(padded_dim, padded_dim, neuron_dim, neuron_dim, &padded[0],
+                    current + c*neuron_size, angle, interpolation);
+            }
+            applyCircularMask(current, neuron_dim, numberOfChannels);
+        }
+    }
+}
+
+void applyCircularMask(float *image, int dim, int numberOfChannels)
+{
+    float center = (dim - 1) * 0.5;
+    float radius2 = dim * dim * 0.25;
+    for (int c = 0; c < numberOfChannels; ++c) {
+        for (int x = 0; x < dim; ++x) {
+            for (int y = 0; y < dim; ++y) {
+                if ((x - center) * (x - center) + (y - center) * (y - center) > radius2)
+                    image[(c*dim + x)*dim + y] = 0.0f;
+            }
+        }
+    }
+}
+
+void generateEuclideanDistanceMatrixForNeurons(float *euclideanDistanceMatrix, int *bestRotationMatrix,
+    int som_size, float* som, int image_size, int num_rot, float* rotatedImages,
+    int const *neurons, int numberOfNeurons)
+{
+    for (int i = 0; i < som_size; ++i) {
+        euclideanDistanceMatrix[i] = FLT_MAX;
+        bestRotationMatrix[i] = 0;
+    }
+
+    #pragma omp parallel for
+    for (int n = 0; n < numberOfNeurons; ++n) {
+        int i = neurons[n];
+        float *psom = som + i*image_size;
         for (int j = 0; j < num_rot; ++j) {
-            tmp = calculateEuclideanDistanceWithoutSquareRoot(psom, rotatedImages + j*image_size, image_size);
-            #pragma omp critical
-            if (tmp < *pdist) {
-                *pdist = tmp;
-                *prot = j;
+            float tmp = calculateEuclideanDistanceWithoutSquareRoot(psom, rotatedImages + j*image_size, image_size);
+            if (tmp < euclideanDistanceMatrix[i]) {
+                euclideanDistanceMatrix[i] = tmp;
+                bestRotationMatrix[i] = j;
+            }
+        }
+    }
+}
+
+void generateEuclideanDistanceMatrixFromCandidates(float *euclideanDistanceMatrix, int *bestRotationMatrix,
+    int som_size, float* som, int image_size, int num_rot, float* rotatedImages,
+    float const *scores, int numberOfCandidates)
+{
+    numberOfCandidates = std::min(numberOfCandidates, num_rot);
+
+    #pragma omp parallel
+    {
+    std::vector<int> candidates(num_rot);
+
+    #pragma omp for
+    for (int i = 0; i < som_size; ++i) {
+        float const *pscores = scores + static_cast<size_t>(i) * num_rot;
+        for (int j = 0; j < num_rot; ++j) candidates[j] = j;
+        std::partial_sort(candidates.begin(), candidates.begin() + numberOfCandidates, candidates.end(),
+            [pscores](int a, int b) { return pscores[a] < pscores[b] or (pscores[a] == pscores[b] and a < b); });
+
+        euclideanDistanceMatrix[i] = FLT_MAX;
+        bestRotationMatrix[i] = 0;
+        for (int c = 0; c < numberOfCandidates; ++c) {
+            int j = candidates[c];
+            float tmp = calculateEuclideanDistanceWithoutSquareRoot(som + i * image_size,
+                rotatedImages + j * image_size, image_size);
+            if (tmp < euclideanDistanceMatrix[i] or (tmp == euclideanDistanceMatrix[i] and j < bestRotationMatrix[i])) {
+                euclideanDistanceMatrix[i] = tmp;
+                bestRotationMatrix[i] = j;
             }
         }
     }
+    }
 }
 
 int findBestMatchingNeuron(float *euclideanDistanceMatrix, int som_size)
@@ -108,4 +867,110 @@ int findBestMatchingNeuron(float *euclideanDistanceMatrix, int som_size)
     return bestMatch;
 }
 
+
+void generateBestMatchingNeurons(BestMatch *bestMatches, int numberOfBestMatches, int som_size, float* som,
+    int image_size, int num_rot, float* rotatedImages, DistanceTile const& tile)
+{
+    BoundedDistanceTileKernel kernel = getBoundedDistanceTileKernel(tile);
+    if (!kernel) fatalError("Unsupported distance tile.");
+
+    const int NN = tile.neurons;
+    const int NR = tile.rotations;
+    const int k = std::min(numberOfBestMatches, som_size);
+
+    // Neuron and rotation blocks share the second level cache, only the neuron blocks are distributed
+    int imagesPerBlock = std::max<size_t>(1, getL2CacheSize() / 2 / (image_size * sizeof(float)));
+    int neuronBlockSize = std::max(1, imagesPerBlock / NN) * NN;
+    int rotationBlockSize = std::max(1, imagesPerBlock / NR) * NR;
+
+    int numberOfThreads = omp_get_max_threads();
+    while ((som_size + neuronBlockSize - 1) / neuronBlockSize < numberOfThreads and neuronBlockSize > NN) neuronBlockSize -= NN;
+    int numberOfNeuronBlocks = (som_size + neuronBlockSize - 1) / neuronBlockSize;
+
+    // Best matches of each thread as max-heap
+    std::vector<std::vector<BestMatch>> threadBestMatches(numberOfThreads);
+
+    #pragma omp parallel
+    {
+    std::vector<BestMatch>& heap = threadBestMatches[omp_get_thread_num()];
+    std::vector<float> neuronDistance(neuronBlockSize);
+    std::vector<int> neuronRotation(neuronBlockSize);
+
+    #pragma omp for schedule(dynamic)
+    for (int nb = 0; nb < numberOfNeuronBlocks; ++nb) {
+        int neuronBegin = nb * neuronBlockSize;
+        int neuronEnd = std::min(som_size, neuronBegin + neuronBlockSize);
+        std::fill(neuronDistance.begin(), neuronDistance.end(), FLT_MAX);
+        std::fill(neuronRotation.begin(), neuronRotation.end(), 0);
+
+        float const *neurons[maxTileDimension];
+        float const *images[maxTileDimension];
+        float result[maxTileDimension * maxTileDimension];
+        float bound[maxTileDimension];
+
+        for (int rb = 0; rb < num_rot; rb += rotationBlockSize) {
+            int rotationEnd = std::min(num_rot, rb + rotationBlockSize);
+            for (int i = neuronBegin; i < neuronEnd; i += NN) {
+                // Incomplete tiles repeat the last neuron or image, the surplus results are ignored
+                int numberOfNeurons = std::min(NN, neuronEnd - i);
+                for (int n = 0; n < NN; ++n) neurons[n] = som + (i + std::min(n, numberOfNeurons - 1)) * image_size;
+                float *pdist = &neuronDistance[i - neuronBegin];
+                int *prot = &neuronRotation[i - neuronBegin];
+
+                for (int j = rb; j < rotationEnd; j += NR) {
+                    int numberOfImages = std::min(NR, rotationEnd - j);
+                    for (int r = 0; r < NR; ++r) images[r] = rotatedImages + (j + std::min(r, numberOfImages - 1)) * image_size;
+
+                    float threshold = static_cast<int>(heap.size()) == k ? heap.front().distance : FLT_MAX;
+                    for (int n = 0; n < NN; ++n) bound[n] = std::min(threshold, pdist[std::min(n, numberOfNeurons - 1)]);
+
+                    if (!kernel(neurons, images, image_size, result, bound)) continue;
+
+                    for (int n = 0; n < numberOfNeurons; ++n) {
+                        for (int r = 0; r < numberOfImages; ++r) {
+                            if (result[n * NR + r] < pdist[n]) {
+                                pdist[n] = result[n * NR + r];
+                                prot[n] = j + r;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        for (int i = neuronBegin; i < neuronEnd; ++i) {
+            BestMatch match = {i, neuronDistance[i - neuronBegin], neuronRotation[i - neuronBegin]};
+            if (static_cast<int>(heap.size()) < k) {
+                heap.push_back(match);
+                std::push_heap(heap.begin(), heap.end());
+            } else if (match < heap.front()) {
+                std::pop_heap(heap.begin(), heap.end());
+                heap.back() = match;
+                std::push_heap(heap.begin(), heap.end());
+            }
+        }
+    }
+    }
+
+    // The k-th best match of each thread bounds the global one, abandoned neurons are never needed
+    std::vector<BestMatch> all;
+    for (auto const& heap : threadBestMatches) all.insert(all.end(), heap.begin(), heap.end());
+    std::partial_sort(all.begin(), all.begin() + k, all.end());
+    std::copy(all.begin(), all.begin() + k, bestMatches);
+}
+
+void findBestMatchingNeurons(BestMatch *bestMatches, int numberOfBestMatches, float const *euclideanDistanceMatrix,
+    int const *bestRotationMatrix, int som_size)
+{
+    const int k = std::min(numberOfBestMatches, som_size);
+    std::vector<BestMatch> all(som_size);
+    for (int i = 0; i < som_size; ++i) {
+        all[i].neuron = i;
+        all[i].distance = euclideanDistanceMatrix[i];
+        all[i].rotation = bestRotationMatrix[i];
+    }
+    std::partial_sort(all.begin(), all.begin() + k, all.end());
+    std::copy(all.begin(), all.begin() + k, bestMatches);
+}
+
 } // namespace pink
@@ -10,8 +10,11 @@
 #include <iostream>
 #include <memory>
 
+#include "ImageProcessingLib/FixedPointRotation.h"
 #include "ImageProcessingLib/ImageProcessing.h"
 #include "UtilitiesLib/DistanceFunctor.h"
+#include "UtilitiesLib/DistanceTile.h"
+#include "UtilitiesLib/HalfPrecision.h"
 #include "UtilitiesLib/DistributionFunctor.h"
 #include "UtilitiesLib/InputData.h"
 #include "UtilitiesLib/Point.h"
@@ -21,10 +24,229 @@ namespace pink {
 void generateRotatedImages(float *rotatedImages, float *image, int numberOfRotations, int image_dim, int neuron_dim,
     bool useFlip, Interpolation interpolation, int numberOfChannels);
 
+//! Fixed point rotations of the interpolated angles 0 < i < numberOfRotations/4 of @generateRotatedImages.
+std::vector<FixedPointRotation> fixedPointRotations(int numberOfRotations, int image_dim, int neuron_dim);
+
+/**
+ * @brief Same as @generateRotatedImages with bilinear interpolation for integer input images.
+ *
+ * The interpolated angles are rotated from the stored pixels rawImage by the precomputed rotations
+ * (@fixedPointRotations), the unrotated crop is taken from the widened image.
+ */
+void generateRotatedImages(float *rotatedImages, float *image, uint8_t const *rawImage, float scale, float offset,
+    std::vector<FixedPointRotation> const& rotations, int numberOfRotations, int image_dim, int neuron_dim,
+    bool useFlip, int numberOfChannels);
+
+//! Same as above for uint16 input images.
+void generateRotatedImages(float *rotatedImages, float *image, uint16_t const *rawImage, float scale, float offset,
+    std::vector<FixedPointRotation> const& rotations, int numberOfRotations, int image_dim, int neuron_dim,
+    bool useFlip, int numberOfChannels);
+
+/**
+ * @brief Squared euclidean distances of all neurons to the best matching rotated image.
+ *
+ * The SOM and the rotated images are swept in blocks fitting into the second level cache,
+ * within a block the register-blocked kernel compares tile.neurons with tile.rotations images at once.
+ * Equal distances are resolved to the lowest rotation.
+ */
 void generateEuclideanDistanceMatrix(float *euclideanDistanceMatrix, int *bestRotationMatrix, int som_size, float* som,
-    int image_size, int numberOfRotations, float* image);
+    int image_size, int numberOfRotations, float* image, DistanceTile const& tile = DistanceTile());
+
+/**
+ * @brief Same as @generateEuclideanDistanceMatrix for a SOM stored as bfloat16.
+ *
+ * Each tile of neurons is widened to float once per rotation block, the distances are computed in float.
+ */
+void generateEuclideanDistanceMatrix(float *euclideanDistanceMatrix, int *bestRotationMatrix, int som_size,
+    bfloat16 const* som, int image_size, int numberOfRotations, float* image,
+    DistanceTile const& tile = DistanceTile());
+
+//! Same as @generateEuclideanDistanceMatrix for a SOM stored as float16.
+void generateEuclideanDistanceMatrix(float *euclideanDistanceMatrix, int *bestRotationMatrix, int som_size,
+    float16 const* som, int image_size, int numberOfRotations, float* image,
+    DistanceTile const& tile = DistanceTile());
+
+//! Number of rotations compared at once in the interleaved layout.
+const int interleavedBlockSize = 16;
+
+//! Distance between two pixels of the same rotated image in the interleaved layout.
+inline int interleavedStride(int numberOfRotationsAndFlip)
+{
+    return (numberOfRotationsAndFlip + interleavedBlockSize - 1) / interleavedBlockSize * interleavedBlockSize;
+}
+
+/**
+ * @brief Same as @generateRotatedImages, but stored in interleaved layout.
+ *
+ * Pixel p of rotated image j is stored at position p * interleavedStride(numberOfRotationsAndFlip) + j.
+ * The padding positions are not written.
+ */
+void generateRotatedImagesInterleaved(float *rotatedImages, float *image, int numberOfRotations, int image_dim,
+    int neuron_dim, bool useFlip, Interpolation interpolation, int numberOfChannels);
+
+/**
+ * @brief Same as @generateEuclideanDistanceMatrix for rotated images in interleaved layout.
+ *
+ * Each neuron pixel is loaded once and compared with interleavedBlockSize rotations.
+ */
+void generateEuclideanDistanceMatrixInterleaved(float *euclideanDistanceMatrix, int *bestRotationMatrix,
+    int som_size, float* som, int image_size, int numberOfRotations, float* rotatedImages);
+
+//! Number of interpolated rotations stored in the dihedral layout.
+inline int dihedralNumberOfImages(int numberOfRotations)
+{
+    return numberOfRotations == 1 ? 1 : numberOfRotations / 4;
+}
+
+/**
+ * @brief Pixel of the stored image providing pixel (x, y) of a dihedral transformation.
+ *
+ * The transformation is quarterTurns times @rotate_90degrees followed by an optional @flip,
+ * the returned index refers to the untransformed image of size dim * dim.
+ */
+inline int dihedralPixelIndex(int quarterTurns, bool flip, int x, int y, int dim)
+{
+    if (flip) x = dim - 1 - x;
+    switch (quarterTurns) {
+        case 1: return y * dim + dim - 1 - x;
+        case 2: return (dim - 1 - x) * dim + dim - 1 - y;
+        case 3: return (dim - 1 - y) * dim + x;
+        default: return x * dim + y;
+    }
+}
+
+/**
+ * @brief Same as @generateRotatedImages, but only the interpolated rotations are stored (dihedral layout).
+ *
+ * The stored images are the first dihedralNumberOfImages(numberOfRotations) images of @generateRotatedImages.
+ * The 90 degree rotations and the flipped images are not materialized, rotated image
+ * j = flip * numberOfRotations + quarterTurn * dihedralNumberOfImages + i is given by
+ * @dihedralPixelIndex applied to stored image i.
+ */
+void generateRotatedImagesDihedral(float *rotatedImages, float *image, int numberOfRotations, int image_dim,
+    int neuron_dim, Interpolation interpolation, int numberOfChannels);
+
+//! Materialize rotated image j of @generateRotatedImages from the dihedral layout.
+void generateDihedralImage(float *dest, float const *rotatedImages, int rotation, int numberOfRotations,
+    int neuron_dim, int numberOfChannels);
+
+/**
+ * @brief Same as @generateEuclideanDistanceMatrix for rotated images in dihedral layout.
+ *
+ * Instead of transforming the images, the inverse dihedral transformations of a neuron are written
+ * into a thread local buffer and compared with the stored images using the register-blocked kernel.
+ * The returned rotation refers to the full set of rotated and flipped images.
+ */
+void generateEuclideanDistanceMatrixDihedral(float *euclideanDistanceMatrix, int *bestRotationMatrix,
+    int som_size, float* som, int neuron_dim, int numberOfChannels, int numberOfRotations, bool useFlip,
+    float* rotatedImages, DistanceTile const& tile = DistanceTile());
+
+/**
+ * @brief Rotated image j of @generateRotatedImages generated directly from the input image.
+ *
+ * Only the needed interpolated rotation is computed, used for the update if the rotated images are not stored.
+ */
+void generateRotatedImage(float *dest, float *image, int rotation, int numberOfRotations, int image_dim,
+    int neuron_dim, Interpolation interpolation, int numberOfChannels);
+
+/**
+ * @brief Returns true if @generateEuclideanDistanceMatrixFused is expected to be faster than
+ * @generateRotatedImages followed by @generateEuclideanDistanceMatrix.
+ *
+ * The fused kernel samples each rotation once per block of neurons fitting into the second level cache,
+ * the rotation stack pays off if the samples are shared by more blocks.
+ */
+bool useFusedRotation(int som_size, int numberOfRotations, bool useFlip, int neuron_dim, int numberOfChannels);
+
+/**
+ * @brief Same as @generateRotatedImages followed by @generateEuclideanDistanceMatrix,
+ * but the rotated images are never stored.
+ *
+ * The interpolated rotations are sampled from the input image in chunks of rows (@rotateAndCropRow)
+ * and compared with the inverse dihedral transformations of a block of neurons, as for the dihedral layout.
+ * The sampled pixels are identical to the ones of @generateRotatedImages.
+ */
+void generateEuclideanDistanceMatrixFused(float *euclideanDistanceMatrix, int *bestRotationMatrix,
+    int som_size, float* som, float* image, int numberOfRotations, int image_dim, int neuron_dim, bool useFlip,
+    Interpolation interpolation, int numberOfChannels);
+
+/**
+ * @brief Same as @generateEuclideanDistanceMatrix, but only rotations aligning the principal axes are compared.
+ *
+ * For each neuron only the rotations within +-window (radians) around the two angles aligning the
+ * principal axis of the image with the one of the neuron are compared, for the unflipped and the flipped
+ * images. All rotations are compared if the anisotropy of the image or the neuron is below minAnisotropy.
+ */
+void generateEuclideanDistanceMatrixWithPrincipalAxes(float *euclideanDistanceMatrix, int *bestRotationMatrix,
+    int som_size, float* som, int image_size, int numberOfRotations, bool useFlip, float* rotatedImages,
+    PrincipalAxis const& imageAxis, PrincipalAxis const* neuronAxes, float window, float minAnisotropy);
+
+/**
+ * @brief Rotated and flipped copies of all neurons.
+ *
+ * The copy with index (neuron * numberOfRotationsAndFlip + j) is the inverse transformation of
+ * rotated image j of @generateRotatedImages applied to the neuron, i.e. it can be compared
+ * directly with the unrotated, cropped image. The neurons are zero padded before rotation and
+ * pixels outside of the inscribed circle are set to zero afterwards, use @applyCircularMask
+ * for the images to compare with.
+ */
+void generateRotatedNeurons(float *rotatedNeurons, float *som, int som_size, int neuron_dim,
+    int numberOfRotations, bool useFlip, Interpolation interpolation, int numberOfChannels);
+
+//! Set all pixels outside of the inscribed circle to zero.
+void applyCircularMask(float *image, int dim, int numberOfChannels);
+
+/**
+ * @brief Same as @generateEuclideanDistanceMatrix but only for the given neurons.
+ *
+ * All other entries are set to FLT_MAX and rotation 0.
+ */
+void generateEuclideanDistanceMatrixForNeurons(float *euclideanDistanceMatrix, int *bestRotationMatrix,
+    int som_size, float* som, int image_size, int numberOfRotations, float* rotatedImages,
+    int const *neurons, int numberOfNeurons);
+
+/**
+ * @brief Exact distances for the best candidates of approximate scores.
+ *
+ * For each neuron the numberOfCandidates rotations with the lowest approximate scores
+ * (scores[neuron * numberOfRotations + rotation]) are compared exactly, the best one is stored.
+ * Equal distances are resolved to the lowest rotation.
+ */
+void generateEuclideanDistanceMatrixFromCandidates(float *euclideanDistanceMatrix, int *bestRotationMatrix,
+    int som_size, float* som, int image_size, int numberOfRotations, float* rotatedImages,
+    float const *scores, int numberOfCandidates);
 
 //! Returns the position of the best matching neuron (lowest euclidean distance).
 int findBestMatchingNeuron(float *euclideanDistanceMatrix, int som_size);
 
+//! Neuron with squared euclidean distance and index of the best rotated image.
+struct BestMatch
+{
+    int neuron;
+    float distance;
+    int rotation;
+};
+
+//! Order of the best matches, equal distances are resolved to the lower neuron.
+inline bool operator < (BestMatch const& a, BestMatch const& b)
+{
+    return a.distance < b.distance or (a.distance == b.distance and a.neuron < b.neuron);
+}
+
+/**
+ * @brief The numberOfBestMatches neurons with the lowest distances of @generateEuclideanDistanceMatrix.
+ *
+ * The best matches are sorted by distance, equal distances by neuron. The distances and rotations
+ * are identical to the ones of @generateEuclideanDistanceMatrix, but the distances of the other
+ * neurons are not completed: the calculation of a tile is abandoned (@euclideanDistanceTileBounded)
+ * as soon as the partial distances exceed the current k-th best distance of the thread and the best
+ * distance of the neuron found so far. The neuron blocks are distributed over the threads.
+ */
+void generateBestMatchingNeurons(BestMatch *bestMatches, int numberOfBestMatches, int som_size, float* som,
+    int image_size, int numberOfRotations, float* rotatedImages, DistanceTile const& tile = DistanceTile());
+
+//! The numberOfBestMatches neurons with the lowest distances sorted by distance, equal distances by neuron.
+void findBestMatchingNeurons(BestMatch *bestMatches, int numberOfBestMatches, float const *euclideanDistanceMatrix,
+    int const *bestRotationMatrix, int som_size);
+
 } // namespace pink
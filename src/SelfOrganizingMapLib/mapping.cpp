@@ -4,9 +4,15 @@
  * @author Bernd Doser, HITS gGmbH
  */
 
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 
+#include "HNSWIndex.h"
+#include "MappingResultWriter.h"
+#include "NeuronPrototypes.h"
+#include "NeuronStatistics.h"
 #include "ImageProcessingLib/ImageIterator.h"
 #include "SelfOrganizingMap.h"
 #include "SOM.h"
@@ -14,41 +20,233 @@
 
 namespace pink {
 
+namespace {
+
+//! Load the ANN index of all rotated neurons stored next to the SOM file or build and store it.
+std::shared_ptr<HNSWIndex> getANNIndex(InputData const& inputData, float *som)
+{
+    int dim = inputData.numberOfChannels * inputData.neuron_size;
+    int numberOfVectors = inputData.som_size * inputData.numberOfRotationsAndFlip;
+
+    std::vector<float> rotatedNeurons(static_cast<size_t>(numberOfVectors) * dim);
+    generateRotatedNeurons(&rotatedNeurons[0], som, inputData.som_size, inputData.neuron_dim,
+        inputData.numberOfRotations, inputData.useFlip, inputData.interpolation, inputData.numberOfChannels);
+
+    auto ptrIndex = std::make_shared<HNSWIndex>(dim, inputData.annM, inputData.annEfConstruction, inputData.seed);
+    ptrIndex->addVectors(&rotatedNeurons[0], numberOfVectors);
+
+    std::string indexFilename = inputData.somFilename + ".hnsw";
+    if (ptrIndex->load(indexFilename)) {
+        std::cout << "  Read ANN index from " << indexFilename << "\n" << std::endl;
+    } else {
+        std::cout << "  Build ANN index of " << numberOfVectors << " rotated neurons ... " << std::flush;
+        auto startTime = myclock::now();
+        ptrIndex->build();
+        std::cout << "done (" << std::chrono::duration_cast<std::chrono::seconds>(myclock::now() - startTime).count()
+                  << " s)." << std::endl;
+        ptrIndex->save(indexFilename);
+        std::cout << "  Write ANN index to " << indexFilename << "\n" << std::endl;
+    }
+    return ptrIndex;
+}
+
+/**
+ * @brief Distances of the rotated images to one SOM with its result files and side outputs.
+ *
+ * All SOMs mapped in one pass share the rotated images.
+ */
+class SOMMapper
+{
+public:
+
+    SOMMapper(SOM& som, InputData const& inputData, float *rotatedImages);
+
+    //! Map the current rotated images, image is the index within the image file.
+    void map(int image);
+
+    void flush() { resultWriter_.flush(); }
+
+    //! Close the result files, write the side outputs and print the summary.
+    void close();
+
+private:
+
+    SOM& som_;
+
+    InputData const& inputData_;
+
+    float *rotatedImages_;
+
+    MappingResultWriter resultWriter_;
+
+    std::vector<float> euclideanDistanceMatrix_;
+
+    std::vector<int> bestRotationMatrix_;
+
+    std::vector<BestMatch> bestMatches_;
+
+    std::unique_ptr<NeuronStatistics> ptrNeuronStatistics_;
+
+    std::unique_ptr<NeuronPrototypes> ptrPrototypes_;
+
+    NeuronPrototypes::CutoutFunction cutout_;
+
+    // Approximate nearest neighbor search of best matching neuron candidates
+    std::shared_ptr<HNSWIndex> ptrIndex_;
+    std::vector<int> candidates_;
+    std::vector<float> query_;
+    std::vector<float> exactEuclideanDistanceMatrix_;
+    std::vector<int> exactBestRotationMatrix_;
+    int numberOfMappedImages_;
+    int numberOfRecallSamples_;
+    int numberOfRecallHits_;
+    int numberOfEqualBestMatches_;
+
+};
+
+SOMMapper::SOMMapper(SOM& som, InputData const& inputData, float *rotatedImages)
+ : som_(som),
+   inputData_(inputData),
+   rotatedImages_(rotatedImages),
+   resultWriter_(inputData),
+   euclideanDistanceMatrix_(inputData.som_size),
+   bestRotationMatrix_(inputData.som_size),
+   bestMatches_(inputData.resultTopK),
+   numberOfMappedImages_(0),
+   numberOfRecallSamples_(0),
+   numberOfRecallHits_(0),
+   numberOfEqualBestMatches_(0)
+{
+    if (inputData_.verbose) std::cout << "  Size of euclidean distance matrix = " << inputData_.som_size * sizeof(float) << " bytes" << std::endl;
+    if (inputData_.verbose) std::cout << "  Size of best rotation matrix = " << inputData_.som_size * sizeof(int) << " bytes\n" << std::endl;
+
+    if (!inputData_.neuronStatisticsFilename.empty())
+        ptrNeuronStatistics_.reset(new NeuronStatistics(inputData_.som_size, inputData_.neuronStatisticsExamples));
+
+    if (!inputData_.prototypesFilename.empty()) {
+        int cutoutSize = 0;
+        if (!inputData_.prototypeCutoutsFilename.empty()) {
+            cutoutSize = inputData_.numberOfChannels * inputData_.neuron_size;
+            cutout_ = [this](float *dest, int rotation){ som_.getRotatedImage(dest, rotatedImages_, rotation); };
+        }
+        ptrPrototypes_.reset(new NeuronPrototypes(inputData_.som_size, inputData_.numberOfPrototypes, cutoutSize));
+    }
+
+    if (inputData_.annTopK) {
+        ptrIndex_ = getANNIndex(inputData_, som_.getDataPointer());
+        candidates_.reserve(inputData_.annTopK);
+        query_.resize(inputData_.numberOfChannels * inputData_.neuron_size);
+        if (inputData_.annRecallSample) {
+            exactEuclideanDistanceMatrix_.resize(inputData_.som_size);
+            exactBestRotationMatrix_.resize(inputData_.som_size);
+        }
+    }
+
+    if (inputData_.orientationWindow > 0.0) som_.updatePrincipalAxes();
+}
+
+void SOMMapper::map(int image)
+{
+    if (ptrIndex_) {
+        // The first rotated image is the unrotated cropped image
+        std::copy(rotatedImages_, rotatedImages_ + query_.size(), query_.begin());
+        applyCircularMask(&query_[0], inputData_.neuron_dim, inputData_.numberOfChannels);
+
+        int ef = std::max(inputData_.annEfSearch, inputData_.annTopK);
+        candidates_.clear();
+        for (auto const& neighbor : ptrIndex_->search(&query_[0], ef, ef)) {
+            int neuron = neighbor.second / inputData_.numberOfRotationsAndFlip;
+            if (std::find(candidates_.begin(), candidates_.end(), neuron) == candidates_.end()) {
+                candidates_.push_back(neuron);
+                if (static_cast<int>(candidates_.size()) == inputData_.annTopK) break;
+            }
+        }
+
+        generateEuclideanDistanceMatrixForNeurons(&euclideanDistanceMatrix_[0], &bestRotationMatrix_[0],
+            inputData_.som_size, som_.getDataPointer(), inputData_.numberOfChannels * inputData_.neuron_size,
+            inputData_.numberOfRotationsAndFlip, rotatedImages_, candidates_.data(), candidates_.size());
+
+        if (inputData_.annRecallSample and !(numberOfMappedImages_ % inputData_.annRecallSample)) {
+            generateEuclideanDistanceMatrix(&exactEuclideanDistanceMatrix_[0], &exactBestRotationMatrix_[0],
+                inputData_.som_size, som_.getDataPointer(), inputData_.numberOfChannels * inputData_.neuron_size,
+                inputData_.numberOfRotationsAndFlip, rotatedImages_, inputData_.distanceTile);
+
+            int exactBestMatch = findBestMatchingNeuron(&exactEuclideanDistanceMatrix_[0], inputData_.som_size);
+            ++numberOfRecallSamples_;
+            if (std::find(candidates_.begin(), candidates_.end(), exactBestMatch) != candidates_.end()) ++numberOfRecallHits_;
+            if (findBestMatchingNeuron(&euclideanDistanceMatrix_[0], inputData_.som_size) == exactBestMatch) ++numberOfEqualBestMatches_;
+        }
+    } else if (inputData_.resultTopK and !ptrPrototypes_) {
+        // The prototypes need the distances of all neurons
+        som_.computeBestMatches(&bestMatches_[0], &euclideanDistanceMatrix_[0], &bestRotationMatrix_[0], rotatedImages_);
+    } else {
+        som_.computeDistances(&euclideanDistanceMatrix_[0], &bestRotationMatrix_[0], rotatedImages_);
+    }
+    ++numberOfMappedImages_;
+
+    if (inputData_.resultTopK) {
+        if (ptrIndex_ or ptrPrototypes_) findBestMatchingNeurons(&bestMatches_[0], inputData_.resultTopK,
+            &euclideanDistanceMatrix_[0], &bestRotationMatrix_[0], inputData_.som_size);
+        resultWriter_.write(&bestMatches_[0]);
+        if (ptrNeuronStatistics_) ptrNeuronStatistics_->add(image, bestMatches_[0].neuron, bestMatches_[0].distance);
+    } else {
+        resultWriter_.write(&euclideanDistanceMatrix_[0], &bestRotationMatrix_[0]);
+        if (ptrNeuronStatistics_) {
+            int bestMatch = findBestMatchingNeuron(&euclideanDistanceMatrix_[0], inputData_.som_size);
+            ptrNeuronStatistics_->add(image, bestMatch, euclideanDistanceMatrix_[bestMatch]);
+        }
+    }
+
+    if (ptrPrototypes_) ptrPrototypes_->add(image, &euclideanDistanceMatrix_[0], &bestRotationMatrix_[0], cutout_);
+}
+
+void SOMMapper::close()
+{
+    if (!inputData_.additionalSOMFilenames.empty()) std::cout << "\n  SOM file = " << inputData_.somFilename << std::endl;
+
+    resultWriter_.close();
+    if (ptrNeuronStatistics_) ptrNeuronStatistics_->write(inputData_.neuronStatisticsFilename, inputData_);
+    if (ptrPrototypes_) ptrPrototypes_->write(inputData_.prototypesFilename, inputData_);
+    if (!inputData_.prototypeCutoutsFilename.empty()) ptrPrototypes_->writeCutouts(inputData_.prototypeCutoutsFilename, inputData_);
+    std::cout << "  Write stall time = " << std::setprecision(3) << resultWriter_.getStallTime() << " s" << std::endl;
+
+    if (numberOfRecallSamples_) {
+        std::cout << "\n  ANN recall of best matching neuron in top " << inputData_.annTopK << " = "
+                  << std::setprecision(4) << static_cast<float>(numberOfRecallHits_) / numberOfRecallSamples_
+                  << " (" << numberOfRecallSamples_ << " sampled images)" << std::endl;
+        std::cout << "  ANN agreement of best matching neuron = "
+                  << std::setprecision(4) << static_cast<float>(numberOfEqualBestMatches_) / numberOfRecallSamples_ << std::endl;
+    }
+}
+
+} // anonymous namespace
+
 void SOM::mapping()
 {
     std::cout << "  Starting C version of mapping.\n" << std::endl;
 
-    // Open result file
-    std::ofstream resultFile(inputData_.resultFilename);
-    if (!resultFile) fatalError("Error opening " + inputData_.resultFilename);
-    resultFile.write((char*)&inputData_.numberOfImages, sizeof(int));
-    resultFile.write((char*)&inputData_.som_width, sizeof(int));
-    resultFile.write((char*)&inputData_.som_height, sizeof(int));
-    resultFile.write((char*)&inputData_.som_depth, sizeof(int));
-
-    std::ofstream write_rot_flip_file;
-    if (inputData_.write_rot_flip) {
-        write_rot_flip_file.open(inputData_.rot_flip_filename);
-        if (!write_rot_flip_file) fatalError("Error opening " + inputData_.rot_flip_filename);
-        write_rot_flip_file.write((char*)&inputData_.numberOfImages, sizeof(int));
-        write_rot_flip_file.write((char*)&inputData_.som_width, sizeof(int));
-        write_rot_flip_file.write((char*)&inputData_.som_height, sizeof(int));
-        write_rot_flip_file.write((char*)&inputData_.som_depth, sizeof(int));
+    // The additional SOMs use the rotated images of this one
+    std::vector<std::unique_ptr<InputData>> additionalInputData;
+    std::vector<std::unique_ptr<SOM>> additionalSOMs;
+    for (int i = 0; i != static_cast<int>(inputData_.additionalSOMFilenames.size()); ++i) {
+        additionalInputData.emplace_back(new InputData(inputData_.getAdditionalSOMInputData(i)));
+        InputData const& inputData = *additionalInputData.back();
+        additionalSOMs.emplace_back(new SOM(inputData));
+        std::cout << "  Additional SOM " << inputData.somFilename << ": " << inputData.som_width << "x"
+                  << inputData.som_height << "x" << inputData.som_depth << ", " << inputData.layout << ", "
+                  << inputData.som_size << " neurons" << std::endl;
     }
+    if (!additionalSOMs.empty()) std::cout << std::endl;
 
     // Memory allocation
-    int rotatedImagesSize = inputData_.numberOfChannels * inputData_.numberOfRotations * inputData_.neuron_size;
-    if (inputData_.useFlip) rotatedImagesSize *= 2;
+    int rotatedImagesSize = getRotatedImagesSize();
     if (inputData_.verbose) std::cout << "  Size of rotated images = " << rotatedImagesSize * sizeof(float) << " bytes" << std::endl;
     std::vector<float> rotatedImages(rotatedImagesSize);
 
-    if (inputData_.verbose) std::cout << "  Size of euclidean distance matrix = " << inputData_.som_size * sizeof(float) << " bytes" << std::endl;
-    std::vector<float> euclideanDistanceMatrix(inputData_.som_size);
-
-    if (inputData_.verbose) std::cout << "  Size of best rotation matrix = " << inputData_.som_size * sizeof(int) << " bytes\n" << std::endl;
-    std::vector<int> bestRotationMatrix(inputData_.som_size);
-
-    float angleStepRadians = 2.0 * M_PI / inputData_.numberOfRotations;
+    std::vector<std::unique_ptr<SOMMapper>> mappers;
+    mappers.emplace_back(new SOMMapper(*this, inputData_, &rotatedImages[0]));
+    for (size_t i = 0; i != additionalSOMs.size(); ++i)
+        mappers.emplace_back(new SOMMapper(*additionalSOMs[i], *additionalInputData[i], &rotatedImages[0]));
 
     float progress = 0.0;
     float progressStep = 1.0 / inputData_.numberOfImages;
@@ -60,7 +258,7 @@ void SOM::mapping()
     auto startTime = myclock::now();
     int updateCount = 0;
 
-    for (ImageIterator<float> iterImage(inputData_.imagesFilename), iterEnd; iterImage != iterEnd; ++iterImage, ++updateCount)
+    for (ImageIterator<float> iterImage(inputData_.imagesFilename, inputData_.firstImage, inputData_.numberOfImages), iterEnd; iterImage != iterEnd; ++iterImage, ++updateCount)
     {
         if ((inputData_.progressFactor < 1.0 and progress > nextProgressPrint) or
             (inputData_.progressFactor >= 1.0 and updateCount != 0 and !(updateCount % static_cast<int>(inputData_.progressFactor))))
@@ -69,33 +267,21 @@ void SOM::mapping()
                  << std::fixed << std::setprecision(progressPrecision) << std::setw(3) << progress*100 << " % ("
                  << std::chrono::duration_cast<std::chrono::seconds>(myclock::now() - startTime).count() << " s)" << std::endl;
 
+            for (auto& mapper : mappers) mapper->flush();
             nextProgressPrint += inputData_.progressFactor;
             startTime = myclock::now();
         }
         progress += progressStep;
 
-        generateRotatedImages(&rotatedImages[0], iterImage->getPointerOfFirstPixel(), inputData_.numberOfRotations,
-            inputData_.image_dim, inputData_.neuron_dim, inputData_.useFlip, inputData_.interpolation,
-            inputData_.numberOfChannels);
+        computeRotatedImages(&rotatedImages[0], iterImage);
 
-        generateEuclideanDistanceMatrix(&euclideanDistanceMatrix[0], &bestRotationMatrix[0],
-            inputData_.som_size, &som_[0], inputData_.numberOfChannels * inputData_.neuron_size,
-            inputData_.numberOfRotationsAndFlip, &rotatedImages[0]);
-
-        resultFile.write((char*)&euclideanDistanceMatrix[0], inputData_.som_size * sizeof(float));
-
-        if (inputData_.write_rot_flip) {
-        	for (int i = 0; i != inputData_.som_size; ++i) {
-        		char flip = bestRotationMatrix[i] / inputData_.numberOfRotations;
-        		float angle = (bestRotationMatrix[i] % inputData_.numberOfRotations) * angleStepRadians;
-        	    write_rot_flip_file.write(&flip, sizeof(char));
-        	    write_rot_flip_file.write((char*)&angle, sizeof(float));
-        	}
-        }
+        for (auto& mapper : mappers) mapper->map(inputData_.firstImage + updateCount);
     }
 
     std::cout << "  Progress: " << std::setw(12) << updateCount << " updates, 100 % ("
          << std::chrono::duration_cast<std::chrono::seconds>(myclock::now() - startTime).count() << " s)" << std::endl;
+
+    for (auto& mapper : mappers) mapper->close();
 }
 
 } // namespace pink
@@ -25,8 +25,7 @@ void SOM::training()
     std::cout << "  Starting C version of training.\n" << std::endl;
 
     // Memory allocation
-    int rotatedImagesSize = inputData_.numberOfChannels * inputData_.numberOfRotations * inputData_.neuron_size;
-    if (inputData_.useFlip) rotatedImagesSize *= 2;
+    int rotatedImagesSize = getRotatedImagesSize();
     if (inputData_.verbose) std::cout << "  Size of rotated images = " << rotatedImagesSize * sizeof(float) << " bytes" << std::endl;
     std::vector<float> rotatedImages(rotatedImagesSize);
 
@@ -52,9 +51,11 @@ void SOM::training()
     int interStoreCount = 0;
     int updateCount = 0;
 
+    if (inputData_.orientationWindow > 0.0) updatePrincipalAxes();
+
     for (int iter = 0; iter != inputData_.numIter; ++iter)
     {
-        for (ImageIterator<float> iterImage(inputData_.imagesFilename), iterEnd; iterImage != iterEnd; ++iterImage, ++updateCount)
+        for (ImageIterator<float> iterImage(inputData_.imagesFilename, inputData_.firstImage, inputData_.numberOfImages), iterEnd; iterImage != iterEnd; ++iterImage, ++updateCount)
         {
             if ((inputData_.progressFactor < 1.0 and progress > nextProgressPrint) or
                 (inputData_.progressFactor >= 1.0 and updateCount != 0 and !(updateCount % static_cast<int>(inputData_.progressFactor))))
@@ -87,16 +88,12 @@ void SOM::training()
 
             {
                 TimeAccumulator localTimeAccumulator(timer[0]);
-                generateRotatedImages(&rotatedImages[0], iterImage->getPointerOfFirstPixel(), inputData_.numberOfRotations,
-                    inputData_.image_dim, inputData_.neuron_dim, inputData_.useFlip, inputData_.interpolation,
-                    inputData_.numberOfChannels);
+                computeRotatedImages(&rotatedImages[0], iterImage);
             }
 
             {
                 TimeAccumulator localTimeAccumulator(timer[1]);
-                generateEuclideanDistanceMatrix(&euclideanDistanceMatrix[0], &bestRotationMatrix[0],
-                    inputData_.som_size, &som_[0], inputData_.numberOfChannels * inputData_.neuron_size,
-                    inputData_.numberOfRotationsAndFlip, &rotatedImages[0]);
+                computeDistances(&euclideanDistanceMatrix[0], &bestRotationMatrix[0], &rotatedImages[0]);
             }
 
             {
@@ -104,6 +101,7 @@ void SOM::training()
                 int bestMatch = findBestMatchingNeuron(&euclideanDistanceMatrix[0], inputData_.som_size);
                 updateCounter(bestMatch);
                 updateNeurons(&rotatedImages[0], bestMatch, &bestRotationMatrix[0]);
+                if (inputData_.orientationWindow > 0.0) updatePrincipalAxes();
             }
         }
     }
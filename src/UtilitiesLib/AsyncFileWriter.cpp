@@ -0,0 +1,222 @@
+/**
+ * @file   UtilitiesLib/AsyncFileWriter.cpp
+ * @brief  Buffered file output written by a background thread.
+ * @date   Oct 19, 2026
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <unistd.h>
+
+#include "AsyncFileWriter.h"
+
+namespace pink {
+
+namespace {
+
+//! Write size bytes at file offset.
+void writeAt(int fd, char const *data, size_t size, int64_t offset)
+{
+    while (size > 0) {
+        ssize_t n = pwrite(fd, data, size, offset);
+        if (n < 0 and errno == EINTR) continue;
+        if (n <= 0) throw std::runtime_error("AsyncFileWriter: write error, " + std::string(std::strerror(errno)));
+        data += n;
+        size -= n;
+        offset += n;
+    }
+}
+
+size_t alignUp(size_t size)
+{
+    return (size + AsyncFileWriter::alignment - 1) / AsyncFileWriter::alignment * AsyncFileWriter::alignment;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // anonymous namespace
+
+AsyncFileWriter::AsyncFileWriter(std::string const& filename, size_t bufferSize, int numberOfBuffers, bool directIO)
+ : fd_(-1),
+   directIO_(directIO),
+   bufferSize_(alignUp(std::max<size_t>(bufferSize, 1))),
+   buffersInFlight_(0),
+   current_(0),
+   size_(0),
+   stallTime_(0.0),
+   stop_(false)
+{
+    if (numberOfBuffers < 2) throw std::runtime_error("AsyncFileWriter: at least two buffers are needed.");
+
+    const int flags = O_WRONLY | O_CREAT | O_TRUNC;
+    if (directIO_) {
+        fd_ = open(filename.c_str(), flags | O_DIRECT, 0644);
+        // Not supported by the file system, e.g. tmpfs
+        if (fd_ < 0 and errno == EINVAL) directIO_ = false;
+    }
+    if (!directIO_) fd_ = open(filename.c_str(), flags, 0644);
+    if (fd_ < 0) throw std::runtime_error("AsyncFileWriter: Error opening " + filename);
+
+    for (int i = 0; i < numberOfBuffers; ++i) {
+        void *data = nullptr;
+        if (posix_memalign(&data, alignment, bufferSize_) != 0) {
+            for (auto& buffer : buffers_) std::free(buffer.data);
+            ::close(fd_);
+            throw std::bad_alloc();
+        }
+        buffers_.push_back(Buffer{static_cast<char*>(data), 0, 0});
+        if (i != current_) free_.push_back(i);
+    }
+
+    thread_ = std::thread(&AsyncFileWriter::run, this);
+}
+
+AsyncFileWriter::~AsyncFileWriter()
+{
+    try {
+        close();
+    } catch (std::exception const& e) {
+        std::cerr << e.what() << std::endl;
+    }
+}
+
+void AsyncFileWriter::write(void const *data, size_t size)
+{
+    char const *p = static_cast<char const*>(data);
+    while (size > 0) {
+        Buffer& buffer = buffers_[current_];
+        size_t n = std::min(size, bufferSize_ - buffer.size);
+        std::memcpy(buffer.data + buffer.size, p, n);
+        buffer.size += n;
+        size_ += n;
+        p += n;
+        size -= n;
+        if (buffer.size == bufferSize_) submit();
+    }
+}
+
+void AsyncFileWriter::submit()
+{
+    Buffer& buffer = buffers_[current_];
+    int64_t nextOffset = buffer.offset + buffer.size;
+
+    // O_DIRECT writes whole blocks, the unaligned tail is written again with the next buffer
+    char tail[alignment];
+    size_t tailSize = 0;
+    if (directIO_) {
+        tailSize = buffer.size % alignment;
+        nextOffset -= tailSize;
+        std::memcpy(tail, buffer.data + buffer.size - tailSize, tailSize);
+        std::memset(buffer.data + buffer.size, 0, alignUp(buffer.size) - buffer.size);
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    pending_.push_back(current_);
+    ++buffersInFlight_;
+    condition_.notify_all();
+
+    if (free_.empty()) {
+        auto start = std::chrono::steady_clock::now();
+        condition_.wait(lock, [&]{ return exception_ or !free_.empty(); });
+        stallTime_ += secondsSince(start);
+    }
+    if (exception_) std::rethrow_exception(exception_);
+
+    current_ = free_.front();
+    free_.pop_front();
+    lock.unlock();
+
+    Buffer& next = buffers_[current_];
+    next.offset = nextOffset;
+    next.size = tailSize;
+    std::memcpy(next.data, tail, tailSize);
+}
+
+void AsyncFileWriter::flush()
+{
+    if (buffers_[current_].size) submit();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto start = std::chrono::steady_clock::now();
+    condition_.wait(lock, [&]{ return exception_ or buffersInFlight_ == 0; });
+    checkError();
+
+    // Remove the padding of the last block, the file is complete at checkpoints
+    if (directIO_ and ftruncate(fd_, size_) != 0)
+        throw std::runtime_error("AsyncFileWriter: truncate error, " + std::string(std::strerror(errno)));
+    stallTime_ += secondsSince(start);
+}
+
+void AsyncFileWriter::checkError()
+{
+    if (exception_) std::rethrow_exception(exception_);
+}
+
+void AsyncFileWriter::close()
+{
+    if (fd_ < 0) return;
+
+    std::exception_ptr error;
+    try {
+        flush();
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    condition_.notify_all();
+    thread_.join();
+
+    if (::close(fd_) != 0 and !error)
+        error = std::make_exception_ptr(std::runtime_error("AsyncFileWriter: close error, " + std::string(std::strerror(errno))));
+    fd_ = -1;
+
+    for (auto& buffer : buffers_) std::free(buffer.data);
+    buffers_.clear();
+
+    if (error) std::rethrow_exception(error);
+}
+
+void AsyncFileWriter::run()
+{
+    for (;;) {
+        int index;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [&]{ return stop_ or !pending_.empty(); });
+            if (pending_.empty()) return;
+            index = pending_.front();
+            pending_.pop_front();
+        }
+
+        Buffer const& buffer = buffers_[index];
+        try {
+            writeAt(fd_, buffer.data, directIO_ ? alignUp(buffer.size) : buffer.size, buffer.offset);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!exception_) exception_ = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            free_.push_back(index);
+            --buffersInFlight_;
+        }
+        condition_.notify_all();
+    }
+}
+
+} // namespace pink
@@ -0,0 +1,116 @@
+/**
+ * @file   UtilitiesLib/AsyncFileWriter.h
+ * @brief  Buffered file output written by a background thread.
+ * @date   Oct 19, 2026
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace pink {
+
+/**
+ * @brief Sequential file output through large aligned buffers.
+ *
+ * @write copies into the current buffer, full buffers are written by a background thread
+ * with pwrite in the order of submission. The caller only waits if all buffers are in flight,
+ * the accumulated waiting time is reported by @getStallTime.
+ *
+ * With directIO the file is opened with O_DIRECT, the page cache is bypassed.
+ * Partial buffers are written padded to the alignment, the file is truncated to its size by @flush.
+ * If the file system does not support O_DIRECT the normal mode is used.
+ *
+ * Errors of the background thread are rethrown by the next @write, @flush or @close.
+ */
+class AsyncFileWriter
+{
+public:
+
+    //! Alignment of the buffers, file offsets and sizes for O_DIRECT.
+    static const size_t alignment = 4096;
+
+    AsyncFileWriter(std::string const& filename, size_t bufferSize = 4 << 20, int numberOfBuffers = 4, bool directIO = false);
+
+    //! Close the file, errors are printed.
+    ~AsyncFileWriter();
+
+    AsyncFileWriter(AsyncFileWriter const&) = delete;
+    AsyncFileWriter& operator = (AsyncFileWriter const&) = delete;
+
+    void write(void const *data, size_t size);
+
+    //! Write all data submitted so far and wait for its completion, e.g. at checkpoints.
+    void flush();
+
+    //! Flush, stop the background thread and close the file.
+    void close();
+
+    bool isDirectIO() const { return directIO_; }
+
+    //! Number of bytes written by @write.
+    int64_t getSize() const { return size_; }
+
+    //! Seconds the caller waited for free buffers and flushes.
+    double getStallTime() const { return stallTime_; }
+
+private:
+
+    struct Buffer
+    {
+        char *data;
+        size_t size;
+        int64_t offset;
+    };
+
+    //! Loop of the background thread.
+    void run();
+
+    //! Hand the current buffer to the background thread and wait for a free one.
+    void submit();
+
+    //! Rethrow the error of the background thread.
+    void checkError();
+
+    int fd_;
+
+    bool directIO_;
+
+    size_t bufferSize_;
+
+    std::vector<Buffer> buffers_;
+
+    //! Indices of buffers waiting to be written and of free buffers.
+    std::deque<int> pending_;
+    std::deque<int> free_;
+
+    //! Buffers in pending_ or written by the background thread.
+    int buffersInFlight_;
+
+    //! Buffer filled by @write.
+    int current_;
+
+    int64_t size_;
+
+    double stallTime_;
+
+    std::thread thread_;
+
+    std::mutex mutex_;
+
+    std::condition_variable condition_;
+
+    std::exception_ptr exception_;
+
+    bool stop_;
+
+};
+
+} // namespace pink
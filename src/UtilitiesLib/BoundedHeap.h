@@ -0,0 +1,84 @@
+/**
+ * @file   UtilitiesLib/BoundedHeap.h
+ * @brief  Keep the smallest values of a stream.
+ * @date   Oct 19, 2026
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+namespace pink {
+
+/**
+ * @brief Max-heap of at most capacity values, the largest value is replaced by smaller ones.
+ *
+ * After pushing a stream of values the heap contains the capacity smallest values
+ * with respect to Compare. Heaps of parts of a stream can be merged.
+ */
+template <class T, class Compare = std::less<T>>
+class BoundedHeap
+{
+public:
+
+    BoundedHeap(int capacity = 0)
+     : capacity_(std::max(capacity, 0))
+    {
+        heap_.reserve(capacity_);
+    }
+
+    //! Insert value if the heap is not full or value is smaller than the largest value, returns true if inserted.
+    bool push(T const& value)
+    {
+        if (static_cast<int>(heap_.size()) < capacity_) {
+            heap_.push_back(value);
+            std::push_heap(heap_.begin(), heap_.end(), compare_);
+            return true;
+        }
+        if (capacity_ == 0 or !compare_(value, heap_.front())) return false;
+        std::pop_heap(heap_.begin(), heap_.end(), compare_);
+        heap_.back() = value;
+        std::push_heap(heap_.begin(), heap_.end(), compare_);
+        return true;
+    }
+
+    //! Push all values of other.
+    void merge(BoundedHeap const& other)
+    {
+        for (auto const& value : other.heap_) push(value);
+    }
+
+    //! Largest value, the heap must not be empty.
+    T const& top() const { return heap_.front(); }
+
+    bool full() const { return static_cast<int>(heap_.size()) == capacity_; }
+
+    bool empty() const { return heap_.empty(); }
+
+    int size() const { return heap_.size(); }
+
+    int capacity() const { return capacity_; }
+
+    void clear() { heap_.clear(); }
+
+    //! Values in ascending order.
+    std::vector<T> sorted() const
+    {
+        std::vector<T> values(heap_);
+        std::sort_heap(values.begin(), values.end(), compare_);
+        return values;
+    }
+
+private:
+
+    int capacity_;
+
+    std::vector<T> heap_;
+
+    Compare compare_;
+
+};
+
+} // namespace pink
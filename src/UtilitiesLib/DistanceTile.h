@@ -0,0 +1,42 @@
+/**
+ * @file   UtilitiesLib/DistanceTile.h
+ * @date   Oct 18, 2026
+ */
+
+#pragma once
+
+#include <iostream>
+
+namespace pink {
+
+//! Number of neurons and rotated images compared at once by the register-blocked distance kernel.
+struct DistanceTile
+{
+    //! Default tile, fastest for SSE2, AVX2 and AVX-512 builds on x86-64.
+    DistanceTile()
+     : neurons(2), rotations(4)
+    {}
+
+    DistanceTile(int neurons, int rotations)
+     : neurons(neurons), rotations(rotations)
+    {}
+
+    int neurons;
+    int rotations;
+};
+
+//! Returns true if a distance kernel for the tile is available.
+inline bool isSupportedDistanceTile(DistanceTile const& tile)
+{
+    int n = tile.neurons, r = tile.rotations;
+    return (n == 1 and r == 1) or (n == 2 and r == 2) or (n == 2 and r == 4) or (n == 4 and r == 2)
+        or (n == 4 and r == 4) or (n == 4 and r == 8) or (n == 8 and r == 4);
+}
+
+//! Pretty printing of DistanceTile.
+inline std::ostream& operator << (std::ostream& os, DistanceTile const& tile)
+{
+    return os << tile.neurons << "x" << tile.rotations;
+}
+
+} // namespace pink
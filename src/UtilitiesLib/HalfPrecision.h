@@ -0,0 +1,151 @@
+/**
+ * @file   UtilitiesLib/HalfPrecision.h
+ * @brief  16 bit floating point types for storage, arithmetic is done in float.
+ * @date   Oct 18, 2026
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#ifdef __F16C__
+#include <immintrin.h>
+#endif
+
+namespace pink {
+
+//! Convert float to bfloat16 bits, round to nearest even.
+inline uint16_t floatToBFloat16Bits(float f)
+{
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof(float));
+    if ((u & 0x7fffffff) > 0x7f800000) return (u >> 16) | 0x40;
+    u += 0x7fff + ((u >> 16) & 1);
+    return u >> 16;
+}
+
+//! Convert bfloat16 bits to float, exact.
+inline float bfloat16BitsToFloat(uint16_t h)
+{
+    uint32_t u = static_cast<uint32_t>(h) << 16;
+    float f;
+    std::memcpy(&f, &u, sizeof(float));
+    return f;
+}
+
+//! Convert float to IEEE 754 half precision bits, round to nearest even.
+inline uint16_t floatToFloat16Bits(float f)
+{
+#ifdef __F16C__
+    return _cvtss_sh(f, 0);
+#else
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof(float));
+    uint16_t sign = (u >> 16) & 0x8000;
+    uint32_t a = u & 0x7fffffff;
+
+    // Infinity and NaN
+    if (a >= 0x7f800000) return sign | 0x7c00 | (a > 0x7f800000 ? 0x200 : 0);
+
+    // Overflow, 65520 and above are rounded to infinity
+    if (a >= 0x477ff000) return sign | 0x7c00;
+
+    // Subnormal or zero, the scaling by 2^24 is exact
+    if (a < 0x38800000) {
+        float abs;
+        std::memcpy(&abs, &a, sizeof(float));
+        return sign | static_cast<uint16_t>(std::nearbyint(abs * 16777216.0f));
+    }
+
+    // Normal, rebias exponent from 127 to 15
+    a -= 0x38000000;
+    a += 0xfff + ((a >> 13) & 1);
+    return sign | (a >> 13);
+#endif
+}
+
+//! Convert IEEE 754 half precision bits to float, exact.
+inline float float16BitsToFloat(uint16_t h)
+{
+#ifdef __F16C__
+    return _cvtsh_ss(h);
+#else
+    uint32_t sign = static_cast<uint32_t>(h & 0x8000) << 16;
+    uint32_t exponent = (h >> 10) & 0x1f;
+    uint32_t mantissa = h & 0x3ff;
+    uint32_t u;
+
+    if (exponent == 0) {
+        float f = mantissa * (1.0f / 16777216.0f);
+        return sign ? -f : f;
+    }
+    else if (exponent == 31) u = sign | 0x7f800000 | (mantissa << 13);
+    else u = sign | ((exponent + 112) << 23) | (mantissa << 13);
+
+    float f;
+    std::memcpy(&f, &u, sizeof(float));
+    return f;
+#endif
+}
+
+//! Brain floating point: 8 bit exponent, 7 bit mantissa.
+struct bfloat16
+{
+    bfloat16() = default;
+
+    explicit bfloat16(float f) : bits(floatToBFloat16Bits(f)) {}
+
+    operator float() const { return bfloat16BitsToFloat(bits); }
+
+    uint16_t bits;
+};
+
+//! IEEE 754 half precision: 5 bit exponent, 10 bit mantissa.
+struct float16
+{
+    float16() = default;
+
+    explicit float16(float f) : bits(floatToFloat16Bits(f)) {}
+
+    operator float() const { return float16BitsToFloat(bits); }
+
+    uint16_t bits;
+};
+
+//! Convert array of floats into reduced precision.
+template <class T>
+void convertFromFloat(T *dest, float const *src, size_t length)
+{
+    for (size_t i = 0; i < length; ++i) dest[i] = T(src[i]);
+}
+
+//! Convert array of reduced precision into floats.
+template <class T>
+void convertToFloat(float *dest, T const *src, size_t length)
+{
+    for (size_t i = 0; i < length; ++i) dest[i] = src[i];
+}
+
+#ifdef __F16C__
+//! Convert array of floats into float16, eight values at once.
+inline void convertFromFloat(float16 *dest, float const *src, size_t length)
+{
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8)
+        _mm_storeu_si128((__m128i*)(dest + i), _mm256_cvtps_ph(_mm256_loadu_ps(src + i), 0));
+    for (; i < length; ++i) dest[i] = float16(src[i]);
+}
+
+//! Convert array of float16 into floats, eight values at once.
+inline void convertToFloat(float *dest, float16 const *src, size_t length)
+{
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8)
+        _mm256_storeu_ps(dest + i, _mm256_cvtph_ps(_mm_loadu_si128((__m128i const*)(src + i))));
+    for (; i < length; ++i) dest[i] = src[i];
+}
+#endif
+
+} // namespace pink
@@ -5,6 +5,8 @@
  */
 
 #include <cmath>
+#include <cstdint>
+#include <fstream>
 #include <getopt.h>
 #include <iostream>
 #include <omp.h>
@@ -34,9 +36,11 @@ InputData::InputData()
    progressFactor(0.1),
    useFlip(true),
    useCuda(true),
-   numberOfImages(0),
+   firstImage(0),
+   numberOfImages(-1),
    numberOfChannels(0),
    image_dim(0),
+   imagePixelType(PixelType::FLOAT32),
    image_size(0),
    som_size(0),
    neuron_size(0),
@@ -53,7 +57,29 @@ InputData::InputData()
    useMultipleGPUs(true),
    usePBC(false),
    dimensionality(1),
-   write_rot_flip(false)
+   write_rot_flip(false),
+   resultTopK(0),
+   resultEncoding(ResultEncoding::FLOAT32),
+   resultCompression(ImageCodec::NONE),
+   writeBufferSize(4),
+   directIO(false),
+   neuronStatisticsExamples(10),
+   numberOfPrototypes(10),
+   annTopK(0),
+   annM(16),
+   annEfConstruction(200),
+   annEfSearch(64),
+   annRecallSample(100),
+   orientationWindow(0.0),
+   minAnisotropy(0.1),
+   rotationLayout(RotationLayout::BLOCKED),
+   distanceTile(),
+   storage(StorageType::FLOAT32),
+   writeCompactSOM(false),
+   prefilter(Prefilter::OFF),
+   rerankCandidates(8),
+   pcaComponents(32),
+   pcaRefresh(0)
 {}
 
 InputData::InputData(int argc, char **argv)
@@ -86,6 +112,33 @@ InputData::InputData(int argc, char **argv)
         {"som-depth",           1, 0, 13},
         {"pbc",                 0, 0, 14},
 		{"store-rot-flip",      1, 0, 15},
+        {"ann-top-k",           1, 0, 16},
+        {"ann-m",               1, 0, 17},
+        {"ann-ef-construction", 1, 0, 18},
+        {"ann-ef-search",       1, 0, 19},
+        {"ann-recall-sample",   1, 0, 20},
+        {"orientation-prior",   1, 0, 21},
+        {"min-anisotropy",      1, 0, 22},
+        {"rotation-layout",     1, 0, 23},
+        {"distance-tile",       1, 0, 24},
+        {"storage",             1, 0, 25},
+        {"compact-som",         0, 0, 26},
+        {"prefilter",           1, 0, 27},
+        {"rerank-candidates",   1, 0, 28},
+        {"pca-components",      1, 0, 29},
+        {"pca-refresh",         1, 0, 30},
+        {"first-image",         1, 0, 31},
+        {"num-images",          1, 0, 32},
+        {"result-top-k",        1, 0, 33},
+        {"result-encoding",     1, 0, 34},
+        {"result-compression",  1, 0, 35},
+        {"write-buffer",        1, 0, 36},
+        {"direct-io",           0, 0, 37},
+        {"neuron-stats",        1, 0, 38},
+        {"neuron-stats-examples", 1, 0, 39},
+        {"prototypes",          1, 0, 40},
+        {"num-prototypes",      1, 0, 41},
+        {"prototype-cutouts",   1, 0, 42},
         {NULL, 0, NULL, 0}
     };
     int c, option_index = 0;
@@ -199,6 +252,7 @@ InputData::InputData(int argc, char **argv)
                 stringToUpper(optarg);
                 if (strcmp(optarg, "NEAREST_NEIGHBOR") == 0) interpolation = Interpolation::NEAREST_NEIGHBOR;
                 else if (strcmp(optarg, "BILINEAR") == 0) interpolation = Interpolation::BILINEAR;
+                else if (strcmp(optarg, "SHEAR") == 0) interpolation = Interpolation::SHEAR;
                 else {
                     print_usage();
                     printf ("optarg = %s\n", optarg);
@@ -228,6 +282,11 @@ InputData::InputData(int argc, char **argv)
                 resultFilename = strdup(argv[index++]);
                 if (index >= argc or argv[index][0] == '-') fatalError("Missing arguments for --map option.");
                 somFilename = strdup(argv[index++]);
+                // Further pairs of result and SOM file share the rotated images
+                while (index + 1 < argc and argv[index][0] != '-' and argv[index + 1][0] != '-') {
+                    additionalResultFilenames.push_back(argv[index++]);
+                    additionalSOMFilenames.push_back(argv[index++]);
+                }
                 optind = index - 1;
                 break;
             }
@@ -275,6 +334,253 @@ InputData::InputData(int argc, char **argv)
             	rot_flip_filename = optarg;
                 break;
             }
+            case 16:
+            {
+                annTopK = atoi(optarg);
+                if (annTopK < 0) {
+                    print_usage();
+                    fatalError("ann-top-k must not be negative.");
+                }
+                break;
+            }
+            case 17:
+            {
+                annM = atoi(optarg);
+                if (annM < 2) {
+                    print_usage();
+                    fatalError("ann-m must be larger than 1.");
+                }
+                break;
+            }
+            case 18:
+            {
+                annEfConstruction = atoi(optarg);
+                if (annEfConstruction < 1) {
+                    print_usage();
+                    fatalError("ann-ef-construction must be positive.");
+                }
+                break;
+            }
+            case 19:
+            {
+                annEfSearch = atoi(optarg);
+                if (annEfSearch < 1) {
+                    print_usage();
+                    fatalError("ann-ef-search must be positive.");
+                }
+                break;
+            }
+            case 20:
+            {
+                annRecallSample = atoi(optarg);
+                if (annRecallSample < 0) {
+                    print_usage();
+                    fatalError("ann-recall-sample must not be negative.");
+                }
+                break;
+            }
+            case 21:
+            {
+                orientationWindow = atof(optarg) * M_PI / 180.0;
+                if (orientationWindow < 0.0) {
+                    print_usage();
+                    fatalError("orientation-prior must not be negative.");
+                }
+                break;
+            }
+            case 22:
+            {
+                minAnisotropy = atof(optarg);
+                if (minAnisotropy < 0.0 or minAnisotropy > 1.0) {
+                    print_usage();
+                    fatalError("min-anisotropy must be within [0,1].");
+                }
+                break;
+            }
+            case 23:
+            {
+                stringToUpper(optarg);
+                if (strcmp(optarg, "BLOCKED") == 0) rotationLayout = RotationLayout::BLOCKED;
+                else if (strcmp(optarg, "INTERLEAVED") == 0) rotationLayout = RotationLayout::INTERLEAVED;
+                else if (strcmp(optarg, "DIHEDRAL") == 0) rotationLayout = RotationLayout::DIHEDRAL;
+                else {
+                    printf ("optarg = %s\n", optarg);
+                    printf ("Unkown option %o\n", c);
+                    print_usage();
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            }
+            case 24:
+            {
+                if (sscanf(optarg, "%dx%d", &distanceTile.neurons, &distanceTile.rotations) != 2
+                    or !isSupportedDistanceTile(distanceTile)) {
+                    print_usage();
+                    fatalError("distance-tile must be one of 1x1, 2x2, 2x4, 4x2, 4x4, 4x8, 8x4.");
+                }
+                break;
+            }
+            case 25:
+            {
+                stringToUpper(optarg);
+                if (strcmp(optarg, "FLOAT32") == 0) storage = StorageType::FLOAT32;
+                else if (strcmp(optarg, "BFLOAT16") == 0) storage = StorageType::BFLOAT16;
+                else if (strcmp(optarg, "FLOAT16") == 0) storage = StorageType::FLOAT16;
+                else {
+                    printf ("optarg = %s\n", optarg);
+                    printf ("Unkown option %o\n", c);
+                    print_usage();
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            }
+            case 26:
+            {
+                writeCompactSOM = true;
+                break;
+            }
+            case 27:
+            {
+                stringToUpper(optarg);
+                if (strcmp(optarg, "OFF") == 0) prefilter = Prefilter::OFF;
+                else if (strcmp(optarg, "INT8") == 0) prefilter = Prefilter::INT8;
+                else if (strcmp(optarg, "PCA") == 0) prefilter = Prefilter::PCA;
+                else {
+                    printf ("optarg = %s\n", optarg);
+                    printf ("Unkown option %o\n", c);
+                    print_usage();
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            }
+            case 28:
+            {
+                rerankCandidates = atoi(optarg);
+                if (rerankCandidates < 1) {
+                    print_usage();
+                    fatalError("rerank-candidates must be positive.");
+                }
+                break;
+            }
+            case 29:
+            {
+                pcaComponents = atoi(optarg);
+                if (pcaComponents < 1) {
+                    print_usage();
+                    fatalError("pca-components must be positive.");
+                }
+                break;
+            }
+            case 30:
+            {
+                pcaRefresh = atoi(optarg);
+                if (pcaRefresh < 0) {
+                    print_usage();
+                    fatalError("pca-refresh must not be negative.");
+                }
+                break;
+            }
+            case 31:
+            {
+                firstImage = atoi(optarg);
+                if (firstImage < 0) {
+                    print_usage();
+                    fatalError("first-image must not be negative.");
+                }
+                break;
+            }
+            case 32:
+            {
+                numberOfImages = atoi(optarg);
+                if (numberOfImages < 1) {
+                    print_usage();
+                    fatalError("num-images must be positive.");
+                }
+                break;
+            }
+            case 33:
+            {
+                resultTopK = atoi(optarg);
+                if (resultTopK < 1) {
+                    print_usage();
+                    fatalError("result-top-k must be positive.");
+                }
+                break;
+            }
+            case 34:
+            {
+                stringToUpper(optarg);
+                if (strcmp(optarg, "FLOAT32") == 0) resultEncoding = ResultEncoding::FLOAT32;
+                else if (strcmp(optarg, "FLOAT16") == 0) resultEncoding = ResultEncoding::FLOAT16;
+                else if (strcmp(optarg, "UINT16") == 0) resultEncoding = ResultEncoding::UINT16;
+                else {
+                    printf ("optarg = %s\n", optarg);
+                    printf ("Unkown option %o\n", c);
+                    print_usage();
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            }
+            case 35:
+            {
+                stringToUpper(optarg);
+                if (strcmp(optarg, "NONE") == 0) resultCompression = ImageCodec::NONE;
+                else if (strcmp(optarg, "ZLIB") == 0) resultCompression = ImageCodec::ZLIB;
+                else {
+                    printf ("optarg = %s\n", optarg);
+                    printf ("Unkown option %o\n", c);
+                    print_usage();
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            }
+            case 36:
+            {
+                writeBufferSize = atoi(optarg);
+                if (writeBufferSize < 1) {
+                    print_usage();
+                    fatalError("write-buffer must be positive.");
+                }
+                break;
+            }
+            case 37:
+            {
+                directIO = true;
+                break;
+            }
+            case 38:
+            {
+                neuronStatisticsFilename = optarg;
+                break;
+            }
+            case 39:
+            {
+                neuronStatisticsExamples = atoi(optarg);
+                if (neuronStatisticsExamples < 0) {
+                    print_usage();
+                    fatalError("neuron-stats-examples must not be negative.");
+                }
+                break;
+            }
+            case 40:
+            {
+                prototypesFilename = optarg;
+                break;
+            }
+            case 41:
+            {
+                numberOfPrototypes = atoi(optarg);
+                if (numberOfPrototypes < 1) {
+                    print_usage();
+                    fatalError("num-prototypes must be positive.");
+                }
+                break;
+            }
+            case 42:
+            {
+                prototypeCutoutsFilename = optarg;
+                break;
+            }
             case 'v':
             {
                 std::cout << "Pink version " << PROJECT_VERSION << std::endl;
@@ -331,7 +637,32 @@ InputData::InputData(int argc, char **argv)
         fatalError("Unkown execution path.");
     }
 
-    ImageIterator<float> iterImage(imagesFilename);
+    if (annTopK and executionPath != ExecutionPath::MAP) fatalError("ann-top-k is only supported for mapping.");
+    if (resultTopK and executionPath != ExecutionPath::MAP) fatalError("result-top-k is only supported for mapping.");
+    if (resultTopK and write_rot_flip) fatalError("store-rot-flip can not be combined with result-top-k, the rotations are part of the result.");
+    if (resultTopK and annTopK and resultTopK > annTopK) fatalError("result-top-k must not be larger than ann-top-k.");
+    if ((resultEncoding != ResultEncoding::FLOAT32 or resultCompression != ImageCodec::NONE) and executionPath != ExecutionPath::MAP)
+        fatalError("result-encoding and result-compression are only supported for mapping.");
+    if (!neuronStatisticsFilename.empty() and executionPath != ExecutionPath::MAP) fatalError("neuron-stats is only supported for mapping.");
+    if (!prototypesFilename.empty() and executionPath != ExecutionPath::MAP) fatalError("prototypes is only supported for mapping.");
+    if (!prototypeCutoutsFilename.empty() and prototypesFilename.empty()) fatalError("prototype-cutouts requires prototypes.");
+    if (resultEncoding != ResultEncoding::FLOAT32 and resultTopK) fatalError("result-encoding can not be combined with result-top-k.");
+#ifndef PINK_USE_ZLIB
+    if (resultCompression == ImageCodec::ZLIB) fatalError("result-compression zlib is not available, Pink was built without zlib.");
+#endif
+    if (annTopK and orientationWindow > 0.0) fatalError("ann-top-k and orientation-prior can not be combined.");
+    if (rotationLayout != RotationLayout::BLOCKED and (annTopK or orientationWindow > 0.0))
+        fatalError("ann-top-k and orientation-prior are only supported for blocked rotation layout.");
+    if (storage != StorageType::FLOAT32 and (annTopK or orientationWindow > 0.0 or rotationLayout != RotationLayout::BLOCKED))
+        fatalError("storage is only supported for blocked rotation layout without ann-top-k and orientation-prior.");
+    if (writeCompactSOM and storage == StorageType::FLOAT32) fatalError("compact-som requires storage bfloat16 or float16.");
+    if (prefilter == Prefilter::INT8 and executionPath != ExecutionPath::MAP) fatalError("prefilter int8 is only supported for mapping.");
+    if (prefilter != Prefilter::OFF and (annTopK or orientationWindow > 0.0 or rotationLayout != RotationLayout::BLOCKED
+        or storage != StorageType::FLOAT32))
+        fatalError("prefilter can not be combined with ann-top-k, orientation-prior, rotation-layout or storage.");
+
+    ImageIterator<float> iterImage(imagesFilename, firstImage, numberOfImages);
+    if (iterImage.getNumberOfImages() == 0) fatalError("No images selected, first-image is at the end of the image file.");
 
     if (iterImage->getWidth() != iterImage->getHeight()) {
         print_usage();
@@ -341,6 +672,7 @@ InputData::InputData(int argc, char **argv)
     numberOfImages = iterImage.getNumberOfImages();
     numberOfChannels = iterImage.getNumberOfChannels();
     image_dim = iterImage->getWidth();
+    imagePixelType = iterImage.getPixelType();
     image_size = image_dim * image_dim;
 
     if (layout == Layout::HEXAGONAL) {
@@ -356,6 +688,7 @@ InputData::InputData(int argc, char **argv)
     if (som_width < 2) fatalError("som-width must be > 1.");
     if (som_height < 1) fatalError("som-height must be > 0.");
     if (som_depth < 1) fatalError("som-depth must be > 0.");
+    if (resultTopK > som_size) fatalError("result-top-k must not be larger than the SOM size.");
     if (som_height > 1) ++dimensionality;
     if (som_depth > 1) ++dimensionality;
 
@@ -373,6 +706,15 @@ InputData::InputData(int argc, char **argv)
     if (numberOfThreads == -1) numberOfThreads = omp_get_num_procs();
 #if PINK_USE_CUDA
     if (useCuda) numberOfThreads = 1;
+    if (useCuda and annTopK) fatalError("ann-top-k is only supported with --cuda-off.");
+    if (useCuda and resultTopK) fatalError("result-top-k is only supported with --cuda-off.");
+    if (useCuda and orientationWindow > 0.0) fatalError("orientation-prior is only supported with --cuda-off.");
+    if (useCuda and rotationLayout != RotationLayout::BLOCKED) fatalError("rotation-layout is only supported with --cuda-off.");
+    if (useCuda and storage != StorageType::FLOAT32) fatalError("storage is only supported with --cuda-off.");
+    if (useCuda and prefilter != Prefilter::OFF) fatalError("prefilter is only supported with --cuda-off.");
+    if (useCuda and interpolation == Interpolation::SHEAR) fatalError("shear interpolation is only supported with --cuda-off.");
+    if (useCuda and !prototypeCutoutsFilename.empty()) fatalError("prototype-cutouts is only supported with --cuda-off.");
+    if (useCuda and !additionalSOMFilenames.empty()) fatalError("Mapping of several SOMs is only supported with --cuda-off.");
 #endif
     omp_set_num_threads(numberOfThreads);
 
@@ -415,9 +757,15 @@ void InputData::print_parameters() const
     if (executionPath == ExecutionPath::MAP)
         std::cout << "  SOM file = " << somFilename << "\n";
 
-    std::cout << "  Number of images = " << numberOfImages << "\n"
+    for (size_t i = 0; i != additionalSOMFilenames.size(); ++i)
+        std::cout << "  Additional result file = " << additionalResultFilenames[i] << "\n"
+                  << "  Additional SOM file = " << additionalSOMFilenames[i] << "\n";
+
+    std::cout << "  First image = " << firstImage << "\n"
+              << "  Number of images = " << numberOfImages << "\n"
               << "  Number of channels = " << numberOfChannels << "\n"
               << "  Image dimension = " << image_dim << "x" << image_dim << "\n"
+              << "  Image pixel type = " << imagePixelType << "\n"
               << "  SOM dimension (width x height x depth) = " << som_width << "x" << som_height << "x" << som_depth << "\n"
               << "  SOM size = " << som_size << "\n"
               << "  Number of iterations = " << numIter << "\n"
@@ -427,6 +775,14 @@ void InputData::print_parameters() const
               << "  Layout = " << layout << "\n"
               << "  Initialization type = " << init << "\n"
               << "  Interpolation type = " << interpolation << "\n"
+              << "  Layout of rotated images = " << rotationLayout << "\n"
+              << "  Distance tile = " << distanceTile << "\n"
+              << "  Storage type = " << storage << "\n"
+              << "  Write compact SOM = " << writeCompactSOM << "\n"
+              << "  Prefilter = " << prefilter << "\n"
+              << "  Number of rerank candidates = " << rerankCandidates << "\n"
+              << "  Number of PCA components = " << pcaComponents << "\n"
+              << "  PCA refresh = " << pcaRefresh << "\n"
               << "  Seed = " << seed << "\n"
               << "  Number of rotations = " << numberOfRotations << "\n"
               << "  Use mirrored image = " << useFlip << "\n"
@@ -438,9 +794,37 @@ void InputData::print_parameters() const
               << "  Damping factor = " << damping << "\n"
               << "  Maximum distance for SOM update = " << maxUpdateDistance << "\n"
               << "  Use periodic boundary conditions = " << usePBC << "\n"
+              << "  Number of best matches in result = " << (resultTopK ? std::to_string(resultTopK) : "all") << "\n"
+              << "  Result encoding = " << resultEncoding << "\n"
+              << "  Result compression = " << resultCompression << "\n"
+              << "  Write buffer size = " << writeBufferSize << " MiB\n"
+              << "  Use direct I/O = " << directIO << "\n"
               << "  Store best rotation and flipping parameters = " << write_rot_flip << "\n"
-              << "  Best rotation and flipping parameter filename = " << rot_flip_filename << "\n"
-              << std::endl;
+              << "  Best rotation and flipping parameter filename = " << rot_flip_filename << "\n";
+
+    if (annTopK)
+        std::cout << "  Number of ANN best matching neuron candidates = " << annTopK << "\n"
+                  << "  ANN graph degree = " << annM << "\n"
+                  << "  ANN construction list size = " << annEfConstruction << "\n"
+                  << "  ANN search list size = " << annEfSearch << "\n"
+                  << "  ANN recall sample interval = " << annRecallSample << "\n";
+
+    if (!neuronStatisticsFilename.empty())
+        std::cout << "  Neuron statistics file = " << neuronStatisticsFilename << "\n"
+                  << "  Number of examples per neuron = " << neuronStatisticsExamples << "\n";
+
+    if (!prototypesFilename.empty())
+        std::cout << "  Prototypes file = " << prototypesFilename << "\n"
+                  << "  Number of prototypes per neuron = " << numberOfPrototypes << "\n";
+
+    if (!prototypeCutoutsFilename.empty())
+        std::cout << "  Prototype cutouts file = " << prototypeCutoutsFilename << "\n";
+
+    if (orientationWindow > 0.0)
+        std::cout << "  Rotation window around principal axis = " << orientationWindow * 180.0 / M_PI << " degrees\n"
+                  << "  Minimal anisotropy for principal axis = " << minAnisotropy << "\n";
+
+    std::cout << std::endl;
 
     if (verbose)
         std::cout << "  Block size 1 = " << block_size_1 << "\n"
@@ -454,27 +838,74 @@ void InputData::print_usage() const
                  "  Usage:\n"
                  "\n"
                  "    Pink [Options] --train <image-file> <result-file>\n"
-                 "    Pink [Options] --map   <image-file> <result-file> <SOM-file>\n"
+                 "    Pink [Options] --map   <image-file> <result-file> <SOM-file> [<result-file> <SOM-file> ...]\n"
+                 "\n"
+                 "    The <image-file> can be a binary image file, an image container, a NumPy .npy or .npz file,\n"
+                 "    a FITS file or a directory of FITS files.\n"
+                 "    Several SOMs are mapped in one pass, the rotated images are generated only once. The options apply\n"
+                 "    to all SOMs, the dimensions of the additional SOMs are read from their files.\n"
                  "\n"
                  "  Options:\n"
                  "\n"
+                 "    --ann-top-k <int>               Use approximate nearest neighbor index for mapping and compute\n"
+                 "                                    exact distances only for the best <int> neurons (default = off).\n"
+                 "    --ann-m <int>                   Graph degree of the ANN index (default = 16).\n"
+                 "    --ann-ef-construction <int>     Candidate list size for building the ANN index (default = 200).\n"
+                 "    --ann-ef-search <int>           Candidate list size for ANN queries (default = 64).\n"
+                 "    --ann-recall-sample <int>       Compare ANN with exhaustive search for every <int>-th image (default = 100, off = 0).\n"
+                 "    --compact-som                   Write SOM with the reduced precision of --storage (default = float32).\n"
                  "    --cuda-off                      Switch off CUDA acceleration.\n"
+                 "    --direct-io                     Write result files with O_DIRECT bypassing the page cache.\n"
                  "    --dist-func, -f <string>        Distribution function for SOM update (see below).\n"
+                 "    --distance-tile <int>x<int>     Number of neurons and rotations compared at once by the distance kernel\n"
+                 "                                    (1x1, 2x2, 2x4, 4x2, 4x4, 4x8, 8x4, default = 2x4).\n"
+                 "    --first-image <int>             Index of the first image of the image file used (default = 0).\n"
                  "    --flip-off                      Switch off usage of mirrored images.\n"
                  "    --help, -h                      Print this lines.\n"
                  "    --init, -x <string>             Type of SOM initialization (zero = default, random, random_with_preferred_direction, file_init).\n"
-                 "    --interpolation <string>        Type of image interpolation for rotations (nearest_neighbor, bilinear = default).\n"
+                 "    --interpolation <string>        Type of image interpolation for rotations (nearest_neighbor, bilinear = default, shear).\n"
                  "    --inter-store <string>          Store intermediate SOM results at every progress step (off = default, overwrite, keep).\n"
                  "    --layout, -l <string>           Layout of SOM (quadratic = default, hexagonal).\n"
                  "    --neuron-dimension, -d <int>    Dimension for quadratic SOM neurons (default = image-dimension * sqrt(2)/2).\n"
+                 "    --neuron-stats <string>         Write number of images, sum and sum of squares of the distances and\n"
+                 "                                    the closest images of each best matching neuron of mapping.\n"
+                 "    --neuron-stats-examples <int>   Number of closest images per neuron for neuron-stats (default = 10).\n"
                  "    --numrot, -n <int>              Number of rotations (1 or a multiple of 4, default = 360).\n"
                  "    --numthreads, -t <int>          Number of CPU threads (default = auto).\n"
+                 "    --num-images <int>              Number of images used from first-image on (default = all).\n"
                  "    --num-iter <int>                Number of iterations (default = 1).\n"
+                 "    --num-prototypes <int>          Number of closest images per neuron for prototypes (default = 10).\n"
+                 "    --min-anisotropy <float>        Minimal anisotropy of image and neuron for orientation-prior (default = 0.1).\n"
                  "    --multi-GPU-off                 Switch off usage of multiple GPUs.\n"
+                 "    --orientation-prior <float>     Compare only rotations within +-<float> degrees around the alignment\n"
+                 "                                    of the principal axes of image and neuron (default = off).\n"
                  "    --pbc                           Use periodic boundary conditions for SOM.\n"
+                 "    --pca-components <int>          Number of principal components for prefilter pca (default = 32).\n"
+                 "                                    The basis is calculated from the neurons and the rotations of the\n"
+                 "                                    first image only.\n"
+                 "    --pca-refresh <int>             Recalculate principal components after <int> training updates from the\n"
+                 "                                    neurons and the rotations of the current image (default = off).\n"
+                 "    --prefilter <string>            Approximate scoring of all rotations, the best rerank-candidates rotations\n"
+                 "                                    of every neuron are compared exactly, so all neurons get an exact distance\n"
+                 "                                    (off = default, int8 (only mapping), pca).\n"
                  "    --progress, -p <float>          Print level of progress (default = 0.1).\n"
                  "                                    If < 1 relative progress, else number of images.\n"
+                 "    --prototype-cutouts <string>    Write the rotated and flipped images of the prototypes as binary image file.\n"
+                 "    --prototypes <string>           Write the closest images of every neuron with distance, flip and rotation\n"
+                 "                                    angle of mapping, independent of the best matching neuron.\n"
+                 "    --rerank-candidates <int>       Number of rotations per neuron compared exactly after prefilter (default = 8).\n"
+                 "    --result-compression <string>   Block compression of the result file (none = default, zlib).\n"
+                 "    --result-encoding <string>      Number format of the distances in the result file (float32 = default,\n"
+                 "                                    float16: up to 65504, uint16: scaled to the range of each image).\n"
+                 "    --result-top-k <int>            Write only the <int> best matching neurons of each image with distance,\n"
+                 "                                    flip and rotation angle instead of all distances (default = all).\n"
+                 "    --rotation-layout <string>      Memory layout of rotated images (blocked = default, interleaved,\n"
+                 "                                    dihedral: only interpolated rotations are stored).\n"
                  "    --seed, -s <int>                Seed for random number generator (default = 1234).\n"
+                 "    --storage <string>              Floating point type of the SOM for distance calculation\n"
+                 "                                    (float32 = default, bfloat16, float16), the rotated images stay float32.\n"
+                 "                                    Mapping keeps only the reduced precision SOM, training keeps the float32\n"
+                 "                                    SOM for the updates.\n"
                  "    --store-rot-flip <string>       Store the rotation and flip information of the best match of mapping.\n"
                  "    --som-width <int>               Width dimension of SOM (default = 10).\n"
                  "    --som-height <int>              Height dimension of SOM (default = 10).\n"
@@ -482,6 +913,7 @@ void InputData::print_usage() const
                  "    --max-update-distance <float>   Maximum distance for SOM update (default = off).\n"
                  "    --version, -v                   Print version number.\n"
                  "    --verbose                       Print more output.\n"
+                 "    --write-buffer <int>            Size of the four output buffers per result file in MiB (default = 4).\n"
                  "\n"
                  "  Distribution function:\n"
                  "\n"
@@ -492,6 +924,73 @@ void InputData::print_usage() const
               << std::endl;
 }
 
+InputData InputData::getAdditionalSOMInputData(int i) const
+{
+    InputData inputData(*this);
+    inputData.resultFilename = additionalResultFilenames[i];
+    inputData.somFilename = additionalSOMFilenames[i];
+
+    // Side outputs are only written for the first SOM
+    inputData.write_rot_flip = false;
+    inputData.neuronStatisticsFilename.clear();
+    inputData.prototypesFilename.clear();
+    inputData.prototypeCutoutsFilename.clear();
+
+    std::ifstream is(inputData.somFilename, std::ios::binary);
+    if (!is) fatalError("Error opening " + inputData.somFilename);
+
+    // Skip all header lines starting with #, the storage line marks a compact SOM
+    int64_t valueSize = sizeof(float);
+    std::string line;
+    std::streamoff position = is.tellg();
+    while (std::getline(is, line)) {
+        if (line[0] != '#') break;
+        if (line == "# storage: bfloat16" or line == "# storage: float16") valueSize = 2;
+        position = is.tellg();
+    }
+    is.clear();
+    is.seekg(position);
+
+    // numberOfChannels, width, height, depth, neuron_dim, neuron_dim
+    int header[6];
+    is.read((char*)header, sizeof(header));
+    is.seekg(0, std::ios::end);
+    if (!is) fatalError("Error reading " + inputData.somFilename);
+    const int64_t dataSize = static_cast<int64_t>(is.tellg()) - position - sizeof(header);
+
+    if (header[0] != numberOfChannels or header[4] != neuron_dim or header[5] != neuron_dim)
+        fatalError(inputData.somFilename + ": number of channels and neuron dimension must be equal for all SOMs.");
+
+    inputData.som_width = header[1];
+    inputData.som_height = header[2];
+    inputData.som_depth = header[3];
+    if (inputData.som_width < 2 or inputData.som_height < 1 or inputData.som_depth < 1)
+        fatalError(inputData.somFilename + ": wrong SOM dimension.");
+
+    // The layout is not stored, it follows from the number of neurons
+    const int64_t neuronSize = valueSize * numberOfChannels * neuron_size;
+    const int radius = (inputData.som_width - 1) / 2;
+    const int hexagonalSize = inputData.som_width * inputData.som_height - radius * (radius + 1);
+    if (dataSize == neuronSize * inputData.som_width * inputData.som_height * inputData.som_depth) {
+        inputData.layout = Layout::CARTESIAN;
+        inputData.som_size = inputData.som_width * inputData.som_height * inputData.som_depth;
+    } else if (inputData.som_width == inputData.som_height and inputData.som_width % 2 and inputData.som_depth == 1
+        and dataSize == neuronSize * hexagonalSize) {
+        inputData.layout = Layout::HEXAGONAL;
+        inputData.som_size = hexagonalSize;
+    } else {
+        fatalError(inputData.somFilename + ": size does not fit to a cartesian or hexagonal SOM.");
+    }
+
+    inputData.dimensionality = 1;
+    if (inputData.som_height > 1) ++inputData.dimensionality;
+    if (inputData.som_depth > 1) ++inputData.dimensionality;
+    inputData.som_total_size = inputData.som_size * neuron_size;
+
+    if (resultTopK > inputData.som_size) fatalError(inputData.somFilename + ": result-top-k must not be larger than the SOM size.");
+    return inputData;
+}
+
 void stringToUpper(char* s)
 {
     for (char *ps = s; *ps != '\0'; ++ps) *ps = toupper(*ps);
@@ -7,11 +7,18 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
+#include "ImageProcessingLib/ImageCodec.h"
 #include "ImageProcessingLib/ImageProcessing.h"
 #include "ImageProcessingLib/Interpolation.h"
+#include "DistanceTile.h"
 #include "IntermediateStorageType.h"
+#include "Prefilter.h"
+#include "ResultEncoding.h"
+#include "RotationLayout.h"
 #include "SOMInitializationType.h"
+#include "StorageType.h"
 #include "UtilitiesLib/DistributionFunction.h"
 #include "UtilitiesLib/ExecutionPath.h"
 #include "UtilitiesLib/Layout.h"
@@ -39,11 +46,18 @@ struct InputData
     //! Print usage output for input arguments.
     void print_usage() const;
 
+    //! Parameters for mapping the i-th additional SOM, its dimensions and layout are read from the SOM file.
+    InputData getAdditionalSOMInputData(int i) const;
+
     std::string imagesFilename;
     std::string resultFilename;
     std::string somFilename;
     std::string rot_flip_filename;
 
+    //! Result and SOM files of further SOMs mapped in the same pass over the images.
+    std::vector<std::string> additionalResultFilenames;
+    std::vector<std::string> additionalSOMFilenames;
+
     bool verbose;
     int som_width;
     int som_height;
@@ -58,9 +72,11 @@ struct InputData
     float progressFactor;
     bool useFlip;
     bool useCuda;
+    int firstImage;
     int numberOfImages;
     int numberOfChannels;
     int image_dim;
+    PixelType imagePixelType;
     int image_size;
     int som_size;
     int neuron_size;
@@ -78,6 +94,31 @@ struct InputData
     int usePBC;
     int dimensionality;
     bool write_rot_flip;
+    int resultTopK;
+    ResultEncoding resultEncoding;
+    ImageCodec resultCompression;
+    int writeBufferSize;
+    bool directIO;
+    std::string neuronStatisticsFilename;
+    int neuronStatisticsExamples;
+    std::string prototypesFilename;
+    int numberOfPrototypes;
+    std::string prototypeCutoutsFilename;
+    int annTopK;
+    int annM;
+    int annEfConstruction;
+    int annEfSearch;
+    int annRecallSample;
+    float orientationWindow;
+    float minAnisotropy;
+    RotationLayout rotationLayout;
+    DistanceTile distanceTile;
+    StorageType storage;
+    bool writeCompactSOM;
+    Prefilter prefilter;
+    int rerankCandidates;
+    int pcaComponents;
+    int pcaRefresh;
 };
 
 void stringToUpper(char* s);
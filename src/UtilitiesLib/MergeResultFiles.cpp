@@ -0,0 +1,193 @@
+/**
+ * @file   UtilitiesLib/MergeResultFiles.cpp
+ * @brief  Concatenate result files of mapping jobs over consecutive image ranges.
+ * @date   Oct 19, 2026
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "MergeResultFiles.h"
+#include "ResultFileHeader.h"
+
+namespace pink {
+
+namespace {
+
+//! Close file descriptor at the end of the scope.
+struct FileDescriptor
+{
+    FileDescriptor(int fd) : fd(fd) {}
+    ~FileDescriptor() { if (fd >= 0) close(fd); }
+    FileDescriptor(FileDescriptor const&) = delete;
+    FileDescriptor& operator = (FileDescriptor const&) = delete;
+    int fd;
+};
+
+struct InputFile
+{
+    std::string filename;
+    ResultFileHeader header;
+    int64_t dataSize;
+    int64_t rowSize;
+    dev_t device;
+    ino_t inode;
+};
+
+InputFile inspect(std::string const& filename)
+{
+    InputFile input;
+    input.filename = filename;
+
+    std::ifstream is(filename, std::ios::binary);
+    struct stat st;
+    if (!is or stat(filename.c_str(), &st) != 0) throw std::runtime_error("mergeResultFiles: Error opening " + filename);
+    try {
+        input.header = readResultFileHeader(is);
+    } catch (std::runtime_error const& e) {
+        throw std::runtime_error("mergeResultFiles: " + filename + ": " + e.what());
+    }
+
+    const int64_t dataSize = st.st_size - static_cast<int64_t>(input.header.getHeaderSizeInBytes());
+    const int numberOfImages = input.header.numberOfImages;
+    input.dataSize = dataSize;
+
+    if (input.header.codec == ImageCodec::NONE) {
+        if (numberOfImages <= 0 or dataSize % numberOfImages)
+            throw std::runtime_error("mergeResultFiles: size of " + filename + " does not fit to "
+                + std::to_string(numberOfImages) + " images.");
+        input.rowSize = dataSize / numberOfImages;
+    } else {
+        // The row size is unknown without decompression, the blocks must cover all images and the whole file
+        int64_t images = 0, size = 0, blockHeader[2];
+        while (is.read((char*)blockHeader, resultBlockHeaderSize)) {
+            if (blockHeader[0] <= 0 or blockHeader[1] < 0) break;
+            images += blockHeader[0];
+            size += resultBlockHeaderSize + blockHeader[1];
+            is.seekg(blockHeader[1], std::ios::cur);
+        }
+        if (numberOfImages <= 0 or images != numberOfImages or size != dataSize)
+            throw std::runtime_error("mergeResultFiles: blocks of " + filename + " do not fit to "
+                + std::to_string(numberOfImages) + " images.");
+        input.rowSize = 0;
+    }
+
+    input.device = st.st_dev;
+    input.inode = st.st_ino;
+    return input;
+}
+
+//! Fallback copy through user space.
+void copyBuffered(int in, int out, int64_t offset, int64_t size)
+{
+    std::vector<char> buffer(1 << 20);
+    while (size > 0) {
+        ssize_t n = pread(in, &buffer[0], std::min<int64_t>(size, buffer.size()), offset);
+        if (n <= 0) throw std::runtime_error("mergeResultFiles: read error, " + std::string(std::strerror(errno)));
+        for (ssize_t written = 0; written < n; ) {
+            ssize_t w = write(out, &buffer[written], n - written);
+            if (w < 0) throw std::runtime_error("mergeResultFiles: write error, " + std::string(std::strerror(errno)));
+            written += w;
+        }
+        offset += n;
+        size -= n;
+    }
+}
+
+//! Copy size bytes from offset of in to the current position of out.
+void copyRange(int in, int out, int64_t offset, int64_t size)
+{
+    loff_t inOffset = offset;
+
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 27)
+    while (size > 0) {
+        ssize_t n = copy_file_range(in, &inOffset, out, nullptr, size, 0);
+        if (n > 0) {
+            size -= n;
+            continue;
+        }
+        if (n == 0) throw std::runtime_error("mergeResultFiles: unexpected end of file.");
+        // Not supported for the file systems, e.g. different ones for older kernels
+        if (errno == EXDEV or errno == ENOSYS or errno == EINVAL or errno == EOPNOTSUPP) break;
+        throw std::runtime_error("mergeResultFiles: copy error, " + std::string(std::strerror(errno)));
+    }
+#endif
+
+    while (size > 0) {
+        off_t sendOffset = inOffset;
+        ssize_t n = sendfile(out, in, &sendOffset, std::min<int64_t>(size, 1 << 30));
+        if (n > 0) {
+            inOffset = sendOffset;
+            size -= n;
+            continue;
+        }
+        if (n == 0) throw std::runtime_error("mergeResultFiles: unexpected end of file.");
+        if (errno == EINVAL or errno == ENOSYS) break;
+        throw std::runtime_error("mergeResultFiles: copy error, " + std::string(std::strerror(errno)));
+    }
+
+    if (size > 0) copyBuffered(in, out, inOffset, size);
+}
+
+} // anonymous namespace
+
+int64_t mergeResultFiles(std::string const& outputFilename, std::vector<std::string> const& inputFilenames)
+{
+    if (inputFilenames.empty()) throw std::runtime_error("mergeResultFiles: no input files.");
+
+    std::vector<InputFile> inputs;
+    int64_t numberOfImages = 0;
+    for (auto const& filename : inputFilenames) {
+        inputs.push_back(inspect(filename));
+        InputFile const& input = inputs.back();
+        InputFile const& first = inputs.front();
+        if (input.header.som_width != first.header.som_width or input.header.som_height != first.header.som_height
+            or input.header.som_depth != first.header.som_depth or input.header.type != first.header.type
+            or input.header.numberOfBestMatches != first.header.numberOfBestMatches
+            or input.header.encoding != first.header.encoding or input.header.codec != first.header.codec
+            or input.rowSize != first.rowSize)
+            throw std::runtime_error("mergeResultFiles: SOM dimension, result type, encoding or row size of " + filename
+                + " differs from " + first.filename);
+        numberOfImages += input.header.numberOfImages;
+    }
+    if (numberOfImages > INT_MAX) throw std::runtime_error("mergeResultFiles: too many images for the file header.");
+
+    // The output is truncated on opening, it must not be one of the inputs
+    struct stat st;
+    if (stat(outputFilename.c_str(), &st) == 0) {
+        for (auto const& input : inputs) {
+            if (input.device == st.st_dev and input.inode == st.st_ino)
+                throw std::runtime_error("mergeResultFiles: output file " + outputFilename + " is also an input file.");
+        }
+    }
+
+    FileDescriptor out(open(outputFilename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644));
+    if (out.fd < 0) throw std::runtime_error("mergeResultFiles: Error opening " + outputFilename);
+
+    ResultFileHeader header = inputs[0].header;
+    header.numberOfImages = numberOfImages;
+    std::ostringstream os;
+    writeResultFileHeader(os, header);
+    const std::string headerBytes = os.str();
+    if (write(out.fd, headerBytes.data(), headerBytes.size()) != static_cast<ssize_t>(headerBytes.size()))
+        throw std::runtime_error("mergeResultFiles: write error, " + std::string(std::strerror(errno)));
+
+    for (auto const& input : inputs) {
+        FileDescriptor in(open(input.filename.c_str(), O_RDONLY));
+        if (in.fd < 0) throw std::runtime_error("mergeResultFiles: Error opening " + input.filename);
+        copyRange(in.fd, out.fd, input.header.getHeaderSizeInBytes(), input.dataSize);
+    }
+
+    return numberOfImages;
+}
+
+} // namespace pink
@@ -0,0 +1,27 @@
+/**
+ * @file   UtilitiesLib/MergeResultFiles.h
+ * @brief  Concatenate result files of mapping jobs over consecutive image ranges.
+ * @date   Oct 19, 2026
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace pink {
+
+/**
+ * @brief Merge mapping result files or rot/flip files of consecutive image ranges.
+ *
+ * All files start with a result file header (@ResultFileHeader) followed by one row of equal size
+ * per image, the rot/flip files have the plain header. The headers and row sizes of all input files
+ * must agree, the number of images of the output file is the sum.
+ * Compressed files are concatenated block by block, the row size is not checked.
+ * The rows are copied within the kernel (copy_file_range or sendfile) if possible.
+ * Returns the number of images of the output file.
+ */
+int64_t mergeResultFiles(std::string const& outputFilename, std::vector<std::string> const& inputFilenames);
+
+} // namespace pink
@@ -0,0 +1,29 @@
+/**
+ * @file   UtilitiesLib/Prefilter.h
+ * @date   Oct 18, 2026
+ */
+
+#pragma once
+
+#include <iostream>
+
+namespace pink {
+
+//! Approximate scoring of all neuron-rotation pairs before the exact comparison of the best candidates
+enum class Prefilter {
+    OFF,
+    INT8,
+    PCA
+};
+
+//! Pretty printing of Prefilter.
+inline std::ostream& operator << (std::ostream& os, Prefilter prefilter)
+{
+    if (prefilter == Prefilter::OFF) os << "off";
+    else if (prefilter == Prefilter::INT8) os << "int8";
+    else if (prefilter == Prefilter::PCA) os << "pca";
+    else os << "undefined";
+    return os;
+}
+
+} // namespace pink
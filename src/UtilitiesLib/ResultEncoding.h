@@ -0,0 +1,29 @@
+/**
+ * @file   UtilitiesLib/ResultEncoding.h
+ * @date   Oct 19, 2026
+ */
+
+#pragma once
+
+#include <iostream>
+
+namespace pink {
+
+//! Number format of the distances in the mapping result file, the values are written into the header
+enum class ResultEncoding {
+    FLOAT32 = 0,
+    FLOAT16 = 1,
+    UINT16 = 2
+};
+
+//! Pretty printing of ResultEncoding.
+inline std::ostream& operator << (std::ostream& os, ResultEncoding encoding)
+{
+    if (encoding == ResultEncoding::FLOAT32) os << "float32";
+    else if (encoding == ResultEncoding::FLOAT16) os << "float16";
+    else if (encoding == ResultEncoding::UINT16) os << "uint16";
+    else os << "undefined";
+    return os;
+}
+
+} // namespace pink
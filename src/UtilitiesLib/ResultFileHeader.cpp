@@ -0,0 +1,164 @@
+/**
+ * @file   UtilitiesLib/ResultFileHeader.cpp
+ * @brief  Header of the mapping result file format.
+ * @date   Oct 19, 2026
+ */
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "HalfPrecision.h"
+#include "ResultFileHeader.h"
+
+namespace pink {
+
+namespace {
+
+//! First integer of the versioned header, the plain header starts with the number of images.
+const int versionMarker = -1;
+const int fileVersion = 2;
+
+//! Offset and scale of ResultEncoding::UINT16.
+const size_t quantizationHeaderSize = 2 * sizeof(float);
+
+} // anonymous namespace
+
+bool ResultFileHeader::isPlain() const
+{
+    return type == ResultType::DISTANCES and encoding == ResultEncoding::FLOAT32 and codec == ImageCodec::NONE;
+}
+
+size_t ResultFileHeader::getHeaderSizeInBytes() const
+{
+    return (isPlain() ? 4 : 10) * sizeof(int);
+}
+
+size_t ResultFileHeader::getRowSizeInBytes(int som_size) const
+{
+    if (type == ResultType::TOP_K) return numberOfBestMatches * bestMatchEntrySize;
+    if (encoding == ResultEncoding::FLOAT16) return som_size * sizeof(float16);
+    if (encoding == ResultEncoding::UINT16) return quantizationHeaderSize + som_size * sizeof(uint16_t);
+    return som_size * sizeof(float);
+}
+
+int ResultFileHeader::getNumberOfNeurons(size_t rowSizeInBytes) const
+{
+    if (encoding == ResultEncoding::FLOAT16) return rowSizeInBytes / sizeof(float16);
+    if (encoding == ResultEncoding::UINT16) return (rowSizeInBytes - quantizationHeaderSize) / sizeof(uint16_t);
+    return rowSizeInBytes / sizeof(float);
+}
+
+ResultFileHeader readResultFileHeader(std::istream& is)
+{
+    ResultFileHeader header;
+    is.read((char*)&header.numberOfImages, sizeof(int));
+
+    if (header.numberOfImages == versionMarker) {
+        int version, type, encoding, codec;
+        is.read((char*)&version, sizeof(int));
+        if (version != fileVersion) throw std::runtime_error("Unsupported result file version " + std::to_string(version));
+        is.read((char*)&type, sizeof(int));
+        if (type < static_cast<int>(ResultType::DISTANCES) or type > static_cast<int>(ResultType::TOP_K))
+            throw std::runtime_error("Unknown result type " + std::to_string(type));
+        header.type = static_cast<ResultType>(type);
+        is.read((char*)&header.numberOfBestMatches, sizeof(int));
+        is.read((char*)&encoding, sizeof(int));
+        if (encoding < static_cast<int>(ResultEncoding::FLOAT32) or encoding > static_cast<int>(ResultEncoding::UINT16))
+            throw std::runtime_error("Unknown result encoding " + std::to_string(encoding));
+        header.encoding = static_cast<ResultEncoding>(encoding);
+        is.read((char*)&codec, sizeof(int));
+        if (codec < static_cast<int>(ImageCodec::NONE) or codec > static_cast<int>(ImageCodec::ZLIB))
+            throw std::runtime_error("Unknown result codec " + std::to_string(codec));
+        header.codec = static_cast<ImageCodec>(codec);
+        is.read((char*)&header.numberOfImages, sizeof(int));
+    }
+
+    is.read((char*)&header.som_width, sizeof(int));
+    is.read((char*)&header.som_height, sizeof(int));
+    is.read((char*)&header.som_depth, sizeof(int));
+
+    if (!is) throw std::runtime_error("Error reading result file header");
+    return header;
+}
+
+void writeResultFileHeader(std::ostream& os, ResultFileHeader const& header)
+{
+    if (!header.isPlain()) {
+        int type = static_cast<int>(header.type);
+        int encoding = static_cast<int>(header.encoding);
+        int codec = static_cast<int>(header.codec);
+        os.write((char*)&versionMarker, sizeof(int));
+        os.write((char*)&fileVersion, sizeof(int));
+        os.write((char*)&type, sizeof(int));
+        os.write((char*)&header.numberOfBestMatches, sizeof(int));
+        os.write((char*)&encoding, sizeof(int));
+        os.write((char*)&codec, sizeof(int));
+    }
+    os.write((char*)&header.numberOfImages, sizeof(int));
+    os.write((char*)&header.som_width, sizeof(int));
+    os.write((char*)&header.som_height, sizeof(int));
+    os.write((char*)&header.som_depth, sizeof(int));
+}
+
+void encodeDistances(char *row, float const *distances, int som_size, ResultEncoding encoding)
+{
+    if (encoding == ResultEncoding::FLOAT32) {
+        std::memcpy(row, distances, som_size * sizeof(float));
+    } else if (encoding == ResultEncoding::FLOAT16) {
+        std::vector<float16> values(som_size);
+        convertFromFloat(&values[0], distances, som_size);
+        std::memcpy(row, &values[0], som_size * sizeof(float16));
+    } else if (encoding == ResultEncoding::UINT16) {
+        // Range of the computed distances, FLT_MAX marks neurons skipped by the approximate search
+        float min = FLT_MAX;
+        float max = -FLT_MAX;
+        for (int i = 0; i < som_size; ++i) {
+            if (distances[i] >= FLT_MAX) continue;
+            min = std::min(min, distances[i]);
+            max = std::max(max, distances[i]);
+        }
+        float offset = min < FLT_MAX ? min : 0.0f;
+        float scale = max > min ? (max - min) / (missingDistanceLevel - 1) : 0.0f;
+        float inverseScale = scale > 0.0f ? 1.0f / scale : 0.0f;
+
+        std::vector<uint16_t> levels(som_size);
+        for (int i = 0; i < som_size; ++i) {
+            if (distances[i] >= FLT_MAX) levels[i] = missingDistanceLevel;
+            else levels[i] = std::min<long>(std::lround((distances[i] - offset) * inverseScale), missingDistanceLevel - 1);
+        }
+        std::memcpy(row, &offset, sizeof(float));
+        std::memcpy(row + sizeof(float), &scale, sizeof(float));
+        std::memcpy(row + quantizationHeaderSize, &levels[0], som_size * sizeof(uint16_t));
+    } else {
+        throw std::runtime_error("encodeDistances: unknown encoding.");
+    }
+}
+
+void decodeDistances(float *distances, char const *row, int som_size, ResultEncoding encoding)
+{
+    if (encoding == ResultEncoding::FLOAT32) {
+        std::memcpy(distances, row, som_size * sizeof(float));
+    } else if (encoding == ResultEncoding::FLOAT16) {
+        std::vector<float16> values(som_size);
+        std::memcpy(&values[0], row, som_size * sizeof(float16));
+        convertToFloat(distances, &values[0], som_size);
+    } else if (encoding == ResultEncoding::UINT16) {
+        float offset, scale;
+        std::memcpy(&offset, row, sizeof(float));
+        std::memcpy(&scale, row + sizeof(float), sizeof(float));
+        std::vector<uint16_t> levels(som_size);
+        std::memcpy(&levels[0], row + quantizationHeaderSize, som_size * sizeof(uint16_t));
+        for (int i = 0; i < som_size; ++i) {
+            distances[i] = levels[i] == missingDistanceLevel ? FLT_MAX : offset + levels[i] * scale;
+        }
+    } else {
+        throw std::runtime_error("decodeDistances: unknown encoding.");
+    }
+}
+
+} // namespace pink
@@ -0,0 +1,95 @@
+/**
+ * @file   UtilitiesLib/ResultFileHeader.h
+ * @brief  Header of the mapping result file format.
+ * @date   Oct 19, 2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+
+#include "ImageProcessingLib/ImageCodec.h"
+#include "ResultEncoding.h"
+#include "ResultType.h"
+
+namespace pink {
+
+/**
+ * @brief Type and dimensions of a mapping result file.
+ *
+ * Files with the distances of all neurons start with the four integers
+ * numberOfImages, som_width, som_height, som_depth followed by som_size floats per image,
+ * which is also the format of earlier versions.
+ * The versioned header starts with the integer -1 and the version, followed by
+ * the result type, the number of best matches, the encoding, the codec and the four integers above.
+ * It is written for all other results.
+ *
+ * For ResultType::TOP_K every image is a record of numberOfBestMatches entries sorted by distance,
+ * each entry is the neuron (int), the squared euclidean distance (float), the flip (char)
+ * and the rotation angle in radians (float), 13 bytes without padding.
+ *
+ * The distances of ResultType::DISTANCES are encoded per image (@encodeDistances):
+ *   - ResultEncoding::FLOAT32: som_size floats.
+ *   - ResultEncoding::FLOAT16: som_size IEEE half precision values, distances above 65504 become infinity.
+ *   - ResultEncoding::UINT16: the floats offset and scale followed by som_size uint16 values q,
+ *     the distance is offset + q * scale. The value 65535 marks neurons without distance (FLT_MAX).
+ *
+ * With ImageCodec::ZLIB the rows are compressed in blocks of consecutive images.
+ * Every block starts with the number of images (int64) and the compressed size in bytes (int64).
+ * Blocks are independent, files of consecutive image ranges can be concatenated.
+ */
+struct ResultFileHeader
+{
+    ResultFileHeader(int numberOfImages = 0, int som_width = 0, int som_height = 0, int som_depth = 0,
+        ResultType type = ResultType::DISTANCES, int numberOfBestMatches = 0,
+        ResultEncoding encoding = ResultEncoding::FLOAT32, ImageCodec codec = ImageCodec::NONE)
+     : numberOfImages(numberOfImages), som_width(som_width), som_height(som_height), som_depth(som_depth),
+       type(type), numberOfBestMatches(numberOfBestMatches), encoding(encoding), codec(codec)
+    {}
+
+    //! True if the plain header of four integers is used.
+    bool isPlain() const;
+
+    //! Number of bytes of the header.
+    size_t getHeaderSizeInBytes() const;
+
+    //! Number of bytes of the uncompressed result of one image, the number of neurons differs from the SOM dimensions for hexagonal layout.
+    size_t getRowSizeInBytes(int som_size) const;
+
+    //! Number of neurons for the uncompressed row size, the inverse of @getRowSizeInBytes for distances.
+    int getNumberOfNeurons(size_t rowSizeInBytes) const;
+
+    int numberOfImages;
+    int som_width;
+    int som_height;
+    int som_depth;
+    ResultType type;
+    int numberOfBestMatches;
+    ResultEncoding encoding;
+    ImageCodec codec;
+};
+
+//! Size of one entry of ResultType::TOP_K.
+const size_t bestMatchEntrySize = 2 * sizeof(int) + sizeof(char) + sizeof(float);
+
+//! Size of the header of a compressed block.
+const size_t resultBlockHeaderSize = 2 * sizeof(int64_t);
+
+//! Quantization level of ResultEncoding::UINT16 for neurons without distance.
+const uint16_t missingDistanceLevel = 65535;
+
+//! Read the plain or versioned header.
+ResultFileHeader readResultFileHeader(std::istream& is);
+
+//! Write the plain header for uncompressed float32 distances, otherwise the versioned header.
+void writeResultFileHeader(std::ostream& os, ResultFileHeader const& header);
+
+//! Encode the distances of one image into getRowSizeInBytes(som_size) bytes.
+void encodeDistances(char *row, float const *distances, int som_size, ResultEncoding encoding);
+
+//! Decode the distances of one image, inverse of @encodeDistances.
+void decodeDistances(float *distances, char const *row, int som_size, ResultEncoding encoding);
+
+} // namespace pink
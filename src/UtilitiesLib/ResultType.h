@@ -0,0 +1,27 @@
+/**
+ * @file   UtilitiesLib/ResultType.h
+ * @date   Oct 19, 2026
+ */
+
+#pragma once
+
+#include <iostream>
+
+namespace pink {
+
+//! Content of the mapping result file
+enum class ResultType {
+    DISTANCES = 0,
+    TOP_K = 1
+};
+
+//! Pretty printing of ResultType.
+inline std::ostream& operator << (std::ostream& os, ResultType type)
+{
+    if (type == ResultType::DISTANCES) os << "distances";
+    else if (type == ResultType::TOP_K) os << "top_k";
+    else os << "undefined";
+    return os;
+}
+
+} // namespace pink
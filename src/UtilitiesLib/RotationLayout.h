@@ -0,0 +1,29 @@
+/**
+ * @file   UtilitiesLib/RotationLayout.h
+ * @date   Oct 18, 2026
+ */
+
+#pragma once
+
+#include <iostream>
+
+namespace pink {
+
+//! Memory layout of the rotated images
+enum class RotationLayout {
+    BLOCKED,     //!< Each rotated image is a contiguous block.
+    INTERLEAVED, //!< Pixel-major, the rotations of a pixel are contiguous.
+    DIHEDRAL     //!< Only the interpolated rotations are stored, 90 degree rotations and flips are index maps.
+};
+
+//! Pretty printing of RotationLayout.
+inline std::ostream& operator << (std::ostream& os, RotationLayout layout)
+{
+    if (layout == RotationLayout::BLOCKED) os << "blocked";
+    else if (layout == RotationLayout::INTERLEAVED) os << "interleaved";
+    else if (layout == RotationLayout::DIHEDRAL) os << "dihedral";
+    else os << "undefined";
+    return os;
+}
+
+} // namespace pink
@@ -0,0 +1,29 @@
+/**
+ * @file   UtilitiesLib/StorageType.h
+ * @date   Oct 18, 2026
+ */
+
+#pragma once
+
+#include <iostream>
+
+namespace pink {
+
+//! Floating point type of the SOM and rotated images used for distance calculation
+enum class StorageType {
+    FLOAT32,
+    BFLOAT16,
+    FLOAT16
+};
+
+//! Pretty printing of StorageType.
+inline std::ostream& operator << (std::ostream& os, StorageType type)
+{
+    if (type == StorageType::FLOAT32) os << "float32";
+    else if (type == StorageType::BFLOAT16) os << "bfloat16";
+    else if (type == StorageType::FLOAT16) os << "float16";
+    else os << "undefined";
+    return os;
+}
+
+} // namespace pink
@@ -0,0 +1,189 @@
+/**
+ * @file   ImageProcessingTest/FitsImageReaderTest.cpp
+ * @brief  Unit tests for reading FITS files.
+ * @date   Oct 19, 2026
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include "gtest/gtest.h"
+#include <stdexcept>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#include "ImageProcessingLib/FitsImageReader.h"
+#include "ImageProcessingLib/ImageIterator.h"
+#include "TempFilename.h"
+
+using namespace pink;
+
+namespace {
+
+std::string card(std::string const& keyword, std::string const& value)
+{
+    std::string c = keyword;
+    c.resize(8, ' ');
+    if (!value.empty()) c += "= " + std::string(20 - std::min<size_t>(20, value.size()), ' ') + value;
+    c.resize(80, ' ');
+    return c;
+}
+
+//! FITS file with primary HDU, the values are converted to big endian pixels of bitpix.
+void writeFits(std::string const& filename, int bitpix, std::vector<int> const& dims, std::vector<double> const& values,
+    std::string const& extraCards = "")
+{
+    std::string header = card("SIMPLE", "T") + card("BITPIX", std::to_string(bitpix))
+        + card("NAXIS", std::to_string(dims.size()));
+    for (size_t i = 0; i < dims.size(); ++i) header += card("NAXIS" + std::to_string(i + 1), std::to_string(dims[i]));
+    header += extraCards + card("END", "");
+    header.resize((header.size() + 2879) / 2880 * 2880, ' ');
+
+    std::string data;
+    for (double v : values) {
+        unsigned char bytes[8];
+        int size = std::abs(bitpix) / 8;
+        if (bitpix == 8) bytes[0] = static_cast<uint8_t>(v);
+        else if (bitpix == 16) { int16_t i = v; std::memcpy(bytes, &i, 2); }
+        else if (bitpix == -32) { float f = v; std::memcpy(bytes, &f, 4); }
+        else std::memcpy(bytes, &v, 8);
+        if (bitpix != 8) std::reverse(bytes, bytes + size);
+        data.append((char*)bytes, size);
+    }
+    data.resize((data.size() + 2879) / 2880 * 2880, '\0');
+
+    std::ofstream os(filename, std::ios::binary);
+    os << header << data;
+}
+
+std::vector<double> ramp(int size, double start, double step)
+{
+    std::vector<double> values(size);
+    for (int i = 0; i < size; ++i) values[i] = start + i * step;
+    return values;
+}
+
+} // anonymous namespace
+
+TEST(FitsImageReaderTest, BitpixAndScaling)
+{
+    const std::string filename = tempFilename("image.fits");
+
+    // Three images 5x4 of a cube, enough pixels for the SIMD byte swap
+    for (int bitpix : {8, 16, -32, -64}) {
+        std::vector<double> values = ramp(60, bitpix == 8 ? 0 : -30, 1.0);
+        writeFits(filename, bitpix, {5, 4, 3}, values, card("BSCALE", "2.0") + card("BZERO", "1.0"));
+
+        EXPECT_TRUE(isFitsFile(filename));
+
+        ImageIterator<float> iterImage(filename);
+        EXPECT_EQ(3, iterImage.getNumberOfImages());
+        EXPECT_EQ(1, iterImage.getNumberOfChannels());
+        EXPECT_EQ(4, iterImage->getHeight());
+        EXPECT_EQ(5, iterImage->getWidth());
+
+        for (int i = 0; i < 3; ++i, ++iterImage) {
+            for (int p = 0; p < 20; ++p) {
+                EXPECT_EQ(2.0 * values[i * 20 + p] + 1.0, iterImage->getPixel()[p]) << bitpix;
+            }
+        }
+        EXPECT_TRUE(iterImage == ImageIterator<float>());
+
+        ImageIterator<float> iterLast(filename, 2);
+        EXPECT_EQ(2.0 * values[40] + 1.0, iterLast->getPixel()[0]) << bitpix;
+        iterLast.seek(0);
+        EXPECT_EQ(2.0 * values[40] + 1.0, iterLast->getPixel()[0]) << bitpix;
+    }
+
+    // Unsigned 16 bit convention
+    writeFits(filename, 16, {2, 2}, {-32768, -1, 0, 32767}, card("BZERO", "32768"));
+    ImageIterator<float> iterImage(filename);
+    EXPECT_EQ(PixelType::UINT16, iterImage.getPixelType());
+    EXPECT_EQ((std::vector<float>{0, 32767, 32768, 65535}), iterImage->getPixel());
+
+    std::remove(filename.c_str());
+}
+
+TEST(FitsImageReaderTest, Directory)
+{
+    const std::string dirname = tempFilename("fits_images");
+    mkdir(dirname.c_str(), 0755);
+
+    // Three images with two channels, written in reversed order to check the sorting
+    for (int i = 2; i >= 0; --i) {
+        writeFits(dirname + "/image_" + std::to_string(i) + ".fits", -32, {3, 3, 2}, ramp(18, 100 * i, 1.0));
+    }
+    std::ofstream(dirname + "/README.txt") << "no FITS file";
+
+    ImageIterator<float> iterImage(dirname);
+    EXPECT_EQ(3, iterImage.getNumberOfImages());
+    EXPECT_EQ(2, iterImage.getNumberOfChannels());
+    EXPECT_EQ(0.0, iterImage->getPixel()[0]);
+    EXPECT_EQ(17.0, iterImage->getPixel()[17]);
+
+    iterImage += 2;
+    EXPECT_EQ(200.0, iterImage->getPixel()[0]);
+    iterImage.seek(0);
+    EXPECT_EQ(17.0, iterImage->getPixel()[17]);
+
+    // Seek to the image just read
+    iterImage.seek(0);
+    EXPECT_EQ(17.0, iterImage->getPixel()[17]);
+    ++iterImage;
+    iterImage.seek(1);
+    EXPECT_EQ(100.0, iterImage->getPixel()[0]);
+    iterImage.seek(2);
+    ++iterImage;
+    EXPECT_TRUE(iterImage == ImageIterator<float>());
+
+    // Different dimensions
+    writeFits(dirname + "/image_3.fits", -32, {3, 3, 1}, ramp(9, 0, 1.0));
+    int count = 0;
+    EXPECT_THROW(for (ImageIterator<float> iter(dirname), end; iter != end; ++iter) ++count, std::runtime_error);
+    EXPECT_EQ(3, count);
+
+    for (int i = 0; i != 4; ++i) std::remove((dirname + "/image_" + std::to_string(i) + ".fits").c_str());
+    std::remove((dirname + "/README.txt").c_str());
+    rmdir(dirname.c_str());
+}
+
+TEST(FitsImageReaderTest, DirectoryWithScaling)
+{
+    const std::string dirname = tempFilename("fits_scaled_images");
+    mkdir(dirname.c_str(), 0755);
+
+    // The scaling of the first file is used for all images
+    writeFits(dirname + "/image_0.fits", 16, {2, 2}, {0, 1, 2, 3}, card("BSCALE", "0.5") + card("BZERO", "10.0"));
+    writeFits(dirname + "/image_1.fits", 16, {2, 2}, {4, 5, 6, 7}, card("BSCALE", "0.5") + card("BZERO", "10.0"));
+    std::vector<float> pixels;
+    for (ImageIterator<float> iter(dirname), end; iter != end; ++iter)
+        pixels.insert(pixels.end(), iter->getPixel().begin(), iter->getPixel().end());
+    EXPECT_EQ((std::vector<float>{10, 10.5, 11, 11.5, 12, 12.5, 13, 13.5}), pixels);
+
+    // Different BSCALE
+    writeFits(dirname + "/image_1.fits", 16, {2, 2}, {4, 5, 6, 7}, card("BSCALE", "2.0") + card("BZERO", "10.0"));
+    int count = 0;
+    EXPECT_THROW(for (ImageIterator<float> iter(dirname), end; iter != end; ++iter) ++count, std::runtime_error);
+    EXPECT_EQ(1, count);
+
+    for (int i = 0; i != 2; ++i) std::remove((dirname + "/image_" + std::to_string(i) + ".fits").c_str());
+    rmdir(dirname.c_str());
+}
+
+TEST(FitsImageReaderTest, Unsupported)
+{
+    const std::string filename = tempFilename("unsupported.fits");
+
+    writeFits(filename, 32, {2, 2}, {});
+    EXPECT_THROW(FitsImageReader reader(filename), std::runtime_error);
+
+    writeFits(filename, -32, {4}, {});
+    EXPECT_THROW(FitsImageReader reader(filename), std::runtime_error);
+
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,108 @@
+/**
+ * @file   ImageProcessingTest/FixedPointRotationTest.cpp
+ * @brief  Unit tests for bilinear rotation of integer images.
+ * @date   Oct 19, 2026
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "gtest/gtest.h"
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "ImageProcessingLib/FixedPointRotation.h"
+#include "ImageProcessingLib/ImageProcessing.h"
+
+using namespace pink;
+
+namespace {
+
+//! Maximal deviation of the fixed point rotation from the float rotation in units of the pixel range.
+template <class Pixel>
+float maxRelativeDeviation(int dim, int crop_dim, float alpha, float scale, float offset)
+{
+    const float range = std::numeric_limits<Pixel>::max();
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> pixel(0, range);
+
+    std::vector<Pixel> image(dim * dim);
+    std::vector<float> imageFloat(dim * dim), expected(crop_dim * crop_dim), result(crop_dim * crop_dim);
+    for (int i = 0; i < dim * dim; ++i) {
+        image[i] = pixel(rng);
+        imageFloat[i] = scale * image[i] + offset;
+    }
+
+    rotateAndCrop(dim, dim, crop_dim, crop_dim, &imageFloat[0], &expected[0], alpha, Interpolation::BILINEAR);
+    FixedPointRotation rotation(dim, dim, crop_dim, crop_dim, alpha);
+    rotation.apply(&image[0], &result[0], scale, offset);
+
+    float maxDeviation = 0.0;
+    for (int i = 0; i < crop_dim * crop_dim; ++i) {
+        maxDeviation = std::max(maxDeviation, std::abs(result[i] - expected[i]) / (scale * range));
+    }
+    return maxDeviation;
+}
+
+} // anonymous namespace
+
+TEST(FixedPointRotationTest, CompareWithFloat)
+{
+    // The positions are rounded to 1/128 pixel per axis
+    for (float alpha : {0.0f, 0.3f, 1.1f, 2.6f, -0.8f}) {
+        EXPECT_LT(maxRelativeDeviation<uint8_t>(37, 30, alpha, 1.0, 0.0), 0.01) << "alpha = " << alpha;
+        EXPECT_LT(maxRelativeDeviation<uint8_t>(64, 45, alpha, 1.0 / 255, -0.5), 0.01) << "alpha = " << alpha;
+        EXPECT_LT(maxRelativeDeviation<uint16_t>(37, 30, alpha, 1.0, 0.0), 0.01) << "alpha = " << alpha;
+        EXPECT_LT(maxRelativeDeviation<uint16_t>(23, 23, alpha, 2.0, 1.0), 0.01) << "alpha = " << alpha;
+    }
+}
+
+TEST(FixedPointRotationTest, BorderWithOffset)
+{
+    // Rotated pixels outside the source image must be zero and not the offset
+    for (float alpha : {0.25f * static_cast<float>(M_PI), 0.3f, 2.6f}) {
+        EXPECT_LT(maxRelativeDeviation<uint8_t>(32, 32, alpha, 1.0 / 255, -0.1), 0.01) << "alpha = " << alpha;
+        EXPECT_LT(maxRelativeDeviation<uint16_t>(33, 33, alpha, 1.0 / 65535, 0.5), 0.01) << "alpha = " << alpha;
+    }
+
+    int dim = 16;
+    std::vector<uint8_t> image(dim * dim, 0);
+    std::vector<float> result(dim * dim);
+    FixedPointRotation(dim, dim, dim, dim, 0.25 * M_PI).apply(&image[0], &result[0], 1.0 / 255, -0.1);
+    EXPECT_EQ(0.0f, result[0]);
+    EXPECT_FLOAT_EQ(-0.1f, result[dim / 2 * dim + dim / 2]);
+}
+
+TEST(FixedPointRotationTest, Exact)
+{
+    int dim = 13;
+    std::vector<uint16_t> image(dim * dim);
+    std::vector<float> result(dim * dim);
+    for (int i = 0; i < dim * dim; ++i) image[i] = 65535 - 17 * i;
+
+    // Without rotation the pixels are copied
+    FixedPointRotation(dim, dim, dim, dim, 0.0).apply(&image[0], &result[0]);
+    for (int i = 0; i < dim * dim; ++i) EXPECT_EQ(image[i], result[i]);
+
+    // Quarter turn
+    std::vector<float> imageFloat(image.begin(), image.end()), expected(dim * dim);
+    rotate_90degrees(dim, dim, &imageFloat[0], &expected[0]);
+    FixedPointRotation(dim, dim, dim, dim, 0.5 * M_PI).apply(&image[0], &result[0]);
+    EXPECT_EQ(expected, result);
+}
+
+TEST(FixedPointRotationTest, BFloat16)
+{
+    int dim = 29;
+    int crop_dim = 21;
+    std::vector<uint8_t> image(dim * dim);
+    for (int i = 0; i < dim * dim; ++i) image[i] = (i * 37) % 256;
+
+    FixedPointRotation rotation(dim, dim, crop_dim, crop_dim, 0.7);
+    std::vector<float> expected(crop_dim * crop_dim);
+    std::vector<bfloat16> result(crop_dim * crop_dim);
+    rotation.apply(&image[0], &expected[0], 0.01, -1.0);
+    rotation.apply(&image[0], &result[0], 0.01, -1.0);
+
+    for (int i = 0; i < crop_dim * crop_dim; ++i) EXPECT_EQ(bfloat16(expected[i]).bits, result[i].bits);
+}
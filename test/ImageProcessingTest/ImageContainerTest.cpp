@@ -0,0 +1,158 @@
+/**
+ * @file   ImageProcessingTest/ImageContainerTest.cpp
+ * @brief  Unit tests for the block compressed image container.
+ * @date   Oct 19, 2026
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include "gtest/gtest.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ImageProcessingLib/ImageContainer.h"
+#include "ImageProcessingLib/ImageIterator.h"
+#include "ImageProcessingLib/ImageProcessing.h"
+#include "TempFilename.h"
+
+using namespace pink;
+
+namespace {
+
+std::vector<ImageCodec> codecs()
+{
+#ifdef PINK_USE_ZLIB
+    return {ImageCodec::NONE, ImageCodec::ZLIB};
+#else
+    return {ImageCodec::NONE};
+#endif
+}
+
+} // anonymous namespace
+
+TEST(ImageContainerTest, WriteAndRead)
+{
+    const std::string filename = tempFilename("images.pinkblck");
+    const int numberOfImages = 11, numberOfChannels = 2, height = 5, width = 5;
+    const int imageSize = numberOfChannels * height * width;
+
+    // Mostly empty images with integer values, exact in all pixel types
+    std::vector<float> images(numberOfImages * imageSize, 0.0f);
+    for (int i = 0; i < numberOfImages; ++i) {
+        images[i * imageSize + 12] = i + 1;
+        images[i * imageSize + 37] = 2 * i;
+    }
+
+    for (ImageCodec codec : codecs()) {
+        for (PixelType pixelType : {PixelType::FLOAT32, PixelType::UINT8}) {
+            {
+                ImageContainerWriter writer(filename,
+                    ImageFileHeader(0, numberOfChannels, height, width, pixelType), 3, codec);
+                writer.add(&images[0], 4);
+                writer.add(&images[4 * imageSize], numberOfImages - 4);
+            }
+
+            EXPECT_TRUE(isImageContainer(filename));
+
+            ImageContainerReader reader(filename, 2);
+            EXPECT_EQ(codec, reader.getCodec());
+            EXPECT_EQ(4, reader.getNumberOfBlocks());
+            EXPECT_EQ(numberOfImages, reader.getHeader().numberOfImages);
+
+            std::vector<float> data;
+            int n, c, h, w;
+            readImagesFromBinaryFile(data, n, c, h, w, filename);
+            EXPECT_EQ(numberOfImages, n);
+            EXPECT_EQ(numberOfChannels, c);
+            EXPECT_EQ(images, data);
+
+            int i = 0;
+            for (ImageIterator<float> iterImage(filename), iterEnd; iterImage != iterEnd; ++iterImage, ++i) {
+                std::vector<float> image(images.begin() + i * imageSize, images.begin() + (i + 1) * imageSize);
+                EXPECT_EQ(image, iterImage->getPixel());
+            }
+            EXPECT_EQ(numberOfImages, i);
+
+            // Skip into the third block
+            ImageIterator<float> iterImage(filename);
+            iterImage += 7;
+            std::vector<float> image(images.begin() + 7 * imageSize, images.begin() + 8 * imageSize);
+            EXPECT_EQ(image, iterImage->getPixel());
+
+            // Seek backwards into the first block and forward into the last one
+            iterImage.seek(1);
+            EXPECT_EQ(std::vector<float>(images.begin() + imageSize, images.begin() + 2 * imageSize), iterImage->getPixel());
+            iterImage.seek(numberOfImages - 1);
+            EXPECT_EQ(std::vector<float>(images.end() - imageSize, images.end()), iterImage->getPixel());
+        }
+    }
+
+    std::remove(filename.c_str());
+}
+
+TEST(ImageContainerTest, BrokenLastBlock)
+{
+    const std::string filename = tempFilename("broken.pinkblck");
+    const int numberOfImages = 11, imageSize = 4;
+
+    std::vector<float> images(numberOfImages * imageSize);
+    for (size_t i = 0; i < images.size(); ++i) images[i] = i;
+    {
+        ImageContainerWriter writer(filename, ImageFileHeader(0, 1, 2, 2), 3, ImageCodec::NONE);
+        writer.add(&images[0], numberOfImages);
+    }
+
+    // The size of the last block is the last entry of the index at the end of the file
+    {
+        std::fstream fs(filename, std::ios::binary | std::ios::in | std::ios::out);
+        fs.seekp(-static_cast<int>(sizeof(int64_t)), std::ios::end);
+        int64_t size = 1;
+        fs.write((char*)&size, sizeof(int64_t));
+    }
+
+    // All blocks are decompressed in parallel, the error of the last block is thrown only when it is requested
+    ImageContainerReader reader(filename, 4);
+    std::vector<float> image(imageSize);
+    for (int i = 0; i < 9; ++i) {
+        reader.next((char*)&image[0]);
+        EXPECT_EQ(std::vector<float>(images.begin() + i * imageSize, images.begin() + (i + 1) * imageSize), image);
+    }
+    EXPECT_THROW(reader.next((char*)&image[0]), std::runtime_error);
+
+    std::remove(filename.c_str());
+}
+
+TEST(ImageContainerTest, InvalidHeader)
+{
+    const std::string filename = tempFilename("invalid.pinkblck");
+    std::vector<float> images(11 * 4, 1.0f);
+
+    // Images per block and number of blocks behind the magic, the version and the codec
+    for (std::pair<int, int> position_value : {std::make_pair(16, 0), std::make_pair(16, -3),
+        std::make_pair(20, 3), std::make_pair(20, 5)}) {
+        {
+            ImageContainerWriter writer(filename, ImageFileHeader(0, 1, 2, 2), 3, ImageCodec::NONE);
+            writer.add(&images[0], 11);
+        }
+        {
+            std::fstream fs(filename, std::ios::binary | std::ios::in | std::ios::out);
+            fs.seekp(position_value.first);
+            fs.write((char*)&position_value.second, sizeof(int));
+        }
+        EXPECT_THROW(ImageContainerReader reader(filename), std::runtime_error) << position_value.first
+            << ", " << position_value.second;
+    }
+
+    std::remove(filename.c_str());
+}
+
+TEST(ImageContainerTest, PlainBinaryFile)
+{
+    const std::string filename = tempFilename("images_plain.bin");
+    writeImagesToBinaryFile(std::vector<float>{1, 2, 3, 4}, 1, 1, 2, 2, filename);
+    EXPECT_FALSE(isImageContainer(filename));
+
+    std::remove(filename.c_str());
+}
@@ -153,6 +153,53 @@ TEST(ImageProcessingTest, FlipAndCrop)
     EXPECT_FLOAT_EQ(suma, sumb);
 }
 
+TEST(ImageProcessingTest, MultiChannelCopies)
+{
+    // Sizes covering partial SIMD blocks and partial cache tiles
+    for (int dim : {1, 5, 8, 35, 70}) {
+        int height = dim;
+        int width = dim + 3;
+        int size = height * width;
+        int crop_height = std::max(1, height - 4);
+        int crop_width = std::max(1, width - 5);
+        int crop_size = crop_height * crop_width;
+        int channels = 3;
+
+        std::vector<float> image(channels * size), rotated(channels * size), flipped(channels * size);
+        std::vector<float> cropped(channels * crop_size), flippedAndCropped(channels * crop_size);
+        fillWithRandomNumbers(&image[0], image.size());
+
+        rotate_90degrees(height, width, &image[0], &rotated[0], channels);
+        flip(height, width, &image[0], &flipped[0], channels);
+        crop(height, width, crop_height, crop_width, &image[0], &cropped[0], channels);
+        flipAndCrop(height, width, crop_height, crop_width, &image[0], &flippedAndCropped[0], channels);
+
+        int height_margin = (height - crop_height) / 2;
+        int width_margin = (width - crop_width) / 2;
+
+        for (int c = 0; c < channels; ++c) {
+            float const *a = &image[c * size];
+            for (int x = 0; x < width; ++x) {
+                for (int y = 0; y < height; ++y) {
+                    EXPECT_EQ(a[x*height + y], rotated[c*size + (height-y-1)*width + x]);
+                }
+            }
+            for (int i = 0; i < height; ++i) {
+                for (int j = 0; j < width; ++j) {
+                    EXPECT_EQ(a[i*width + j], flipped[c*size + (height-1-i)*width + j]);
+                }
+            }
+            for (int i = 0; i < crop_height; ++i) {
+                for (int j = 0; j < crop_width; ++j) {
+                    float expected = a[(i+height_margin)*width + j + width_margin];
+                    EXPECT_EQ(expected, cropped[c*crop_size + i*crop_width + j]);
+                    EXPECT_EQ(expected, flippedAndCropped[c*crop_size + (crop_height-1-i)*crop_width + j]);
+                }
+            }
+        }
+    }
+}
+
 TEST(ImageProcessingTest, RotateAndCrop)
 {
     int dim = 4;
@@ -173,3 +220,120 @@ TEST(ImageProcessingTest, RotateAndCrop)
 
     EXPECT_FLOAT_EQ(suma, sumb);
 }
+
+TEST(ImageProcessingTest, ShearRotateAndCrop)
+{
+    int dim = 41;
+    int crop_dim = 29;
+    int size = dim * dim;
+    int crop_size = crop_dim * crop_dim;
+    float center = (dim - 1) * 0.5;
+
+    std::vector<float> image(size), turned(size), tmp(size);
+    std::vector<float> expected(crop_size), shear(crop_size), bilinear(crop_size);
+    fillWithRandomNumbers(&image[0], size);
+
+    // Multiples of 90 degrees are exact
+    turned = image;
+    for (int q = 0; q < 4; ++q) {
+        crop(dim, dim, crop_dim, crop_dim, &turned[0], &expected[0]);
+        rotateAndCrop(dim, dim, crop_dim, crop_dim, &image[0], &shear[0], q * 0.5 * M_PI, Interpolation::SHEAR);
+        EXPECT_EQ(expected, shear);
+        rotate_90degrees(dim, dim, &turned[0], &tmp[0]);
+        turned.swap(tmp);
+    }
+
+    // Smooth image, the error is of the same order as the one of bilinear interpolation
+    auto function = [](float x, float y) { return std::sin(0.31f * x) * std::cos(0.23f * y); };
+    for (int x = 0; x < dim; ++x) {
+        for (int y = 0; y < dim; ++y) image[x * dim + y] = function(x - center, y - center);
+    }
+    int margin = (dim - crop_dim) / 2;
+    for (float alpha : {0.2f, -0.7f, 1.3f, 2.9f, -2.1f}) {
+        rotateAndCrop(dim, dim, crop_dim, crop_dim, &image[0], &shear[0], alpha, Interpolation::SHEAR);
+        rotateAndCrop(dim, dim, crop_dim, crop_dim, &image[0], &bilinear[0], alpha, Interpolation::BILINEAR);
+        float maxErrorShear = 0.0, maxErrorBilinear = 0.0;
+        for (int x2 = 0; x2 < crop_dim; ++x2) {
+            for (int y2 = 0; y2 < crop_dim; ++y2) {
+                float tx = x2 + margin - center;
+                float ty = y2 + margin - center;
+                float exact = function(tx * cos(alpha) + ty * sin(alpha), ty * cos(alpha) - tx * sin(alpha));
+                maxErrorShear = std::max(maxErrorShear, std::abs(shear[x2 * crop_dim + y2] - exact));
+                maxErrorBilinear = std::max(maxErrorBilinear, std::abs(bilinear[x2 * crop_dim + y2] - exact));
+            }
+        }
+        EXPECT_LT(maxErrorShear, 0.05) << "alpha = " << alpha;
+        EXPECT_LT(maxErrorShear, 3.0 * maxErrorBilinear) << "alpha = " << alpha;
+    }
+}
+
+TEST(ImageProcessingTest, BilinearRotateAndCropBorder)
+{
+    int dim = 37;
+    int crop_dim = 30;
+    int margin = (dim - crop_dim) / 2;
+    float center = (dim - 1) * 0.5;
+
+    std::vector<float> image(dim * dim), ones(dim * dim, 1.0f), rotated(crop_dim * crop_dim);
+    fillWithRandomNumbers(&image[0], image.size());
+
+    for (float alpha : {0.1f, 0.7f, 1.3f, 2.9f}) {
+        float cosAlpha = cos(alpha);
+        float sinAlpha = sin(alpha);
+
+        // Interior pixels are identical to the plain scalar formula
+        rotateAndCrop(dim, dim, crop_dim, crop_dim, &image[0], &rotated[0], alpha);
+        for (int x2 = 0; x2 < crop_dim; ++x2) {
+            for (int y2 = 0; y2 < crop_dim; ++y2) {
+                float x1 = ((float)x2 + margin - center) * cosAlpha + ((float)y2 + margin - center) * sinAlpha + center;
+                float y1 = ((float)y2 + margin - center) * cosAlpha - ((float)x2 + margin - center) * sinAlpha + center;
+                if (x1 < 0 or x1 >= dim - 1 or y1 < 0 or y1 >= dim - 1) continue;
+                int ix1 = x1;
+                int iy1 = y1;
+                float rx1 = x1 - ix1;
+                float ry1 = y1 - iy1;
+                float cx1 = 1.0f - rx1;
+                float cy1 = 1.0f - ry1;
+                float expected = cx1 * cy1 * image[ix1 * dim + iy1] + cx1 * ry1 * image[ix1 * dim + iy1 + 1]
+                               + rx1 * cy1 * image[(ix1 + 1) * dim + iy1] + rx1 * ry1 * image[(ix1 + 1) * dim + iy1 + 1];
+                EXPECT_EQ(expected, rotated[x2 * crop_dim + y2]);
+            }
+        }
+
+        // Corners are outside of the image, they fade to zero
+        rotateAndCrop(dim, dim, crop_dim, crop_dim, &ones[0], &rotated[0], alpha);
+        for (float value : rotated) {
+            EXPECT_GE(value, 0.0f);
+            EXPECT_LE(value, 1.0f + 1e-6f);
+        }
+        EXPECT_LT(*std::min_element(rotated.begin(), rotated.end()), 1.0f);
+    }
+}
+
+TEST(ImageProcessingTest, PrincipalAxis)
+{
+    int dim = 41;
+    int crop_dim = 29;
+    float angle = 0.3;
+    std::vector<float> image(dim * dim), rotated(crop_dim * crop_dim), flipped(crop_dim * crop_dim);
+
+    // Elongated gaussian
+    for (int x = 0; x < dim; ++x) {
+        for (int y = 0; y < dim; ++y) {
+            float dx = x - 20, dy = y - 20;
+            float u = dx * std::cos(angle) + dy * std::sin(angle);
+            float v = -dx * std::sin(angle) + dy * std::cos(angle);
+            image[x * dim + y] = std::exp(-0.5 * (u * u / 16.0 + v * v));
+        }
+    }
+
+    PrincipalAxis axis = calculatePrincipalAxis(&image[0], dim);
+    EXPECT_NEAR(angle, axis.angle, 1e-3);
+    EXPECT_NEAR(15.0 / 17.0, axis.anisotropy, 1e-2);
+
+    rotateAndCrop(dim, dim, crop_dim, crop_dim, &image[0], &rotated[0], 0.5);
+    EXPECT_NEAR(angle + 0.5, calculatePrincipalAxis(&rotated[0], crop_dim).angle, 1e-3);
+
+    flip(crop_dim, crop_dim, &rotated[0], &flipped[0]);
+    EXPECT_NEAR(-angle - 0.5, calculatePrincipalAxis(&flipped[0], crop_dim).angle, 1e-3);
+}
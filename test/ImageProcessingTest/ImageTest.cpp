@@ -5,16 +5,20 @@
  * @author Bernd Doser, HITS gGmbH
  */
 
+#include <cstdio>
+#include <fstream>
 #include "gtest/gtest.h"
 #include <string>
 
 #include "ImageProcessingLib/ImageIterator.h"
+#include "ImageProcessingLib/ImageProcessing.h"
+#include "TempFilename.h"
 
 using namespace pink;
 
 TEST(ImageTest, ImageIterator)
 {
-    const std::string filename("image.bin");
+    const std::string filename = tempFilename("image.bin");
 
     Image<float> image(2,3);
     image.getPixel() = {1.1, 2.1, 3.1, 4.1, 5.1, 6.1};
@@ -27,4 +31,117 @@ TEST(ImageTest, ImageIterator)
 
     std::vector<float> data{1.1, 2.1, 3.1, 4.1, 5.1, 6.1};
     EXPECT_EQ(iterCur->getPixel(), data);
+
+    std::remove(filename.c_str());
+}
+
+TEST(ImageTest, CompactPixelTypes)
+{
+    const std::string filename = tempFilename("compact_images.bin");
+    const int numberOfImages = 3, numberOfChannels = 2, height = 4, width = 5;
+    const int size = numberOfImages * numberOfChannels * height * width;
+
+    // Values representable by all pixel types with scale 0.5 and offset -2
+    std::vector<float> images(size);
+    for (int i = 0; i < size; ++i) images[i] = 0.5f * (i % 200) - 2.0f;
+
+    for (PixelType pixelType : {PixelType::FLOAT32, PixelType::FLOAT16, PixelType::UINT16, PixelType::UINT8})
+    {
+        writeImagesToBinaryFile(images, numberOfImages, numberOfChannels, height, width, filename,
+            pixelType, 0.5f, -2.0f);
+
+        std::ifstream is(filename, std::ios::binary | std::ios::ate);
+        EXPECT_EQ(static_cast<size_t>(is.tellg()), 9 * sizeof(int) + static_cast<size_t>(size) * pixelTypeSize(pixelType));
+
+        std::vector<float> data;
+        int n, c, h, w;
+        readImagesFromBinaryFile(data, n, c, h, w, filename);
+        EXPECT_EQ(numberOfImages, n);
+        EXPECT_EQ(numberOfChannels, c);
+        EXPECT_EQ(height, h);
+        EXPECT_EQ(width, w);
+        EXPECT_EQ(images, data);
+
+        // Skip the first image, the pixels of all channels are stored
+        ImageIterator<float> iterImage(filename);
+        EXPECT_EQ(pixelType, iterImage.getPixelType());
+        EXPECT_EQ(pixelType == PixelType::FLOAT32, iterImage.getRawPixel() == nullptr);
+        iterImage += 1;
+        std::vector<float> second(images.begin() + size / 3, images.begin() + 2 * size / 3);
+        EXPECT_EQ(second, iterImage->getPixel());
+    }
+
+    std::remove(filename.c_str());
+}
+
+TEST(ImageTest, PlainFloatHeader)
+{
+    const std::string filename = tempFilename("plain_images.bin");
+    std::vector<float> images{1.5, -2.5, 3.5, 4.5};
+
+    // Float pixels without scaling are written in the format of earlier versions
+    writeImagesToBinaryFile(images, 1, 1, 2, 2, filename);
+
+    std::ifstream is(filename, std::ios::binary);
+    int header[4];
+    is.read((char*)header, sizeof(header));
+    EXPECT_EQ(1, header[0]);
+    EXPECT_EQ(1, header[1]);
+    EXPECT_EQ(2, header[2]);
+    EXPECT_EQ(2, header[3]);
+
+    ImageIterator<float> iterImage(filename);
+    EXPECT_EQ(PixelType::FLOAT32, iterImage.getPixelType());
+    EXPECT_EQ(images, iterImage->getPixel());
+
+    std::remove(filename.c_str());
+}
+
+TEST(ImageTest, ImageRange)
+{
+    const std::string filename = tempFilename("range_images.bin");
+    const int numberOfImages = 10, numberOfChannels = 3, height = 2, width = 2;
+    const int imageSize = numberOfChannels * height * width;
+
+    std::vector<float> images(numberOfImages * imageSize);
+    for (size_t i = 0; i < images.size(); ++i) images[i] = i;
+
+    for (PixelType pixelType : {PixelType::FLOAT32, PixelType::UINT16})
+    {
+        writeImagesToBinaryFile(images, numberOfImages, numberOfChannels, height, width, filename, pixelType);
+
+        auto expected = [&](int i) {
+            return std::vector<float>(images.begin() + i * imageSize, images.begin() + (i + 1) * imageSize);
+        };
+
+        // Images 3, 4, 5 and 6
+        int i = 0;
+        for (ImageIterator<float> iterImage(filename, 3, 4), iterEnd; iterImage != iterEnd; ++iterImage, ++i) {
+            EXPECT_EQ(i, iterImage.getIndex());
+            EXPECT_EQ(expected(3 + i), iterImage->getPixel());
+        }
+        EXPECT_EQ(4, i);
+
+        // The range is limited by the end of the file
+        ImageIterator<float> iterImage(filename, 8, 5);
+        EXPECT_EQ(2, iterImage.getNumberOfImages());
+        EXPECT_EQ(8, iterImage.getFirstImage());
+
+        // Random access within the range
+        ImageIterator<float> iterRange(filename, 2);
+        EXPECT_EQ(8, iterRange.getNumberOfImages());
+        iterRange.seek(5);
+        EXPECT_EQ(expected(7), iterRange->getPixel());
+        iterRange.seek(1);
+        EXPECT_EQ(expected(3), iterRange->getPixel());
+        iterRange += 2;
+        EXPECT_EQ(3, iterRange.getIndex());
+        EXPECT_EQ(expected(5), iterRange->getPixel());
+        iterRange += 10;
+        EXPECT_TRUE(iterRange == ImageIterator<float>());
+
+        EXPECT_THROW(ImageIterator<float>(filename, 11), std::runtime_error);
+    }
+
+    std::remove(filename.c_str());
 }
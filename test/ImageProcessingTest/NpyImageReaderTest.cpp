@@ -0,0 +1,128 @@
+/**
+ * @file   ImageProcessingTest/NpyImageReaderTest.cpp
+ * @brief  Unit tests for reading NumPy files.
+ * @date   Oct 19, 2026
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include "gtest/gtest.h"
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "ImageProcessingLib/ImageIterator.h"
+#include "ImageProcessingLib/ImageProcessing.h"
+#include "ImageProcessingLib/NpyImageReader.h"
+#include "TempFilename.h"
+
+using namespace pink;
+
+namespace {
+
+//! Content of a .npy file version 1.0 as written by numpy.save.
+std::string npyFile(std::string const& descr, std::string const& shape, char const *data, size_t size,
+    bool fortranOrder = false)
+{
+    std::string dict = "{'descr': '" + descr + "', 'fortran_order': " + (fortranOrder ? "True" : "False")
+        + ", 'shape': " + shape + ", }";
+    dict.resize(((dict.size() + 11) / 64 + 1) * 64 - 11, ' ');
+    dict += '\n';
+
+    std::string npy("\x93NUMPY\x01\x00", 8);
+    npy += static_cast<char>(dict.size() & 0xff);
+    npy += static_cast<char>(dict.size() >> 8);
+    return npy + dict + std::string(data, size);
+}
+
+//! Zip archive with one stored member as written by numpy.savez, without central directory.
+std::string npzFile(std::string const& name, std::string const& member)
+{
+    std::string zip("PK\x03\x04\x14\x00\x00\x00\x00\x00\x00\x00\x00\x00", 14);
+    zip += std::string(12, '\0');
+    zip += static_cast<char>(name.size());
+    zip += '\0';
+    zip += std::string("\x04\x00", 2);
+    return zip + name + std::string(4, '\0') + member;
+}
+
+void writeFile(std::string const& filename, std::string const& content)
+{
+    std::ofstream os(filename, std::ios::binary);
+    os.write(content.data(), content.size());
+}
+
+} // anonymous namespace
+
+TEST(NpyImageReaderTest, UInt8ThreeDimensions)
+{
+    const std::string filename = tempFilename("images.npy");
+
+    // Shape (N, H, W) = (3, 2, 2)
+    std::vector<uint8_t> data{0, 1, 2, 3, 10, 11, 12, 13, 20, 21, 22, 255};
+    writeFile(filename, npyFile("|u1", "(3, 2, 2)", (char const*)&data[0], data.size()));
+
+    EXPECT_TRUE(isNpyFile(filename));
+
+    ImageIterator<float> iterImage(filename);
+    EXPECT_EQ(3, iterImage.getNumberOfImages());
+    EXPECT_EQ(1, iterImage.getNumberOfChannels());
+    EXPECT_EQ(PixelType::UINT8, iterImage.getPixelType());
+    EXPECT_EQ(2, iterImage->getHeight());
+    EXPECT_EQ(2, iterImage->getWidth());
+    EXPECT_EQ((std::vector<float>{0, 1, 2, 3}), iterImage->getPixel());
+
+    iterImage += 2;
+    EXPECT_EQ((std::vector<float>{20, 21, 22, 255}), iterImage->getPixel());
+    iterImage.seek(0);
+    EXPECT_EQ((std::vector<float>{0, 1, 2, 3}), iterImage->getPixel());
+    iterImage.seek(2);
+    ++iterImage;
+    EXPECT_TRUE(iterImage == ImageIterator<float>());
+
+    std::remove(filename.c_str());
+}
+
+TEST(NpyImageReaderTest, Float32FourDimensionsInArchive)
+{
+    const std::string filename = tempFilename("images.npz");
+
+    // Shape (N, C, H, W) = (2, 2, 1, 3)
+    std::vector<float> data{1.5, 2.5, 3.5, 4.5, 5.5, 6.5, -1, -2, -3, -4, -5, -6};
+    writeFile(filename, npzFile("arr_0.npy",
+        npyFile("<f4", "(2, 2, 1, 3)", (char const*)&data[0], data.size() * sizeof(float))));
+
+    std::vector<float> images;
+    int numberOfImages, numberOfChannels, height, width;
+    readImagesFromBinaryFile(images, numberOfImages, numberOfChannels, height, width, filename);
+
+    EXPECT_EQ(2, numberOfImages);
+    EXPECT_EQ(2, numberOfChannels);
+    EXPECT_EQ(1, height);
+    EXPECT_EQ(3, width);
+    EXPECT_EQ(data, images);
+
+    std::remove(filename.c_str());
+}
+
+TEST(NpyImageReaderTest, Unsupported)
+{
+    const std::string filename = tempFilename("unsupported.npy");
+    std::vector<float> data(8, 1.0);
+
+    writeFile(filename, npyFile("<f4", "(2, 2, 2)", (char const*)&data[0], data.size() * sizeof(float), true));
+    EXPECT_THROW(NpyImageReader reader(filename), std::runtime_error);
+
+    writeFile(filename, npyFile("<f8", "(1, 2, 2)", (char const*)&data[0], data.size() * sizeof(float)));
+    EXPECT_THROW(NpyImageReader reader(filename), std::runtime_error);
+
+    writeFile(filename, npyFile("<f4", "(8,)", (char const*)&data[0], data.size() * sizeof(float)));
+    EXPECT_THROW(NpyImageReader reader(filename), std::runtime_error);
+
+    // Truncated data
+    writeFile(filename, npyFile("<f4", "(3, 2, 2)", (char const*)&data[0], data.size() * sizeof(float)));
+    EXPECT_THROW(NpyImageReader reader(filename), std::runtime_error);
+
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,398 @@
+/**
+ * @file   SelfOrganizingMapTest/EuclideanDistanceMatrixTest.cpp
+ * @brief  Unit tests for the variants of the euclidean distance matrix.
+ * @date   Oct 18, 2026
+ */
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include "gtest/gtest.h"
+#include <vector>
+
+#include "ImageProcessingLib/ImageProcessing.h"
+#include "SelfOrganizingMapLib/SelfOrganizingMap.h"
+#include "UtilitiesLib/EqualFloatArrays.h"
+#include "UtilitiesLib/Filler.h"
+
+using namespace pink;
+
+namespace {
+
+//! Elongated gaussian with random noise.
+std::vector<float> elongatedImage(int dim, float angle, int seed)
+{
+    std::vector<float> image(dim * dim);
+    fillWithRandomNumbers(&image[0], image.size(), seed);
+    float center = (dim - 1) * 0.5;
+    for (int x = 0; x < dim; ++x) {
+        for (int y = 0; y < dim; ++y) {
+            float dx = x - center, dy = y - center;
+            float u = dx * std::cos(angle) + dy * std::sin(angle);
+            float v = -dx * std::sin(angle) + dy * std::cos(angle);
+            image[x * dim + y] = 0.1 * image[x * dim + y] + std::exp(-0.5 * (u * u / 16.0 + v * v));
+        }
+    }
+    return image;
+}
+
+} // anonymous namespace
+
+TEST(EuclideanDistanceMatrixTest, PrincipalAxes)
+{
+    int image_dim = 31;
+    int neuron_dim = 21;
+    int neuron_size = neuron_dim * neuron_dim;
+    int som_size = 6;
+    int numberOfRotations = 72;
+    int numberOfRotationsAndFlip = 2 * numberOfRotations;
+
+    // Neurons are rotated copies of elongated images
+    std::vector<float> som(som_size * neuron_size);
+    for (int i = 0; i < som_size; ++i) {
+        std::vector<float> image = elongatedImage(image_dim, 0.4 * i, i);
+        crop(image_dim, image_dim, neuron_dim, neuron_dim, &image[0], &som[i * neuron_size]);
+    }
+
+    std::vector<float> image = elongatedImage(image_dim, 1.1, 42);
+    std::vector<float> rotatedImages(numberOfRotationsAndFlip * neuron_size);
+    generateRotatedImages(&rotatedImages[0], &image[0], numberOfRotations, image_dim, neuron_dim,
+        true, Interpolation::BILINEAR, 1);
+
+    std::vector<float> euclideanDistanceMatrix(som_size), euclideanDistanceMatrix2(som_size);
+    std::vector<int> bestRotationMatrix(som_size), bestRotationMatrix2(som_size);
+
+    generateEuclideanDistanceMatrix(&euclideanDistanceMatrix[0], &bestRotationMatrix[0],
+        som_size, &som[0], neuron_size, numberOfRotationsAndFlip, &rotatedImages[0]);
+
+    std::vector<PrincipalAxis> neuronAxes(som_size);
+    for (int i = 0; i < som_size; ++i) neuronAxes[i] = calculatePrincipalAxis(&som[i * neuron_size], neuron_dim);
+    PrincipalAxis imageAxis = calculatePrincipalAxis(&rotatedImages[0], neuron_dim);
+
+    generateEuclideanDistanceMatrixWithPrincipalAxes(&euclideanDistanceMatrix2[0], &bestRotationMatrix2[0],
+        som_size, &som[0], neuron_size, numberOfRotations, true, &rotatedImages[0], imageAxis, &neuronAxes[0],
+        10.0 * M_PI / 180.0, 0.1);
+
+    EXPECT_TRUE(EqualFloatArrays(&euclideanDistanceMatrix[0], &euclideanDistanceMatrix2[0], som_size));
+    EXPECT_EQ(bestRotationMatrix, bestRotationMatrix2);
+
+    // Isotropic image must fall back to full search
+    imageAxis.anisotropy = 0.0;
+    generateEuclideanDistanceMatrixWithPrincipalAxes(&euclideanDistanceMatrix2[0], &bestRotationMatrix2[0],
+        som_size, &som[0], neuron_size, numberOfRotations, true, &rotatedImages[0], imageAxis, &neuronAxes[0],
+        0.0, 0.1);
+
+    EXPECT_TRUE(EqualFloatArrays(&euclideanDistanceMatrix[0], &euclideanDistanceMatrix2[0], som_size));
+    EXPECT_EQ(bestRotationMatrix, bestRotationMatrix2);
+}
+
+TEST(EuclideanDistanceMatrixTest, Interleaved)
+{
+    int image_dim = 16;
+    int neuron_dim = 11;
+    int numberOfChannels = 2;
+    int image_size = numberOfChannels * neuron_dim * neuron_dim;
+    int som_size = 5;
+
+    std::vector<float> image(numberOfChannels * image_dim * image_dim), som(som_size * image_size);
+    fillWithRandomNumbers(&image[0], image.size(), 1);
+    fillWithRandomNumbers(&som[0], som.size(), 2);
+
+    for (int numberOfRotations : {4, 12}) {
+        int numberOfRotationsAndFlip = 2 * numberOfRotations;
+        int stride = interleavedStride(numberOfRotationsAndFlip);
+
+        std::vector<float> rotatedImages(numberOfRotationsAndFlip * image_size);
+        generateRotatedImages(&rotatedImages[0], &image[0], numberOfRotations, image_dim, neuron_dim,
+            true, Interpolation::BILINEAR, numberOfChannels);
+
+        std::vector<float> interleavedImages(stride * image_size);
+        generateRotatedImagesInterleaved(&interleavedImages[0], &image[0], numberOfRotations, image_dim, neuron_dim,
+            true, Interpolation::BILINEAR, numberOfChannels);
+
+        for (int j = 0; j < numberOfRotationsAndFlip; ++j) {
+            for (int p = 0; p < image_size; ++p) {
+                ASSERT_EQ(rotatedImages[j * image_size + p], interleavedImages[p * stride + j]);
+            }
+        }
+
+        std::vector<float> euclideanDistanceMatrix(som_size), euclideanDistanceMatrix2(som_size);
+        std::vector<int> bestRotationMatrix(som_size), bestRotationMatrix2(som_size);
+
+        generateEuclideanDistanceMatrix(&euclideanDistanceMatrix[0], &bestRotationMatrix[0],
+            som_size, &som[0], image_size, numberOfRotationsAndFlip, &rotatedImages[0]);
+        generateEuclideanDistanceMatrixInterleaved(&euclideanDistanceMatrix2[0], &bestRotationMatrix2[0],
+            som_size, &som[0], image_size, numberOfRotationsAndFlip, &interleavedImages[0]);
+
+        EXPECT_TRUE(EqualFloatArrays(&euclideanDistanceMatrix[0], &euclideanDistanceMatrix2[0], som_size, 1e-3));
+        EXPECT_EQ(bestRotationMatrix, bestRotationMatrix2);
+    }
+}
+
+TEST(EuclideanDistanceMatrixTest, FixedPointRotation)
+{
+    int image_dim = 16;
+    int neuron_dim = 11;
+    int numberOfChannels = 2;
+    int numberOfRotations = 12;
+    int image_size = numberOfChannels * neuron_dim * neuron_dim;
+    float scale = 0.01, offset = -0.5;
+
+    std::vector<uint8_t> rawImage(numberOfChannels * image_dim * image_dim);
+    std::vector<float> image(rawImage.size());
+    for (int c = 0; c < numberOfChannels; ++c) {
+        std::vector<float> channel = elongatedImage(image_dim, 0.3 * c, c + 1);
+        for (int i = 0; i < image_dim * image_dim; ++i) {
+            rawImage[c * image_dim * image_dim + i] = std::min(255.0f, std::nearbyint(200.0f * channel[i]));
+        }
+    }
+    for (size_t i = 0; i < image.size(); ++i) image[i] = scale * rawImage[i] + offset;
+
+    std::vector<float> rotatedImages(2 * numberOfRotations * image_size), fixedPointImages(rotatedImages.size());
+    generateRotatedImages(&rotatedImages[0], &image[0], numberOfRotations, image_dim, neuron_dim,
+        true, Interpolation::BILINEAR, numberOfChannels);
+    generateRotatedImages(&fixedPointImages[0], &image[0], &rawImage[0], scale, offset,
+        fixedPointRotations(numberOfRotations, image_dim, neuron_dim), numberOfRotations, image_dim, neuron_dim,
+        true, numberOfChannels);
+
+    // The interpolation positions are rounded to 1/128 pixel
+    for (size_t i = 0; i < rotatedImages.size(); ++i) {
+        ASSERT_NEAR(rotatedImages[i], fixedPointImages[i], 255 * scale * 2.0 / 128);
+    }
+
+    // Multiples of 90 degrees are not interpolated
+    for (int j : {0, 3, 6, 9, 12, 15, 18, 21}) {
+        for (int p = 0; p < image_size; ++p) {
+            ASSERT_EQ(rotatedImages[j * image_size + p], fixedPointImages[j * image_size + p]);
+        }
+    }
+}
+
+TEST(EuclideanDistanceMatrixTest, Dihedral)
+{
+    int image_dim = 16;
+    int neuron_dim = 11;
+    int numberOfChannels = 2;
+    int image_size = numberOfChannels * neuron_dim * neuron_dim;
+    int som_size = 5;
+
+    std::vector<float> image(numberOfChannels * image_dim * image_dim), som(som_size * image_size);
+    fillWithRandomNumbers(&image[0], image.size(), 1);
+    fillWithRandomNumbers(&som[0], som.size(), 2);
+
+    for (int numberOfRotations : {1, 4, 12}) {
+        for (bool useFlip : {false, true}) {
+            int numberOfRotationsAndFlip = useFlip ? 2 * numberOfRotations : numberOfRotations;
+
+            std::vector<float> rotatedImages(numberOfRotationsAndFlip * image_size);
+            generateRotatedImages(&rotatedImages[0], &image[0], numberOfRotations, image_dim, neuron_dim,
+                useFlip, Interpolation::BILINEAR, numberOfChannels);
+
+            std::vector<float> dihedralImages(dihedralNumberOfImages(numberOfRotations) * image_size);
+            generateRotatedImagesDihedral(&dihedralImages[0], &image[0], numberOfRotations, image_dim, neuron_dim,
+                Interpolation::BILINEAR, numberOfChannels);
+
+            // The single rotation is not generated by generateRotatedImages
+            if (numberOfRotations != 1) {
+                std::vector<float> dihedralImage(image_size);
+                for (int j = 0; j < numberOfRotationsAndFlip; ++j) {
+                    generateDihedralImage(&dihedralImage[0], &dihedralImages[0], j, numberOfRotations,
+                        neuron_dim, numberOfChannels);
+                    for (int p = 0; p < image_size; ++p) {
+                        ASSERT_EQ(rotatedImages[j * image_size + p], dihedralImage[p]);
+                    }
+                }
+            } else {
+                for (int j = 0; j < numberOfRotationsAndFlip; ++j) {
+                    generateDihedralImage(&rotatedImages[j * image_size], &dihedralImages[0], j, numberOfRotations,
+                        neuron_dim, numberOfChannels);
+                }
+            }
+
+            std::vector<float> euclideanDistanceMatrix(som_size), euclideanDistanceMatrix2(som_size);
+            std::vector<int> bestRotationMatrix(som_size), bestRotationMatrix2(som_size);
+
+            generateEuclideanDistanceMatrix(&euclideanDistanceMatrix[0], &bestRotationMatrix[0],
+                som_size, &som[0], image_size, numberOfRotationsAndFlip, &rotatedImages[0]);
+            generateEuclideanDistanceMatrixDihedral(&euclideanDistanceMatrix2[0], &bestRotationMatrix2[0],
+                som_size, &som[0], neuron_dim, numberOfChannels, numberOfRotations, useFlip, &dihedralImages[0]);
+
+            EXPECT_TRUE(EqualFloatArrays(&euclideanDistanceMatrix[0], &euclideanDistanceMatrix2[0], som_size, 1e-3));
+            EXPECT_EQ(bestRotationMatrix, bestRotationMatrix2);
+        }
+    }
+}
+
+TEST(EuclideanDistanceMatrixTest, Fused)
+{
+    int image_dim = 16;
+    int neuron_dim = 11;
+    int numberOfChannels = 2;
+    int image_size = numberOfChannels * neuron_dim * neuron_dim;
+    int som_size = 5;
+
+    std::vector<float> image(numberOfChannels * image_dim * image_dim), som(som_size * image_size);
+    fillWithRandomNumbers(&image[0], image.size(), 1);
+    fillWithRandomNumbers(&som[0], som.size(), 2);
+
+    for (auto interpolation : {Interpolation::BILINEAR, Interpolation::NEAREST_NEIGHBOR}) {
+        for (int numberOfRotations : {4, 12, 36}) {
+            for (bool useFlip : {false, true}) {
+                int numberOfRotationsAndFlip = useFlip ? 2 * numberOfRotations : numberOfRotations;
+
+                std::vector<float> rotatedImages(numberOfRotationsAndFlip * image_size);
+                generateRotatedImages(&rotatedImages[0], &image[0], numberOfRotations, image_dim, neuron_dim,
+                    useFlip, interpolation, numberOfChannels);
+
+                std::vector<float> rotatedImage(image_size);
+                for (int j = 0; j < numberOfRotationsAndFlip; ++j) {
+                    generateRotatedImage(&rotatedImage[0], &image[0], j, numberOfRotations, image_dim, neuron_dim,
+                        interpolation, numberOfChannels);
+                    for (int p = 0; p < image_size; ++p) {
+                        ASSERT_EQ(rotatedImages[j * image_size + p], rotatedImage[p]);
+                    }
+                }
+
+                std::vector<float> euclideanDistanceMatrix(som_size), euclideanDistanceMatrix2(som_size);
+                std::vector<int> bestRotationMatrix(som_size), bestRotationMatrix2(som_size);
+
+                generateEuclideanDistanceMatrix(&euclideanDistanceMatrix[0], &bestRotationMatrix[0],
+                    som_size, &som[0], image_size, numberOfRotationsAndFlip, &rotatedImages[0]);
+                generateEuclideanDistanceMatrixFused(&euclideanDistanceMatrix2[0], &bestRotationMatrix2[0],
+                    som_size, &som[0], &image[0], numberOfRotations, image_dim, neuron_dim, useFlip,
+                    interpolation, numberOfChannels);
+
+                EXPECT_TRUE(EqualFloatArrays(&euclideanDistanceMatrix[0], &euclideanDistanceMatrix2[0], som_size, 1e-3));
+                EXPECT_EQ(bestRotationMatrix, bestRotationMatrix2);
+            }
+        }
+    }
+}
+
+TEST(EuclideanDistanceMatrixTest, DistanceTile)
+{
+    int image_size = 2 * 13 * 13;
+    int som_size = 11;
+    int numberOfRotationsAndFlip = 46;
+
+    std::vector<float> som(som_size * image_size), rotatedImages(numberOfRotationsAndFlip * image_size);
+    fillWithRandomNumbers(&som[0], som.size(), 1);
+    fillWithRandomNumbers(&rotatedImages[0], rotatedImages.size(), 2);
+
+    // Reference: sequential comparison of all pairs
+    std::vector<float> euclideanDistanceMatrix(som_size);
+    std::vector<int> bestRotationMatrix(som_size);
+    for (int i = 0; i < som_size; ++i) {
+        euclideanDistanceMatrix[i] = FLT_MAX;
+        for (int j = 0; j < numberOfRotationsAndFlip; ++j) {
+            float d = calculateEuclideanDistanceWithoutSquareRoot(&som[i * image_size],
+                &rotatedImages[j * image_size], image_size);
+            if (d < euclideanDistanceMatrix[i]) {
+                euclideanDistanceMatrix[i] = d;
+                bestRotationMatrix[i] = j;
+            }
+        }
+    }
+
+    for (auto const& tile : {DistanceTile(1,1), DistanceTile(2,2), DistanceTile(2,4), DistanceTile(4,2),
+        DistanceTile(4,4), DistanceTile(4,8), DistanceTile(8,4), DistanceTile()})
+    {
+        std::vector<float> euclideanDistanceMatrix2(som_size);
+        std::vector<int> bestRotationMatrix2(som_size);
+
+        generateEuclideanDistanceMatrix(&euclideanDistanceMatrix2[0], &bestRotationMatrix2[0],
+            som_size, &som[0], image_size, numberOfRotationsAndFlip, &rotatedImages[0], tile);
+
+        EXPECT_TRUE(EqualFloatArrays(&euclideanDistanceMatrix[0], &euclideanDistanceMatrix2[0], som_size, 1e-3))
+            << "tile = " << tile;
+        EXPECT_EQ(bestRotationMatrix, bestRotationMatrix2) << "tile = " << tile;
+    }
+}
+
+TEST(EuclideanDistanceMatrixTest, ReducedPrecision)
+{
+    int image_size = 15 * 15;
+    int som_size = 9;
+    int numberOfRotationsAndFlip = 16;
+
+    std::vector<float> som(som_size * image_size), rotatedImages(numberOfRotationsAndFlip * image_size);
+    fillWithRandomNumbers(&som[0], som.size(), 1);
+    fillWithRandomNumbers(&rotatedImages[0], rotatedImages.size(), 2);
+
+    std::vector<bfloat16> somBFloat16(som.size());
+    std::vector<float16> somFloat16(som.size());
+    convertFromFloat(&somBFloat16[0], &som[0], som.size());
+    convertFromFloat(&somFloat16[0], &som[0], som.size());
+
+    // Reference: float kernel on widened neurons
+    std::vector<float> widenedSom(som.size());
+    std::vector<float> euclideanDistanceMatrix(som_size), euclideanDistanceMatrix2(som_size);
+    std::vector<int> bestRotationMatrix(som_size), bestRotationMatrix2(som_size);
+
+    convertToFloat(&widenedSom[0], &somBFloat16[0], som.size());
+    generateEuclideanDistanceMatrix(&euclideanDistanceMatrix[0], &bestRotationMatrix[0],
+        som_size, &widenedSom[0], image_size, numberOfRotationsAndFlip, &rotatedImages[0]);
+    generateEuclideanDistanceMatrix(&euclideanDistanceMatrix2[0], &bestRotationMatrix2[0],
+        som_size, &somBFloat16[0], image_size, numberOfRotationsAndFlip, &rotatedImages[0]);
+
+    EXPECT_EQ(euclideanDistanceMatrix, euclideanDistanceMatrix2);
+    EXPECT_EQ(bestRotationMatrix, bestRotationMatrix2);
+
+    convertToFloat(&widenedSom[0], &somFloat16[0], som.size());
+    generateEuclideanDistanceMatrix(&euclideanDistanceMatrix[0], &bestRotationMatrix[0],
+        som_size, &widenedSom[0], image_size, numberOfRotationsAndFlip, &rotatedImages[0]);
+    generateEuclideanDistanceMatrix(&euclideanDistanceMatrix2[0], &bestRotationMatrix2[0],
+        som_size, &somFloat16[0], image_size, numberOfRotationsAndFlip, &rotatedImages[0]);
+
+    EXPECT_EQ(euclideanDistanceMatrix, euclideanDistanceMatrix2);
+    EXPECT_EQ(bestRotationMatrix, bestRotationMatrix2);
+}
+
+TEST(EuclideanDistanceMatrixTest, BestMatchingNeurons)
+{
+    int image_dim = 31;
+    int neuron_dim = 21;
+    int neuron_size = neuron_dim * neuron_dim;
+    int som_size = 37;
+    int numberOfRotations = 72;
+    int numberOfRotationsAndFlip = 2 * numberOfRotations;
+
+    std::vector<float> som(som_size * neuron_size);
+    for (int i = 0; i < som_size; ++i) {
+        std::vector<float> image = elongatedImage(image_dim, 0.3 * i, i);
+        crop(image_dim, image_dim, neuron_dim, neuron_dim, &image[0], &som[i * neuron_size]);
+    }
+
+    // Equal distances are resolved to the lower neuron
+    std::copy(&som[3 * neuron_size], &som[4 * neuron_size], &som[20 * neuron_size]);
+
+    std::vector<float> image = elongatedImage(image_dim, 0.9, 42);
+    std::vector<float> rotatedImages(numberOfRotationsAndFlip * neuron_size);
+    generateRotatedImages(&rotatedImages[0], &image[0], numberOfRotations, image_dim, neuron_dim,
+        true, Interpolation::BILINEAR, 1);
+
+    for (auto const& tile : {DistanceTile(1,1), DistanceTile(2,2), DistanceTile(2,4), DistanceTile(4,2),
+        DistanceTile(4,4), DistanceTile(4,8), DistanceTile(8,4)})
+    {
+        std::vector<float> euclideanDistanceMatrix(som_size);
+        std::vector<int> bestRotationMatrix(som_size);
+        generateEuclideanDistanceMatrix(&euclideanDistanceMatrix[0], &bestRotationMatrix[0],
+            som_size, &som[0], neuron_size, numberOfRotationsAndFlip, &rotatedImages[0], tile);
+
+        for (int k : {1, 5, som_size})
+        {
+            std::vector<BestMatch> expected(k), bestMatches(k);
+            findBestMatchingNeurons(&expected[0], k, &euclideanDistanceMatrix[0], &bestRotationMatrix[0], som_size);
+            generateBestMatchingNeurons(&bestMatches[0], k, som_size, &som[0], neuron_size,
+                numberOfRotationsAndFlip, &rotatedImages[0], tile);
+
+            EXPECT_EQ(findBestMatchingNeuron(&euclideanDistanceMatrix[0], som_size), expected[0].neuron);
+            for (int i = 0; i < k; ++i) {
+                EXPECT_EQ(expected[i].neuron, bestMatches[i].neuron) << "tile = " << tile << ", k = " << k;
+                EXPECT_EQ(expected[i].distance, bestMatches[i].distance) << "tile = " << tile << ", k = " << k;
+                EXPECT_EQ(expected[i].rotation, bestMatches[i].rotation) << "tile = " << tile << ", k = " << k;
+            }
+            for (int i = 1; i < k; ++i) EXPECT_FALSE(bestMatches[i] < bestMatches[i - 1]);
+        }
+    }
+}
@@ -0,0 +1,143 @@
+/**
+ * @file   SelfOrganizingMapTest/HNSWIndexTest.cpp
+ * @brief  Unit tests for approximate nearest neighbor index.
+ * @date   Oct 18, 2026
+ */
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include "gtest/gtest.h"
+#include <string>
+#include <vector>
+
+#include "ImageProcessingLib/ImageProcessing.h"
+#include "SelfOrganizingMapLib/HNSWIndex.h"
+#include "SelfOrganizingMapLib/SelfOrganizingMap.h"
+#include "UtilitiesLib/EqualFloatArrays.h"
+#include "UtilitiesLib/Filler.h"
+#include "TempFilename.h"
+
+using namespace pink;
+
+namespace {
+
+int bruteForceNearest(std::vector<float> const& data, int dim, float const *query)
+{
+    int best = 0;
+    float bestDistance = FLT_MAX;
+    for (size_t i = 0; i < data.size() / dim; ++i) {
+        float d = 0.0;
+        for (int k = 0; k < dim; ++k) d += std::pow(query[k] - data[i*dim + k], 2);
+        if (d < bestDistance) {
+            bestDistance = d;
+            best = i;
+        }
+    }
+    return best;
+}
+
+} // anonymous namespace
+
+TEST(HNSWIndexTest, Recall)
+{
+    int dim = 16;
+    int numberOfVectors = 2000;
+    int numberOfQueries = 100;
+
+    std::vector<float> data(numberOfVectors * dim), queries(numberOfQueries * dim);
+    fillWithRandomNumbers(&data[0], data.size(), 1);
+    fillWithRandomNumbers(&queries[0], queries.size(), 2);
+
+    HNSWIndex index(dim);
+    index.addVectors(&data[0], numberOfVectors);
+    index.build();
+
+    int hits = 0;
+    for (int q = 0; q < numberOfQueries; ++q) {
+        auto result = index.search(&queries[q*dim], 1, 64);
+        ASSERT_EQ(1UL, result.size());
+        if (result[0].second == bruteForceNearest(data, dim, &queries[q*dim])) ++hits;
+    }
+
+    EXPECT_GE(hits, 0.95 * numberOfQueries);
+}
+
+TEST(HNSWIndexTest, SaveAndLoad)
+{
+    int dim = 8;
+    int numberOfVectors = 500;
+    const std::string filename = tempFilename("index.hnsw");
+
+    std::vector<float> data(numberOfVectors * dim), query(dim);
+    fillWithRandomNumbers(&data[0], data.size(), 1);
+    fillWithRandomNumbers(&query[0], query.size(), 2);
+
+    HNSWIndex index(dim);
+    index.addVectors(&data[0], numberOfVectors);
+    index.build();
+    index.save(filename);
+
+    HNSWIndex index2(dim);
+    index2.addVectors(&data[0], numberOfVectors);
+    EXPECT_TRUE(index2.load(filename));
+    EXPECT_EQ(index.search(&query[0], 10, 32), index2.search(&query[0], 10, 32));
+
+    // Modified vectors must be rejected
+    std::vector<float> modified(data);
+    modified[0] += 1.0;
+    HNSWIndex index3(dim);
+    index3.addVectors(&modified[0], numberOfVectors);
+    EXPECT_FALSE(index3.load(filename));
+
+    // Corrupt entry point and neighbor id of the first vector, behind the magic and the integer header
+    const std::streamoff entryPointOffset = 8 + 6 * sizeof(int);
+    const std::streamoff firstNeighborOffset = entryPointOffset + sizeof(int) + sizeof(uint64_t) + 2 * sizeof(int);
+    for (std::streamoff offset : {entryPointOffset, firstNeighborOffset}) {
+        for (int value : {-2, numberOfVectors}) {
+            index.save(filename);
+            {
+                std::fstream fs(filename, std::ios::binary | std::ios::in | std::ios::out);
+                fs.seekp(offset);
+                fs.write((char*)&value, sizeof(int));
+            }
+            HNSWIndex index4(dim);
+            index4.addVectors(&data[0], numberOfVectors);
+            EXPECT_FALSE(index4.load(filename)) << "offset " << offset << ", value " << value;
+        }
+    }
+    index.save(filename);
+    EXPECT_TRUE(index2.load(filename));
+
+    std::remove(filename.c_str());
+}
+
+TEST(HNSWIndexTest, RotatedNeurons)
+{
+    int image_dim = 15;
+    int neuron_dim = 11;
+    int neuron_size = neuron_dim * neuron_dim;
+    int numberOfRotations = 4;
+    int numberOfRotationsAndFlip = 2 * numberOfRotations;
+
+    std::vector<float> image(image_dim * image_dim);
+    fillWithRandomNumbers(&image[0], image.size());
+
+    std::vector<float> rotatedImages(numberOfRotationsAndFlip * neuron_size);
+    generateRotatedImages(&rotatedImages[0], &image[0], numberOfRotations, image_dim, neuron_dim,
+        true, Interpolation::NEAREST_NEIGHBOR, 1);
+
+    // Using the rotated images as neurons, the back transformation must give the cropped image
+    std::vector<float> rotatedNeurons(numberOfRotationsAndFlip * numberOfRotationsAndFlip * neuron_size);
+    generateRotatedNeurons(&rotatedNeurons[0], &rotatedImages[0], numberOfRotationsAndFlip, neuron_dim,
+        numberOfRotations, true, Interpolation::NEAREST_NEIGHBOR, 1);
+
+    applyCircularMask(&rotatedImages[0], neuron_dim, 1);
+    for (int j = 0; j < numberOfRotationsAndFlip; ++j) {
+        EXPECT_TRUE(EqualFloatArrays(&rotatedImages[0],
+            &rotatedNeurons[(j * numberOfRotationsAndFlip + j) * neuron_size], neuron_size)) << "j = " << j;
+    }
+}
@@ -0,0 +1,77 @@
+/**
+ * @file   SelfOrganizingMapTest/MappingResultWriterTest.cpp
+ * @brief  Unit tests for writing the result files of the mapping.
+ * @date   Oct 19, 2026
+ */
+
+#include <cstdio>
+#include <fstream>
+#include "gtest/gtest.h"
+#include <string>
+#include <vector>
+
+#ifdef PINK_USE_ZLIB
+#include <zlib.h>
+#endif
+
+#include "SelfOrganizingMapLib/MappingResultWriter.h"
+#include "TempFilename.h"
+
+using namespace pink;
+
+#ifdef PINK_USE_ZLIB
+
+TEST(MappingResultWriterTest, CompressedUInt16)
+{
+    InputData inputData;
+    inputData.resultFilename = tempFilename("result.bin");
+    inputData.som_width = 3;
+    inputData.som_height = 2;
+    inputData.som_depth = 1;
+    inputData.som_size = 6;
+    inputData.numberOfImages = 3;
+    inputData.numberOfRotations = 4;
+    inputData.resultEncoding = ResultEncoding::UINT16;
+    inputData.resultCompression = ImageCodec::ZLIB;
+
+    std::vector<float> distances(inputData.numberOfImages * inputData.som_size);
+    for (size_t i = 0; i < distances.size(); ++i) distances[i] = (i * 37) % 11 + 0.5f * i;
+
+    {
+        MappingResultWriter writer(inputData);
+        for (int i = 0; i < inputData.numberOfImages; ++i)
+            writer.write(&distances[i * inputData.som_size], nullptr);
+    }
+
+    std::ifstream is(inputData.resultFilename, std::ios::binary);
+    ResultFileHeader header = readResultFileHeader(is);
+    EXPECT_EQ(3, header.numberOfImages);
+    EXPECT_EQ(ResultEncoding::UINT16, header.encoding);
+    EXPECT_EQ(ImageCodec::ZLIB, header.codec);
+
+    // All rows fit into one block
+    int64_t blockHeader[2];
+    is.read((char*)blockHeader, sizeof(blockHeader));
+    EXPECT_EQ(3, blockHeader[0]);
+    std::vector<char> compressed(blockHeader[1]);
+    is.read(&compressed[0], compressed.size());
+    EXPECT_TRUE(is);
+    EXPECT_EQ(EOF, is.peek());
+
+    const size_t rowSize = header.getRowSizeInBytes(inputData.som_size);
+    std::vector<char> rows(3 * rowSize);
+    uLongf size = rows.size();
+    EXPECT_EQ(Z_OK, uncompress((Bytef*)&rows[0], &size, (Bytef const*)&compressed[0], compressed.size()));
+    EXPECT_EQ(rows.size(), size);
+
+    std::vector<float> decoded(inputData.som_size);
+    for (int i = 0; i < inputData.numberOfImages; ++i) {
+        decodeDistances(&decoded[0], &rows[i * rowSize], inputData.som_size, header.encoding);
+        for (int j = 0; j < inputData.som_size; ++j)
+            EXPECT_NEAR(distances[i * inputData.som_size + j], decoded[j], 1e-3);
+    }
+
+    std::remove(inputData.resultFilename.c_str());
+}
+
+#endif
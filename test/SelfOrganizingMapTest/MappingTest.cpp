@@ -0,0 +1,156 @@
+/**
+ * @file   SelfOrganizingMapTest/MappingTest.cpp
+ * @brief  Unit tests for mapping of integer input images.
+ * @date   Oct 19, 2026
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include "gtest/gtest.h"
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ImageProcessingLib/ImageFileHeader.h"
+#include "ImageProcessingLib/ImageIterator.h"
+#include "SelfOrganizingMapLib/SOM.h"
+#include "TempFilename.h"
+
+using namespace pink;
+
+namespace {
+
+//! Distances and best rotations of all images of filename.
+void map(std::vector<float>& distances, std::vector<int>& rotations, std::string const& filename, InputData& inputData)
+{
+    ImageIterator<float> iterImage(filename);
+    inputData.imagePixelType = iterImage.getPixelType();
+    SOM som(inputData);
+
+    std::vector<float> rotatedImages(som.getRotatedImagesSize());
+    distances.clear();
+    rotations.clear();
+    for (ImageIterator<float> iterEnd; iterImage != iterEnd; ++iterImage) {
+        std::vector<float> euclideanDistanceMatrix(inputData.som_size);
+        std::vector<int> bestRotationMatrix(inputData.som_size);
+        som.computeRotatedImages(&rotatedImages[0], iterImage);
+        som.computeDistances(&euclideanDistanceMatrix[0], &bestRotationMatrix[0], &rotatedImages[0]);
+        distances.insert(distances.end(), euclideanDistanceMatrix.begin(), euclideanDistanceMatrix.end());
+        rotations.insert(rotations.end(), bestRotationMatrix.begin(), bestRotationMatrix.end());
+    }
+}
+
+} // anonymous namespace
+
+TEST(MappingTest, UInt8WithOffset)
+{
+    const int numberOfImages = 3;
+    const int dim = 32;
+    const float scale = 1.0 / 255, offset = -0.3;
+
+    // Smooth blobs, the rotated corners sample outside of the image
+    std::vector<uint8_t> raw(numberOfImages * dim * dim);
+    std::vector<float> pixels(raw.size());
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> position(8.0, 24.0);
+    for (int n = 0; n < numberOfImages; ++n) {
+        float x0 = position(rng), y0 = position(rng);
+        for (int x = 0; x < dim; ++x) {
+            for (int y = 0; y < dim; ++y) {
+                float r2 = (x - x0) * (x - x0) + 0.3 * (y - y0) * (y - y0);
+                int i = (n * dim + x) * dim + y;
+                raw[i] = std::lround(40.0 + 200.0 * std::exp(-r2 / 40.0));
+                pixels[i] = scale * raw[i] + offset;
+            }
+        }
+    }
+
+    const std::string floatFilename = tempFilename("mapping_float.bin");
+    const std::string uint8Filename = tempFilename("mapping_uint8.bin");
+    {
+        std::ofstream os(floatFilename, std::ios::binary);
+        writeImageFileHeader(os, ImageFileHeader(numberOfImages, 1, dim, dim));
+        os.write((char*)&pixels[0], pixels.size() * sizeof(float));
+    }
+    {
+        std::ofstream os(uint8Filename, std::ios::binary);
+        writeImageFileHeader(os, ImageFileHeader(numberOfImages, 1, dim, dim, PixelType::UINT8, scale, offset));
+        os.write((char*)&raw[0], raw.size());
+    }
+
+    // The neurons are as large as the images, the SOM is too large for the fused kernel
+    InputData inputData;
+    inputData.som_width = 10;
+    inputData.som_height = 10;
+    inputData.som_size = 100;
+    inputData.numberOfChannels = 1;
+    inputData.image_dim = dim;
+    inputData.image_size = dim * dim;
+    inputData.neuron_dim = dim;
+    inputData.neuron_size = dim * dim;
+    inputData.numberOfRotations = 8;
+    inputData.useFlip = true;
+    inputData.numberOfRotationsAndFlip = 16;
+    inputData.init = SOMInitialization::RANDOM;
+
+    std::vector<float> floatDistances, uint8Distances;
+    std::vector<int> floatRotations, uint8Rotations;
+    map(floatDistances, floatRotations, floatFilename, inputData);
+    map(uint8Distances, uint8Rotations, uint8Filename, inputData);
+    EXPECT_EQ(PixelType::UINT8, inputData.imagePixelType);
+
+    ASSERT_EQ(floatDistances.size(), uint8Distances.size());
+    for (size_t i = 0; i < floatDistances.size(); ++i) {
+        EXPECT_NEAR(floatDistances[i], uint8Distances[i], 1e-3 * floatDistances[i]) << "i = " << i;
+    }
+    EXPECT_EQ(floatRotations, uint8Rotations);
+
+    std::remove(floatFilename.c_str());
+    std::remove(uint8Filename.c_str());
+}
+
+TEST(MappingTest, ReducedStorage)
+{
+    const int dim = 32;
+    std::vector<float> pixels(dim * dim);
+    for (int i = 0; i < dim * dim; ++i) pixels[i] = std::sin(0.1 * i);
+
+    const std::string filename = tempFilename("mapping_storage.bin");
+    {
+        std::ofstream os(filename, std::ios::binary);
+        writeImageFileHeader(os, ImageFileHeader(1, 1, dim, dim));
+        os.write((char*)&pixels[0], pixels.size() * sizeof(float));
+    }
+
+    InputData inputData;
+    inputData.som_width = 4;
+    inputData.som_height = 4;
+    inputData.som_size = 16;
+    inputData.numberOfChannels = 1;
+    inputData.image_dim = dim;
+    inputData.image_size = dim * dim;
+    inputData.neuron_dim = 22;
+    inputData.neuron_size = 22 * 22;
+    inputData.numberOfRotations = 4;
+    inputData.useFlip = false;
+    inputData.numberOfRotationsAndFlip = 4;
+    inputData.init = SOMInitialization::RANDOM;
+    inputData.executionPath = ExecutionPath::MAP;
+
+    std::vector<float> floatDistances, compactDistances;
+    std::vector<int> floatRotations, compactRotations;
+    map(floatDistances, floatRotations, filename, inputData);
+
+    // The float32 SOM is released, the distances use the bfloat16 copy
+    inputData.storage = StorageType::BFLOAT16;
+    EXPECT_EQ(0, SOM(inputData).getSize());
+    map(compactDistances, compactRotations, filename, inputData);
+
+    ASSERT_EQ(floatDistances.size(), compactDistances.size());
+    for (size_t i = 0; i < floatDistances.size(); ++i) {
+        EXPECT_NEAR(floatDistances[i], compactDistances[i], 1e-2 * floatDistances[i]) << "i = " << i;
+    }
+
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,101 @@
+/**
+ * @file   SelfOrganizingMapTest/NeuronPrototypesTest.cpp
+ * @brief  Unit tests for the closest images of every neuron.
+ * @date   Oct 19, 2026
+ */
+
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include "gtest/gtest.h"
+#include <string>
+#include <vector>
+
+#include "SelfOrganizingMapLib/NeuronPrototypes.h"
+#include "TempFilename.h"
+
+using namespace pink;
+
+TEST(NeuronPrototypesTest, ClosestImages)
+{
+    NeuronPrototypes prototypes(2, 2);
+
+    std::vector<int> rotations = {1, 5};
+    std::vector<std::vector<float>> distances = {{3.0, 1.0}, {1.0, FLT_MAX}, {2.0, 4.0}, {0.5, 2.0}};
+    for (int i = 0; i != static_cast<int>(distances.size()); ++i) prototypes.add(i, &distances[i][0], &rotations[0]);
+
+    auto first = prototypes.getPrototypes(0);
+    ASSERT_EQ(2UL, first.size());
+    EXPECT_EQ(3, first[0].image);
+    EXPECT_EQ(1, first[1].image);
+    EXPECT_EQ(1, first[1].rotation);
+
+    // Skipped distance of image 1
+    auto second = prototypes.getPrototypes(1);
+    ASSERT_EQ(2UL, second.size());
+    EXPECT_EQ(0, second[0].image);
+    EXPECT_EQ(3, second[1].image);
+    EXPECT_EQ(5, second[1].rotation);
+
+    InputData inputData;
+    inputData.som_width = 2;
+    inputData.som_height = 1;
+    inputData.som_depth = 1;
+    inputData.numberOfRotations = 4;
+    const std::string filename = tempFilename("prototypes.bin");
+    prototypes.write(filename, inputData);
+
+    std::ifstream is(filename, std::ios::binary);
+    char magic[8];
+    int version;
+    int64_t numberOfImages;
+    int header[5];
+    is.read(magic, sizeof(magic));
+    is.read((char*)&version, sizeof(version));
+    is.read((char*)&numberOfImages, sizeof(numberOfImages));
+    is.read((char*)header, sizeof(header));
+    EXPECT_EQ(std::string("PINKPROT"), std::string(magic, magic + 8));
+    EXPECT_EQ(2, version);
+    EXPECT_EQ(4, numberOfImages);
+    EXPECT_EQ(2, header[3]);
+    EXPECT_EQ(2, header[4]);
+
+    // Second prototype of the second neuron
+    is.seekg(3 * (3 * sizeof(int) + sizeof(char) + sizeof(float)), std::ios::cur);
+    int neuron, image;
+    float distance, angle;
+    char flip;
+    is.read((char*)&neuron, sizeof(int));
+    is.read((char*)&image, sizeof(int));
+    is.read((char*)&distance, sizeof(float));
+    is.read(&flip, sizeof(char));
+    is.read((char*)&angle, sizeof(float));
+    EXPECT_EQ(1, neuron);
+    EXPECT_EQ(3, image);
+    EXPECT_EQ(2.0, distance);
+    EXPECT_EQ(1, flip);
+    EXPECT_FLOAT_EQ(0.5 * M_PI, angle);
+
+    std::remove(filename.c_str());
+}
+
+TEST(NeuronPrototypesTest, Cutouts)
+{
+    NeuronPrototypes prototypes(1, 2, 3);
+    auto cutout = [](float *dest, int rotation){ for (int i = 0; i != 3; ++i) dest[i] = 10 * rotation + i; };
+
+    std::vector<float> distances = {5.0, 2.0, 3.0, 1.0};
+    for (int i = 0; i != 4; ++i) prototypes.add(i, &distances[i], &i, cutout);
+
+    // The cutout of an image is kept as long as the image is a prototype
+    auto result = prototypes.getPrototypes(0);
+    ASSERT_EQ(2UL, result.size());
+    EXPECT_EQ(3, result[0].image);
+    EXPECT_EQ(1, result[1].image);
+    EXPECT_EQ(std::vector<float>({30, 31, 32}), std::vector<float>(prototypes.getCutout(0, result[0]),
+        prototypes.getCutout(0, result[0]) + 3));
+    EXPECT_EQ(std::vector<float>({10, 11, 12}), std::vector<float>(prototypes.getCutout(0, result[1]),
+        prototypes.getCutout(0, result[1]) + 3));
+}
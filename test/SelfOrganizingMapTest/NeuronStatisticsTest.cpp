@@ -0,0 +1,79 @@
+/**
+ * @file   SelfOrganizingMapTest/NeuronStatisticsTest.cpp
+ * @brief  Unit tests for per neuron statistics of mapping.
+ * @date   Oct 19, 2026
+ */
+
+#include <cfloat>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include "gtest/gtest.h"
+#include <string>
+#include <vector>
+
+#include "SelfOrganizingMapLib/NeuronStatistics.h"
+#include "TempFilename.h"
+
+using namespace pink;
+
+TEST(NeuronStatisticsTest, Aggregates)
+{
+    NeuronStatistics statistics(3, 2);
+    statistics.add(10, 0, 4.0);
+    statistics.add(11, 2, 1.0);
+    statistics.add(12, 0, 2.0);
+    statistics.add(13, 0, 3.0);
+
+    EXPECT_EQ(3, statistics.getCount(0));
+    EXPECT_EQ(0, statistics.getCount(1));
+    EXPECT_EQ(1, statistics.getCount(2));
+    EXPECT_DOUBLE_EQ(9.0, statistics.getSum(0));
+    EXPECT_DOUBLE_EQ(29.0, statistics.getSumOfSquares(0));
+
+    auto examples = statistics.getExamples(0);
+    ASSERT_EQ(2UL, examples.size());
+    EXPECT_EQ(12, examples[0].image);
+    EXPECT_EQ(13, examples[1].image);
+    EXPECT_TRUE(statistics.getExamples(1).empty());
+
+    InputData inputData;
+    inputData.som_width = 3;
+    inputData.som_height = 1;
+    inputData.som_depth = 1;
+    const std::string filename = tempFilename("neuron_stats.bin");
+    statistics.write(filename, inputData);
+
+    std::ifstream is(filename, std::ios::binary);
+    char magic[8];
+    int version;
+    int64_t numberOfImages;
+    int header[5];
+    is.read(magic, sizeof(magic));
+    is.read((char*)&version, sizeof(version));
+    is.read((char*)&numberOfImages, sizeof(numberOfImages));
+    is.read((char*)header, sizeof(header));
+    EXPECT_EQ(std::string("PINKSTAT"), std::string(magic, magic + 8));
+    EXPECT_EQ(2, version);
+    EXPECT_EQ(4, numberOfImages);
+    EXPECT_EQ(3, header[3]);
+    EXPECT_EQ(2, header[4]);
+
+    // Second neuron without images
+    is.seekg(3 * sizeof(int64_t) + 2 * (sizeof(int) + sizeof(float)), std::ios::cur);
+    int64_t count;
+    double sum;
+    is.read((char*)&count, sizeof(count));
+    is.read((char*)&sum, sizeof(sum));
+    is.seekg(sizeof(double), std::ios::cur);
+    int image;
+    float distance;
+    is.read((char*)&image, sizeof(image));
+    is.read((char*)&distance, sizeof(distance));
+    EXPECT_EQ(0, count);
+    EXPECT_EQ(0.0, sum);
+    EXPECT_EQ(-1, image);
+    EXPECT_EQ(FLT_MAX, distance);
+
+    std::remove(filename.c_str());
+}
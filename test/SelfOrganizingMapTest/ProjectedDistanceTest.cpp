@@ -0,0 +1,83 @@
+/**
+ * @file   SelfOrganizingMapTest/ProjectedDistanceTest.cpp
+ * @brief  Unit tests for principal component prefilter.
+ * @date   Oct 18, 2026
+ */
+
+#include <cmath>
+#include "gtest/gtest.h"
+#include <vector>
+
+#include "SelfOrganizingMapLib/ProjectedDistance.h"
+#include "UtilitiesLib/Filler.h"
+
+using namespace pink;
+
+TEST(ProjectedDistanceTest, LowRankData)
+{
+    int dim = 150;
+    int rank = 3;
+    int numberOfVectors = 40;
+
+    // Data within a three dimensional affine subspace
+    std::vector<float> offset(dim), directions(rank * dim), coefficients(numberOfVectors * rank);
+    fillWithRandomNumbers(&offset[0], dim, 1);
+    fillWithRandomNumbers(&directions[0], directions.size(), 2);
+    fillWithRandomNumbers(&coefficients[0], coefficients.size(), 3);
+
+    std::vector<float> data(numberOfVectors * dim);
+    for (int i = 0; i < numberOfVectors; ++i) {
+        for (int p = 0; p < dim; ++p) {
+            data[i * dim + p] = offset[p];
+            for (int r = 0; r < rank; ++r) data[i * dim + p] += 10 * coefficients[i * rank + r] * directions[r * dim + p];
+        }
+    }
+
+    std::vector<float> basis(dim * rank);
+    calculatePrincipalComponents(&basis[0], &data[0], numberOfVectors, dim, rank);
+
+    // Orthonormal basis
+    for (int a = 0; a < rank; ++a) {
+        for (int b = 0; b < rank; ++b) {
+            float dot = 0.0;
+            for (int p = 0; p < dim; ++p) dot += basis[p * rank + a] * basis[p * rank + b];
+            EXPECT_NEAR(a == b ? 1.0 : 0.0, dot, 1e-4);
+        }
+    }
+
+    // Distances are preserved in the subspace
+    std::vector<float> projections(numberOfVectors * rank), scores(numberOfVectors * numberOfVectors);
+    projectImages(&projections[0], &basis[0], &data[0], numberOfVectors, dim, rank);
+    generateProjectedScores(&scores[0], &projections[0], numberOfVectors, &projections[0], numberOfVectors, rank);
+
+    for (int i = 0; i < numberOfVectors; ++i) {
+        for (int j = 0; j < numberOfVectors; ++j) {
+            float exact = 0.0;
+            for (int p = 0; p < dim; ++p) exact += std::pow(data[i * dim + p] - data[j * dim + p], 2);
+            EXPECT_NEAR(exact, scores[i * numberOfVectors + j], 1e-3 * (1.0 + exact));
+        }
+    }
+}
+
+TEST(ProjectedDistanceTest, Projection)
+{
+    int dim = 37;
+    int numberOfImages = 7;
+
+    for (int numberOfComponents : {1, 8, 11, 16}) {
+        std::vector<float> basis(dim * numberOfComponents), images(numberOfImages * dim);
+        fillWithRandomNumbers(&basis[0], basis.size(), 1);
+        fillWithRandomNumbers(&images[0], images.size(), 2);
+
+        std::vector<float> projections(numberOfImages * numberOfComponents);
+        projectImages(&projections[0], &basis[0], &images[0], numberOfImages, dim, numberOfComponents);
+
+        for (int i = 0; i < numberOfImages; ++i) {
+            for (int c = 0; c < numberOfComponents; ++c) {
+                float expected = 0.0;
+                for (int p = 0; p < dim; ++p) expected += images[i * dim + p] * basis[p * numberOfComponents + c];
+                EXPECT_NEAR(expected, projections[i * numberOfComponents + c], 1e-5);
+            }
+        }
+    }
+}
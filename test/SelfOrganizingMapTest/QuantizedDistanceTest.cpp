@@ -0,0 +1,95 @@
+/**
+ * @file   SelfOrganizingMapTest/QuantizedDistanceTest.cpp
+ * @brief  Unit tests for int8 prefilter and exact rerank.
+ * @date   Oct 18, 2026
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "gtest/gtest.h"
+#include <random>
+#include <vector>
+
+#include "ImageProcessingLib/ImageProcessing.h"
+#include "SelfOrganizingMapLib/QuantizedDistance.h"
+#include "SelfOrganizingMapLib/SelfOrganizingMap.h"
+#include "UtilitiesLib/EqualFloatArrays.h"
+#include "UtilitiesLib/Filler.h"
+
+using namespace pink;
+
+TEST(QuantizedDistanceTest, DotProduct)
+{
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> uniform(-127, 127);
+
+    for (int length : {1, 31, 32, 100, 2025}) {
+        std::vector<int8_t> a(length), b(length);
+        for (int i = 0; i < length; ++i) {
+            a[i] = uniform(rng);
+            b[i] = uniform(rng);
+        }
+        // Extreme values must not saturate
+        a[0] = 127;
+        b[0] = -127;
+
+        int32_t expected = 0;
+        for (int i = 0; i < length; ++i) expected += a[i] * b[i];
+
+        EXPECT_EQ(expected, dotProductInt8Scalar(&a[0], &b[0], length));
+        EXPECT_EQ(expected, dotProductInt8(&a[0], &b[0], length));
+    }
+}
+
+TEST(QuantizedDistanceTest, PrefilterAndRerank)
+{
+    int image_size = 2 * 17 * 17;
+    int som_size = 7;
+    int numberOfRotationsAndFlip = 30;
+
+    std::vector<float> som(som_size * image_size), rotatedImages(numberOfRotationsAndFlip * image_size);
+    fillWithRandomNumbers(&som[0], som.size(), 1);
+    fillWithRandomNumbers(&rotatedImages[0], rotatedImages.size(), 2);
+
+    QuantizedImages quantizedSom, quantizedImages;
+    quantizedSom.quantize(&som[0], som_size, image_size);
+    quantizedImages.quantize(&rotatedImages[0], numberOfRotationsAndFlip, image_size);
+
+    std::vector<float> scores(som_size * numberOfRotationsAndFlip);
+    generateQuantizedScores(&scores[0], quantizedSom, quantizedImages);
+
+    // Scores approximate the exact distances
+    for (int i = 0; i < som_size; ++i) {
+        for (int j = 0; j < numberOfRotationsAndFlip; ++j) {
+            float exact = calculateEuclideanDistanceWithoutSquareRoot(&som[i * image_size],
+                &rotatedImages[j * image_size], image_size);
+            EXPECT_NEAR(exact, scores[i * numberOfRotationsAndFlip + j], 0.02 * exact);
+        }
+    }
+
+    std::vector<float> euclideanDistanceMatrix(som_size), euclideanDistanceMatrix2(som_size);
+    std::vector<int> bestRotationMatrix(som_size), bestRotationMatrix2(som_size);
+
+    generateEuclideanDistanceMatrix(&euclideanDistanceMatrix[0], &bestRotationMatrix[0],
+        som_size, &som[0], image_size, numberOfRotationsAndFlip, &rotatedImages[0]);
+
+    // All rotations as candidates is the exhaustive search
+    generateEuclideanDistanceMatrixFromCandidates(&euclideanDistanceMatrix2[0], &bestRotationMatrix2[0],
+        som_size, &som[0], image_size, numberOfRotationsAndFlip, &rotatedImages[0], &scores[0],
+        numberOfRotationsAndFlip);
+
+    EXPECT_TRUE(EqualFloatArrays(&euclideanDistanceMatrix[0], &euclideanDistanceMatrix2[0], som_size, 1e-5));
+    EXPECT_EQ(bestRotationMatrix, bestRotationMatrix2);
+
+    // A single candidate gives the exact distance of the best scored rotation
+    generateEuclideanDistanceMatrixFromCandidates(&euclideanDistanceMatrix2[0], &bestRotationMatrix2[0],
+        som_size, &som[0], image_size, numberOfRotationsAndFlip, &rotatedImages[0], &scores[0], 1);
+
+    for (int i = 0; i < som_size; ++i) {
+        float const *pscores = &scores[i * numberOfRotationsAndFlip];
+        int best = std::min_element(pscores, pscores + numberOfRotationsAndFlip) - pscores;
+        EXPECT_EQ(best, bestRotationMatrix2[i]);
+        EXPECT_EQ(calculateEuclideanDistanceWithoutSquareRoot(&som[i * image_size],
+            &rotatedImages[best * image_size], image_size), euclideanDistanceMatrix2[i]);
+    }
+}
@@ -0,0 +1,21 @@
+/**
+ * @file   TempFilename.h
+ * @brief  Temporary files of the unit tests.
+ * @date   Oct 19, 2026
+ */
+
+#pragma once
+
+#include "gtest/gtest.h"
+#include <string>
+#include <unistd.h>
+
+namespace pink {
+
+//! Path in the temporary directory, unique for the test process. The test removes the file.
+inline std::string tempFilename(std::string const& name)
+{
+    return ::testing::TempDir() + "pink_" + std::to_string(getpid()) + "_" + name;
+}
+
+} // namespace pink
@@ -0,0 +1,62 @@
+/**
+ * @file   UtilitiesTest/AsyncFileWriterTest.cpp
+ * @date   Oct 19, 2026
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+
+#include "UtilitiesLib/AsyncFileWriter.h"
+#include "TempFilename.h"
+
+using namespace pink;
+
+namespace {
+
+std::vector<char> readFile(std::string const& filename)
+{
+    std::ifstream is(filename, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+}
+
+} // anonymous namespace
+
+TEST(AsyncFileWriterTest, Order)
+{
+    const std::string filename = tempFilename("async.bin");
+
+    for (bool directIO : {false, true}) {
+        std::vector<char> expected;
+        {
+            // Small buffers, the records cross buffer borders
+            AsyncFileWriter writer(filename, 1, 2, directIO);
+            for (int i = 0; i < 500; ++i) {
+                std::vector<char> record(1 + (i * 37) % 101, static_cast<char>(i));
+                writer.write(&record[0], record.size());
+                expected.insert(expected.end(), record.begin(), record.end());
+
+                // Checkpoint with partial buffer
+                if (i % 97 == 0) {
+                    writer.flush();
+                    EXPECT_EQ(expected, readFile(filename));
+                }
+            }
+            EXPECT_EQ(static_cast<int64_t>(expected.size()), writer.getSize());
+            EXPECT_LE(0.0, writer.getStallTime());
+        }
+        EXPECT_EQ(expected, readFile(filename));
+    }
+
+    std::remove(filename.c_str());
+}
+
+TEST(AsyncFileWriterTest, Errors)
+{
+    EXPECT_THROW(AsyncFileWriter(tempFilename("missing/async.bin")), std::runtime_error);
+    EXPECT_THROW(AsyncFileWriter(tempFilename("async.bin"), 4096, 1), std::runtime_error);
+}
@@ -0,0 +1,54 @@
+/**
+ * @file   UtilitiesTest/BoundedHeapTest.cpp
+ * @date   Oct 19, 2026
+ */
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include "gtest/gtest.h"
+
+#include "UtilitiesLib/BoundedHeap.h"
+
+using namespace pink;
+
+TEST(BoundedHeapTest, SmallestValues)
+{
+    std::vector<int> values;
+    for (int i = 0; i < 100; ++i) values.push_back((i * 37) % 101);
+
+    BoundedHeap<int> heap(5);
+    for (int v : values) heap.push(v);
+
+    std::sort(values.begin(), values.end());
+    EXPECT_TRUE(heap.full());
+    EXPECT_EQ(std::vector<int>(values.begin(), values.begin() + 5), heap.sorted());
+    EXPECT_EQ(values[4], heap.top());
+
+    // Only smaller values are inserted
+    EXPECT_FALSE(heap.push(values[4]));
+    EXPECT_TRUE(heap.push(-1));
+    EXPECT_EQ(-1, heap.sorted().front());
+
+    // Largest values with std::greater
+    BoundedHeap<int, std::greater<int>> largest(3);
+    for (int v : values) largest.push(v);
+    EXPECT_EQ(std::vector<int>({values[99], values[98], values[97]}), largest.sorted());
+}
+
+TEST(BoundedHeapTest, Merge)
+{
+    BoundedHeap<int> a(4), b(4), all(4);
+    for (int i = 0; i < 50; ++i) {
+        int v = (i * 29) % 53;
+        (i % 2 ? a : b).push(v);
+        all.push(v);
+    }
+    a.merge(b);
+    EXPECT_EQ(all.sorted(), a.sorted());
+
+    BoundedHeap<int> empty(0);
+    EXPECT_FALSE(empty.push(1));
+    EXPECT_TRUE(empty.empty());
+    EXPECT_TRUE(empty.full());
+}
@@ -0,0 +1,60 @@
+/**
+ * @file   UtilitiesTest/HalfPrecisionTest.cpp
+ * @date   Oct 18, 2026
+ */
+
+#include <cmath>
+#include <limits>
+#include "gtest/gtest.h"
+
+#include "UtilitiesLib/HalfPrecision.h"
+
+using namespace pink;
+
+TEST(HalfPrecisionTest, BFloat16)
+{
+    EXPECT_EQ(1.0f, float(bfloat16(1.0f)));
+    EXPECT_EQ(-2.5f, float(bfloat16(-2.5f)));
+    EXPECT_EQ(0.0f, float(bfloat16(0.0f)));
+
+    // Round to nearest even: 1 + 2^-8 is exactly between 1 and 1 + 2^-7
+    EXPECT_EQ(1.0f, float(bfloat16(1.0f + std::ldexp(1.0f, -8))));
+    EXPECT_EQ(1.0f + std::ldexp(1.0f, -7), float(bfloat16(1.0f + std::ldexp(1.0f, -8) + std::ldexp(1.0f, -16))));
+
+    EXPECT_TRUE(std::isinf(float(bfloat16(std::numeric_limits<float>::infinity()))));
+    EXPECT_TRUE(std::isnan(float(bfloat16(std::numeric_limits<float>::quiet_NaN()))));
+
+    for (float f : {0.1f, 3.14159f, -1234.5f, 1e-20f}) EXPECT_NEAR(f, float(bfloat16(f)), std::fabs(f) / 256);
+}
+
+TEST(HalfPrecisionTest, Float16)
+{
+    EXPECT_EQ(1.0f, float(float16(1.0f)));
+    EXPECT_EQ(-2.5f, float(float16(-2.5f)));
+    EXPECT_EQ(65504.0f, float(float16(65504.0f)));
+    EXPECT_EQ(0x3c00, float16(1.0f).bits);
+    EXPECT_EQ(0xc000, float16(-2.0f).bits);
+
+    // Round to nearest even: 1 + 2^-11 is exactly between 1 and 1 + 2^-10
+    EXPECT_EQ(1.0f, float(float16(1.0f + std::ldexp(1.0f, -11))));
+    EXPECT_EQ(1.0f + std::ldexp(1.0f, -9), float(float16(1.0f + 3 * std::ldexp(1.0f, -11))));
+
+    // Smallest subnormal and rounding into the normal range
+    EXPECT_EQ(std::ldexp(1.0f, -24), float(float16(std::ldexp(1.0f, -24))));
+    EXPECT_EQ(0x0001, float16(std::ldexp(1.0f, -24)).bits);
+    EXPECT_EQ(0x0400, float16(std::ldexp(1.0f, -14) - std::ldexp(1.0f, -26)).bits);
+    EXPECT_EQ(0.0f, float(float16(std::ldexp(1.0f, -26))));
+
+    // Overflow
+    EXPECT_TRUE(std::isinf(float(float16(65520.0f))));
+    EXPECT_EQ(65504.0f, float(float16(65519.0f)));
+    EXPECT_TRUE(std::isnan(float(float16(std::numeric_limits<float>::quiet_NaN()))));
+
+    // All finite half values survive a round trip
+    for (int bits = 0; bits < 0x10000; ++bits) {
+        if ((bits & 0x7c00) == 0x7c00) continue;
+        float16 h;
+        h.bits = bits;
+        EXPECT_EQ(bits, float16(float(h)).bits);
+    }
+}
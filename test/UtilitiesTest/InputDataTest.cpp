@@ -0,0 +1,72 @@
+/**
+ * @file   UtilitiesTest/InputDataTest.cpp
+ * @brief  Unit tests for the parameters of additional SOMs of mapping.
+ * @date   Oct 19, 2026
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+
+#include "UtilitiesLib/InputData.h"
+#include "TempFilename.h"
+
+using namespace pink;
+
+namespace {
+
+void writeSOM(std::string const& filename, int width, int height, int depth, int numberOfNeurons,
+    std::string const& header = "", int valueSize = 4)
+{
+    std::ofstream os(filename, std::ios::binary);
+    os << header;
+    int dimensions[6] = {1, width, height, depth, 2, 2};
+    os.write((char*)dimensions, sizeof(dimensions));
+    std::vector<char> data(numberOfNeurons * 4 * valueSize, 0);
+    os.write(&data[0], data.size());
+}
+
+} // anonymous namespace
+
+TEST(InputDataTest, AdditionalSOM)
+{
+    const std::string cartesianFilename = tempFilename("additional_cartesian.bin");
+    const std::string hexagonalFilename = tempFilename("additional_hexagonal.bin");
+    const std::string compactFilename = tempFilename("additional_compact.bin");
+    writeSOM(cartesianFilename, 3, 2, 1, 6);
+    writeSOM(hexagonalFilename, 5, 5, 1, 19);
+    writeSOM(compactFilename, 4, 4, 2, 32, "# comment\n# storage: bfloat16\n", 2);
+
+    InputData inputData;
+    inputData.numberOfChannels = 1;
+    inputData.neuron_dim = 2;
+    inputData.neuron_size = 4;
+    inputData.write_rot_flip = true;
+    inputData.prototypesFilename = "prototypes.bin";
+    inputData.additionalResultFilenames = {"r1.bin", "r2.bin", "r3.bin"};
+    inputData.additionalSOMFilenames = {cartesianFilename, hexagonalFilename, compactFilename};
+
+    InputData cartesian = inputData.getAdditionalSOMInputData(0);
+    EXPECT_EQ("r1.bin", cartesian.resultFilename);
+    EXPECT_EQ(cartesianFilename, cartesian.somFilename);
+    EXPECT_EQ(Layout::CARTESIAN, cartesian.layout);
+    EXPECT_EQ(6, cartesian.som_size);
+    EXPECT_EQ(2, cartesian.dimensionality);
+    EXPECT_FALSE(cartesian.write_rot_flip);
+    EXPECT_TRUE(cartesian.prototypesFilename.empty());
+
+    InputData hexagonal = inputData.getAdditionalSOMInputData(1);
+    EXPECT_EQ(Layout::HEXAGONAL, hexagonal.layout);
+    EXPECT_EQ(19, hexagonal.som_size);
+
+    InputData compact = inputData.getAdditionalSOMInputData(2);
+    EXPECT_EQ(Layout::CARTESIAN, compact.layout);
+    EXPECT_EQ(32, compact.som_size);
+    EXPECT_EQ(3, compact.dimensionality);
+
+    std::remove(cartesianFilename.c_str());
+    std::remove(hexagonalFilename.c_str());
+    std::remove(compactFilename.c_str());
+}
@@ -0,0 +1,147 @@
+/**
+ * @file   UtilitiesTest/MergeResultFilesTest.cpp
+ * @date   Oct 19, 2026
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+
+#include "UtilitiesLib/MergeResultFiles.h"
+#include "UtilitiesLib/ResultFileHeader.h"
+#include "TempFilename.h"
+
+using namespace pink;
+
+namespace {
+
+//! Write result file with rows of rowSize bytes, the bytes are numbered starting at first.
+void writeResultFile(std::string const& filename, int numberOfImages, int rowSize, int first, int som_width = 3)
+{
+    std::ofstream os(filename, std::ios::binary);
+    int header[4] = {numberOfImages, som_width, 2, 1};
+    os.write((char*)header, sizeof(header));
+    for (int i = 0; i < numberOfImages * rowSize; ++i) os.put(static_cast<char>(first + i));
+}
+
+std::vector<char> readFile(std::string const& filename)
+{
+    std::ifstream is(filename, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+}
+
+//! The result files are written to unique temporary paths and removed after each test.
+class MergeResultFilesTest : public ::testing::Test
+{
+protected:
+
+    MergeResultFilesTest()
+     : part0_(tempFilename("part0.bin")),
+       part1_(tempFilename("part1.bin")),
+       part2_(tempFilename("part2.bin")),
+       whole_(tempFilename("whole.bin")),
+       merged_(tempFilename("merged.bin"))
+    {}
+
+    void TearDown()
+    {
+        for (auto const& filename : {part0_, part1_, part2_, whole_, merged_}) std::remove(filename.c_str());
+    }
+
+    const std::string part0_, part1_, part2_, whole_, merged_;
+};
+
+} // anonymous namespace
+
+TEST_F(MergeResultFilesTest, Concatenate)
+{
+    // Rows of rot/flip files: one char and one float per neuron
+    const int rowSize = 6 * 5;
+    writeResultFile(part0_, 3, rowSize, 0);
+    writeResultFile(part1_, 1, rowSize, 3 * rowSize);
+    writeResultFile(part2_, 2, rowSize, 4 * rowSize);
+    writeResultFile(whole_, 6, rowSize, 0);
+
+    EXPECT_EQ(6, mergeResultFiles(merged_, {part0_, part1_, part2_}));
+    EXPECT_EQ(readFile(whole_), readFile(merged_));
+}
+
+TEST_F(MergeResultFilesTest, TopK)
+{
+    // Versioned header of top-k results with three best matches
+    for (int i = 0; i < 2; ++i) {
+        std::ofstream os(i ? part1_ : part0_, std::ios::binary);
+        writeResultFileHeader(os, ResultFileHeader(2 + i, 3, 2, 1, ResultType::TOP_K, 3));
+        for (size_t j = 0; j < (2 + i) * 3 * bestMatchEntrySize; ++j) os.put(static_cast<char>(j + i));
+    }
+
+    EXPECT_EQ(5, mergeResultFiles(merged_, {part0_, part1_}));
+
+    std::ifstream is(merged_, std::ios::binary);
+    ResultFileHeader header = readResultFileHeader(is);
+    EXPECT_EQ(5, header.numberOfImages);
+    EXPECT_EQ(ResultType::TOP_K, header.type);
+    EXPECT_EQ(3, header.numberOfBestMatches);
+    EXPECT_EQ(10 * sizeof(int), header.getHeaderSizeInBytes());
+    EXPECT_EQ(header.getHeaderSizeInBytes() + 5 * header.getRowSizeInBytes(6), readFile(merged_).size());
+
+    // Plain and versioned files can not be merged
+    writeResultFile(part1_, 1, 3 * bestMatchEntrySize, 0);
+    EXPECT_THROW(mergeResultFiles(merged_, {part0_, part1_}), std::runtime_error);
+}
+
+TEST_F(MergeResultFilesTest, Compressed)
+{
+    // The blocks are copied without decompression, the content is arbitrary
+    auto writeBlocks = [](std::string const& filename, std::vector<int64_t> const& rowsPerBlock) {
+        std::ofstream os(filename, std::ios::binary);
+        int64_t numberOfImages = 0;
+        for (auto rows : rowsPerBlock) numberOfImages += rows;
+        writeResultFileHeader(os, ResultFileHeader(numberOfImages, 3, 2, 1, ResultType::DISTANCES, 0,
+            ResultEncoding::FLOAT16, ImageCodec::ZLIB));
+        for (auto rows : rowsPerBlock) {
+            int64_t blockHeader[2] = {rows, 5 * rows};
+            os.write((char*)blockHeader, sizeof(blockHeader));
+            for (int i = 0; i < 5 * rows; ++i) os.put(static_cast<char>(i + rows));
+        }
+    };
+    writeBlocks(part0_, {4, 2});
+    writeBlocks(part1_, {3});
+    writeBlocks(whole_, {4, 2, 3});
+
+    EXPECT_EQ(9, mergeResultFiles(merged_, {part0_, part1_}));
+    EXPECT_EQ(readFile(whole_), readFile(merged_));
+
+    // Truncated block
+    std::vector<char> truncated = readFile(part1_);
+    std::ofstream(part1_, std::ios::binary).write(&truncated[0], truncated.size() - 1);
+    EXPECT_THROW(mergeResultFiles(merged_, {part0_, part1_}), std::runtime_error);
+
+    // Uncompressed and compressed files can not be merged
+    writeResultFile(part1_, 1, 12, 0);
+    EXPECT_THROW(mergeResultFiles(merged_, {part0_, part1_}), std::runtime_error);
+}
+
+TEST_F(MergeResultFilesTest, Validation)
+{
+    writeResultFile(part0_, 3, 24, 0);
+    writeResultFile(part1_, 2, 28, 0);
+    EXPECT_THROW(mergeResultFiles(merged_, {part0_, part1_}), std::runtime_error);
+
+    writeResultFile(part1_, 2, 24, 0, 4);
+    EXPECT_THROW(mergeResultFiles(merged_, {part0_, part1_}), std::runtime_error);
+
+    // Truncated file
+    writeResultFile(part1_, 2, 24, 0);
+    std::ofstream(part1_, std::ios::binary | std::ios::app).put(0);
+    EXPECT_THROW(mergeResultFiles(merged_, {part0_, part1_}), std::runtime_error);
+
+    EXPECT_THROW(mergeResultFiles(part0_, {part0_}), std::runtime_error);
+    EXPECT_EQ(3, readFile(part0_)[0]);
+
+    EXPECT_THROW(mergeResultFiles(merged_, {tempFilename("missing.bin")}), std::runtime_error);
+}
@@ -0,0 +1,82 @@
+/**
+ * @file   UtilitiesTest/ResultFileHeaderTest.cpp
+ * @date   Oct 19, 2026
+ */
+
+#include <cfloat>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include "gtest/gtest.h"
+
+#include "UtilitiesLib/ResultFileHeader.h"
+
+using namespace pink;
+
+TEST(ResultFileHeaderTest, Header)
+{
+    std::stringstream plain;
+    writeResultFileHeader(plain, ResultFileHeader(7, 3, 2, 1));
+    EXPECT_EQ(4 * sizeof(int), plain.str().size());
+
+    std::stringstream ss;
+    writeResultFileHeader(ss, ResultFileHeader(7, 3, 2, 1, ResultType::DISTANCES, 0,
+        ResultEncoding::UINT16, ImageCodec::ZLIB));
+    ResultFileHeader header = readResultFileHeader(ss);
+    EXPECT_EQ(7, header.numberOfImages);
+    EXPECT_EQ(3, header.som_width);
+    EXPECT_EQ(ResultEncoding::UINT16, header.encoding);
+    EXPECT_EQ(ImageCodec::ZLIB, header.codec);
+    EXPECT_EQ(10 * sizeof(int), header.getHeaderSizeInBytes());
+    EXPECT_EQ(2 * sizeof(float) + 6 * sizeof(uint16_t), header.getRowSizeInBytes(6));
+    EXPECT_EQ(6, header.getNumberOfNeurons(header.getRowSizeInBytes(6)));
+
+    // Unknown encoding
+    std::string bytes = ss.str();
+    bytes[4 * sizeof(int)] = 9;
+    std::istringstream corrupt(bytes);
+    EXPECT_THROW(readResultFileHeader(corrupt), std::runtime_error);
+}
+
+TEST(ResultFileHeaderTest, Encoding)
+{
+    const std::vector<float> distances = {12.5f, 3.0f, 1000.25f, 3.0f, FLT_MAX, 517.0f};
+    const int som_size = distances.size();
+    std::vector<float> decoded(som_size);
+
+    for (auto encoding : {ResultEncoding::FLOAT32, ResultEncoding::FLOAT16, ResultEncoding::UINT16}) {
+        ResultFileHeader header(1, 3, 2, 1, ResultType::DISTANCES, 0, encoding);
+        std::vector<char> row(header.getRowSizeInBytes(som_size));
+        encodeDistances(&row[0], &distances[0], som_size, encoding);
+        decodeDistances(&decoded[0], &row[0], som_size, encoding);
+
+        for (int i = 0; i < som_size; ++i) {
+            if (distances[i] == FLT_MAX) {
+                if (encoding == ResultEncoding::FLOAT16) EXPECT_TRUE(std::isinf(decoded[i]));
+                else EXPECT_EQ(FLT_MAX, decoded[i]);
+            } else if (encoding == ResultEncoding::FLOAT32) {
+                EXPECT_EQ(distances[i], decoded[i]);
+            } else if (encoding == ResultEncoding::FLOAT16) {
+                EXPECT_NEAR(distances[i], decoded[i], distances[i] / 1024);
+            } else {
+                // Half a quantization step of the range 3 to 1000.25
+                EXPECT_NEAR(distances[i], decoded[i], 997.25 / 65534 / 2 * 1.01);
+            }
+        }
+        EXPECT_EQ(decoded[1], decoded[3]);
+    }
+
+    // Minimum and maximum are exact for uint16
+    std::vector<char> row(2 * sizeof(float) + som_size * sizeof(uint16_t));
+    encodeDistances(&row[0], &distances[0], som_size, ResultEncoding::UINT16);
+    decodeDistances(&decoded[0], &row[0], som_size, ResultEncoding::UINT16);
+    EXPECT_EQ(3.0f, decoded[1]);
+    EXPECT_FLOAT_EQ(1000.25f, decoded[2]);
+
+    // Constant row
+    const std::vector<float> constant(som_size, 42.0f);
+    encodeDistances(&row[0], &constant[0], som_size, ResultEncoding::UINT16);
+    decodeDistances(&decoded[0], &row[0], som_size, ResultEncoding::UINT16);
+    for (float d : decoded) EXPECT_EQ(42.0f, d);
+}